@@ -0,0 +1,141 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include <exception>
+
+using namespace std;
+
+// Common part of the background loads, so owners can cancel them without knowing the item type
+class AsyncSeriesLoadBase {
+public:
+    // The worker holds its load while running, so the last owner goes away on the
+    // worker thread or after the worker has returned
+    virtual ~AsyncSeriesLoadBase() {
+        if (!worker.joinable()) return;
+        if (worker.get_id() == this_thread::get_id()) worker.detach(); // it is just ending
+        else worker.join();
+    }
+
+    // Safe to call from any thread, the loader should check isCancelled() and stop early,
+    // already staged data is dropped and the consumer is not called anymore
+    void cancel() { cancelled = true; }
+    bool isCancelled() const { return cancelled; }
+    bool isDone() const { return done; }
+
+    // Blocks until the loader returned (do not call on the UI thread while the loader waits for it)
+    void wait() {
+        unique_lock<mutex> lock(mtx);
+        doneCondition.wait(lock, [this]() { return settled; });
+    }
+
+    // Blocks until the worker thread has ended (cancel() first to stop the loader early),
+    // owners join it before they go away so no worker outlives them
+    void join() {
+        if (worker.joinable() && worker.get_id() != this_thread::get_id()) worker.join();
+    }
+
+    // Message of the exception the loader threw (empty if none)
+    string getError() const {
+        lock_guard<mutex> lock(mtx);
+        return error;
+    }
+
+protected:
+    atomic<bool> cancelled{false};
+    atomic<bool> done{false};
+    mutable mutex mtx;
+    condition_variable doneCondition;
+    bool settled = false;
+    string error;
+    thread worker;
+};
+
+// Loads a series on a worker thread and hands the data over to the UI thread in chunks.
+// The loader runs on the worker and calls append() whenever it has a chunk ready,
+// the consumer runs on the UI thread (via the poster) with everything staged since
+// its last call, so partial data can be shown while the rest is still loading.
+// Flushes are coalesced: at most one is posted at a time.
+template<typename T>
+class AsyncSeriesLoad: public AsyncSeriesLoadBase, public enable_shared_from_this<AsyncSeriesLoad<T>> {
+public:
+    typedef function<void(AsyncSeriesLoad<T>& load)> Loader;
+    typedef function<void(vector<T>& items, bool finished)> Consumer;
+    typedef function<void(function<void()>)> Poster;
+
+    AsyncSeriesLoad(Consumer consumer, Poster poster):
+        consumer(consumer),
+        poster(poster)
+    {}
+
+    virtual ~AsyncSeriesLoad() {}
+
+    static shared_ptr<AsyncSeriesLoad<T>> start(Loader loader, Consumer consumer, Poster poster) {
+        shared_ptr<AsyncSeriesLoad<T>> load = make_shared<AsyncSeriesLoad<T>>(consumer, poster);
+        load->worker = thread([load, loader]() {
+            try {
+                if (!load->isCancelled()) loader(*load);
+            } catch (exception& e) {
+                lock_guard<mutex> lock(load->mtx);
+                load->error = e.what();
+            }
+            load->finish();
+        });
+        return load;
+    }
+
+    // Worker thread: stage a chunk for the UI thread
+    void append(const vector<T>& items) {
+        if (cancelled || items.empty()) return;
+        {
+            lock_guard<mutex> lock(mtx);
+            staged.insert(staged.end(), items.begin(), items.end());
+        }
+        schedule();
+    }
+
+    // UI thread: pass the staged data to the consumer (called by the posted task)
+    void flush() {
+        vector<T> items;
+        bool finished;
+        {
+            lock_guard<mutex> lock(mtx);
+            items.swap(staged);
+            finished = done;
+            flushPending = false;
+        }
+        if (cancelled) return;
+        if (!items.empty() || finished) consumer(items, finished);
+    }
+
+protected:
+    void finish() {
+        {
+            lock_guard<mutex> lock(mtx);
+            done = true;
+        }
+        schedule();
+        {
+            lock_guard<mutex> lock(mtx);
+            settled = true; // the final flush is posted by the time wait() returns
+        }
+        doneCondition.notify_all();
+    }
+
+    void schedule() {
+        if (flushPending.exchange(true)) return;
+        shared_ptr<AsyncSeriesLoad<T>> self = this->shared_from_this();
+        poster([self]() { self->flush(); });
+    }
+
+    Consumer consumer;
+    Poster poster;
+    vector<T> staged;
+    atomic<bool> flushPending{false};
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "../trading/CandleSeries.hpp"
+#include <vector>
+#include <deque>
+#include <limits>
+#include <cmath>
+
+using namespace std;
+
+// Builds candles incrementally from a (time, price, volume) tick stream
+// directly into the candles of a CandleSeries.
+// Each tick touches only the last candle (O(1)), a tick beyond the current
+// candle's interval rolls over into a new candle.
+// The range of changed candle indices is tracked, so the caller can repaint
+// only the tail (see Chart::showCandlesRange) and then clearChanges().
+class CandleAggregator {
+public:
+    CandleAggregator(CandleSeries& candleSeries):
+        candleSeries(candleSeries),
+        interval(candleSeries.getInterval())
+    {
+        if (interval <= 0)
+            throw ERROR("CandleAggregator needs a positive interval");
+        clearChanges();
+    }
+
+    virtual ~CandleAggregator() {}
+
+    CandleSeries& getCandleSeries() { return candleSeries; }
+    time_sec getInterval() const { return interval; }
+
+    // Open time of the candle that contains the given time
+    time_sec getCandleTime(time_sec time) const {
+        time_sec candleTime = time - time % interval;
+        if (candleTime > time) candleTime -= interval; // floor for negative times
+        return candleTime;
+    }
+
+    // Returns false if the tick was ignored (NaN price or late tick of an already closed candle)
+    bool addTick(time_sec time, float price, float volume = 0) {
+        if (isnan(price)) return false;
+
+        vector<Candle>& candles = candleSeries.getCandlesRef();
+        const time_sec candleTime = getCandleTime(time);
+
+        // Roll over to a new candle
+        if (candles.empty() || candleTime > candles.back().getTime()) {
+            candles.push_back(Candle(candleTime, price, price, price, price, volume));
+            markChanged(candles.size() - 1);
+            return true;
+        }
+
+        // Late tick, the candle it belongs to is already closed
+        Candle& last = candles.back();
+        if (candleTime < last.getTime()) return false;
+
+        // Update the current candle in place
+        const float high = last.getHigh() > price ? last.getHigh() : price;
+        const float low = last.getLow() < price ? last.getLow() : price;
+        last = Candle(last.getTime(), last.getOpen(), high, low, price, last.getVolume() + volume);
+        markChanged(candles.size() - 1);
+        return true;
+    }
+
+    // Changed candle indices since the last clearChanges(): [changedFrom, changedTo)
+    bool hasChanges() const { return changedFrom < changedTo; }
+    size_t getChangedFrom() const { return changedFrom; }
+    size_t getChangedTo() const { return changedTo; }
+
+    void clearChanges() {
+        changedFrom = numeric_limits<size_t>::max();
+        changedTo = 0;
+    }
+
+protected:
+    void markChanged(size_t index) {
+        if (index < changedFrom) changedFrom = index;
+        if (index + 1 > changedTo) changedTo = index + 1;
+    }
+
+    CandleSeries& candleSeries;
+    time_sec interval;
+    size_t changedFrom;
+    size_t changedTo;
+};
+
+// Feeds one tick stream into several candle series (e.g. 1m, 5m and 1h at once)
+class MultiCandleAggregator {
+public:
+    MultiCandleAggregator() {}
+    virtual ~MultiCandleAggregator() {}
+
+    // The series must outlive the aggregator. The returned aggregator stays valid
+    // while this one lives (the aggregators are kept in a deque, never moved).
+    CandleAggregator& addCandleSeries(CandleSeries& candleSeries) {
+        aggregators.push_back(CandleAggregator(candleSeries));
+        return aggregators.back();
+    }
+
+    // Returns the number of series that accepted the tick
+    size_t addTick(time_sec time, float price, float volume = 0) {
+        size_t accepted = 0;
+        for (CandleAggregator& aggregator: aggregators)
+            if (aggregator.addTick(time, price, volume)) accepted++;
+        return accepted;
+    }
+
+    size_t size() const { return aggregators.size(); }
+    CandleAggregator& getAggregator(size_t n) { return aggregators.at(n); }
+
+    bool hasChanges() const {
+        for (const CandleAggregator& aggregator: aggregators)
+            if (aggregator.hasChanges()) return true;
+        return false;
+    }
+
+    void clearChanges() {
+        for (CandleAggregator& aggregator: aggregators)
+            aggregator.clearChanges();
+    }
+
+protected:
+    deque<CandleAggregator> aggregators;
+};
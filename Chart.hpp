@@ -3,7 +3,13 @@
 #include "../misc/EGA_COLORS.hpp"
 #include "../misc/Canvas.hpp"
 #include "TimePoint.hpp"
+#include "SeriesBlockSummary.hpp"
+#include "TradingTimeAxis.hpp"
+#include "ChartStats.hpp"
+#include "DecimationCache.hpp"
 #include <cmath>
+#include <algorithm>
+#include <memory>
 #include "../trading/Candle.hpp"
 
 using namespace std;
@@ -17,6 +23,17 @@ const int CHART_SPACING_BOTTOM = 30;
 const int CHART_SPACING_LEFT = 100;
 const int CHART_SPACING_RIGHT = 100;
 
+// Data bounds and view of a chart (see Chart::getBounds)
+struct ChartBounds {
+    time_sec valueFirst;
+    time_sec valueLast;
+    float valueLower;
+    float valueUpper;
+    bool viewInitialized;
+    time_sec viewFirst;
+    time_sec viewLast;
+};
+
 class Chart {
 public:
     Chart(
@@ -45,6 +62,11 @@ public:
     int getCanvasWidth() const { return canvas.width(); }
     int getCanvasHeight() const { return canvas.height(); }
 
+    int getSpacingTop() const { return spacingTop; }
+    int getSpacingBottom() const { return spacingBottom; }
+    int getSpacingLeft() const { return spacingLeft; }
+    int getSpacingRight() const { return spacingRight; }
+
     void resetBounds() {
         valueFirst = numeric_limits<time_sec>::max();
         valueLast = numeric_limits<time_sec>::min();
@@ -68,8 +90,11 @@ public:
         }
     }
     
-    void fitToPoints(const vector<TimePoint>& points) {
-        for (const TimePoint& point: points) {
+    // Points can be any time sorted random access view giving TimePoints (see PointView)
+    template<typename Points = vector<TimePoint>>
+    void fitToPoints(const Points& points) {
+        for (size_t n = 0; n < points.size(); n++) {
+            const TimePoint& point = points[n];
             const time_sec pointTime = point.getTime();
             const float pointValue = point.getValue();
             if (isnan(pointValue)) continue;
@@ -80,6 +105,12 @@ public:
         }
     }
     
+    // Fit the time range only (e.g. to a series that is not resident in memory)
+    void fitToTimeRange(time_sec first, time_sec last) {
+        valueFirst = valueFirst < first ? valueFirst : first;
+        valueLast = valueLast > last ? valueLast : last;
+    }
+    
     // Reset view to full data range (only if not already initialized)
     void resetView() {
         if (viewInitialized) return;
@@ -87,6 +118,28 @@ public:
         viewLast = valueLast;
         viewInitialized = true;
     }
+
+    // Bounds and view as fitted to a pane (see Fl_ChartBox::prepare)
+    ChartBounds getBounds() const {
+        return { valueFirst, valueLast, valueLower, valueUpper, viewInitialized, viewFirst, viewLast };
+    }
+
+    void setBounds(const ChartBounds& bounds) {
+        valueFirst = bounds.valueFirst;
+        valueLast = bounds.valueLast;
+        valueLower = bounds.valueLower;
+        valueUpper = bounds.valueUpper;
+        viewInitialized = bounds.viewInitialized;
+        viewFirst = bounds.viewFirst;
+        viewLast = bounds.viewLast;
+    }
+
+    // Forget the view, the next resetView() shows the full data range again
+    void clearView() {
+        viewFirst = 0;
+        viewLast = 0;
+        viewInitialized = false;
+    }
     
     // Getters for zoom factors
     double getZoomInFactor() const { return zoomInFactor; }
@@ -106,6 +159,22 @@ public:
     time_sec getValueLast() const { return valueLast; }
     void setValueFirst(time_sec v) { valueFirst = v; }
     void setValueLast(time_sec v) { valueLast = v; }
+    float getValueLower() const { return valueLower; }
+    float getValueUpper() const { return valueUpper; }
+
+    // Project the time through a trading time axis (gaps removed), nullptr for wall-clock time.
+    // The view and the data bounds stay in time, only the projection changes.
+    void setTimeAxis(shared_ptr<TradingTimeAxis> timeAxis) { this->timeAxis = timeAxis; }
+    shared_ptr<TradingTimeAxis> getTimeAxis() const { return timeAxis; }
+
+    // Count the emitted primitives into the given counters, nullptr to stop counting
+    void setCounters(ChartCounters* counters) { this->counters = counters; }
+    ChartCounters* getCounters() const { return counters; }
+
+    // Share the decimated vertices of the identified series with other charts (see
+    // DecimationCache, ChartGroup sets its own), nullptr to decimate on each draw
+    void setDecimationCache(shared_ptr<DecimationCache> decimationCache) { this->decimationCache = decimationCache; }
+    shared_ptr<DecimationCache> getDecimationCache() const { return decimationCache; }
 
     // Check if any data is outside visible view
     bool hasDataOutsideView() const {
@@ -144,21 +213,37 @@ public:
         return visible;
     }
 
+    // Visible items[from..to) of time sorted items, without copying them
+    // (all of them while the view is not initialized, like getVisible*)
+    template<typename Items>
+    void getVisibleRange(const Items& items, size_t& from, size_t& to) const {
+        if (!viewInitialized) {
+            from = 0;
+            to = items.size();
+            return;
+        }
+        from = findTimeIndex(items, viewFirst);
+        to = max(from, findTimeIndex(items, viewLast + 1));
+    }
+
+    // Append the visible part of time sorted items to out (a reused buffer keeps its capacity)
+    template<typename T>
+    void appendVisible(const vector<T>& items, vector<T>& out) const {
+        size_t from, to;
+        getVisibleRange(items, from, to);
+        out.insert(out.end(), items.begin() + from, items.begin() + to);
+    }
+
     // Fit Y-axis to visible candles only (updates value bounds to visible subset)
     void fitToVisibleCandles(const vector<Candle>& candles) {
-        // First get visible subset, then update bounds
-        vector<Candle> visible = getVisibleCandles(candles);
-        
-        // If no visible candles, preserve original bounds
-        if (visible.empty())
-            return;
-        
         // Only update Y-axis bounds (valueLower/valueUpper), NOT time bounds (valueFirst/valueLast)
-        // valueFirst/valueLast should preserve the full data range for zoom calculations
+        // valueFirst/valueLast should preserve the full data range for zoom calculations.
+        // If no candles are visible, the original bounds are preserved.
         float newValueLower = numeric_limits<float>::infinity();
         float newValueUpper = -numeric_limits<float>::infinity();
         
-        for (const Candle& candle : visible) {
+        for (const Candle& candle : candles) {
+            if (!isTimeVisible(candle.getTime())) continue;
             const float candleLow = candle.getLow();
             if (isnan(candleLow)) continue;
             const float candleHigh = candle.getHigh();
@@ -177,20 +262,17 @@ public:
     }
 
     // Fit Y-axis to visible points only (updates value bounds to visible subset)
-    void fitToVisiblePoints(const vector<TimePoint>& points) {
-        // First get visible subset, then update bounds
-        vector<TimePoint> visible = getVisiblePoints(points);
-        
-        // If no visible points, preserve original bounds
-        if (visible.empty())
-            return;
-        
+    template<typename Points = vector<TimePoint>>
+    void fitToVisiblePoints(const Points& points) {
         // Only update Y-axis bounds (valueLower/valueUpper), NOT time bounds (valueFirst/valueLast)
-        // valueFirst/valueLast should preserve the full data range for zoom calculations
+        // valueFirst/valueLast should preserve the full data range for zoom calculations.
+        // If no points are visible, the original bounds are preserved.
         float newValueLower = numeric_limits<float>::infinity();
         float newValueUpper = -numeric_limits<float>::infinity();
         
-        for (const TimePoint& point : visible) {
+        for (size_t n = 0; n < points.size(); n++) {
+            const TimePoint& point = points[n];
+            if (!isTimeVisible(point.getTime())) continue;
             const float pointValue = point.getValue();
             if (isnan(pointValue)) continue;
             
@@ -206,6 +288,89 @@ public:
         }
     }
 
+    // Index of the first item at or after the given time (items sorted by time,
+    // a vector or any view with size() and operator[])
+    template<typename Items>
+    size_t findTimeIndex(const Items& items, time_sec time) const {
+        size_t first = 0;
+        size_t count = items.size();
+        while (count > 0) {
+            const size_t step = count / 2;
+            if (items[first + step].getTime() < time) {
+                first += step + 1;
+                count -= step + 1;
+            } else count = step;
+        }
+        return first;
+    }
+
+    // Pixel width of one candle interval in the current view
+    // (on a trading time axis every bar of the axis interval gets the same width, gaps or not)
+    double getCandleBodyWidth(time_sec interval) const {
+        if (hasTimeAxis()) {
+            double visibleBars = toAxis(viewLast) - toAxis(viewFirst);
+            if (visibleBars <= 0) return 0;
+            return (double)innerWidth() * interval / timeAxis->getInterval() / visibleBars;
+        }
+        time_sec visibleDuration = viewLast - viewFirst;
+        if (visibleDuration <= 0) return 0;
+        return (double)innerWidth() * interval / visibleDuration;
+    }
+
+    // Canvas rectangle that has to be repainted when the data changed from the given time
+    // (the column from that time to the right edge, over the full inner height).
+    // halfWidthPx extends it to the left, e.g. for the half candle body.
+    // Returns false if the change is not visible.
+    bool getTailRect(time_sec from, double halfWidthPx, int& left, int& top, int& width, int& height) {
+        if (!hasValidViewBounds()) return false;
+        if (from > viewLast) return false;
+        left = from < viewFirst ? 0 : timeToX(from) - (int)ceil(halfWidthPx) - 1;
+        if (left < 0) left = 0;
+        top = spacingTop;
+        width = canvas.width() - left;
+        height = innerHeight() + 1;
+        return width > 0 && height > 0;
+    }
+
+    // First candle to redraw candles[index..) from, when the full draw showed them from `from`:
+    // merged candles (see showCandlesRange) are on a grid of steps from the start of the draw,
+    // so the redraw starts on that grid, one merged candle before the changed one
+    size_t getCandlesTailFrom(size_t from, size_t index, time_sec interval) const {
+        if (index <= from) return from;
+        const double candleBodyWidth = getCandleBodyWidth(interval);
+        if (candleBodyWidth >= 1 || candleBodyWidth <= 0) return index;
+        const size_t step = max((size_t)(1 / candleBodyWidth), (size_t)1);
+        const size_t aligned = from + (index - from) / step * step;
+        return aligned >= from + step ? aligned - step : from;
+    }
+
+    // First point to redraw points[index..) from, when the full draw showed them from `from`:
+    // the last vertex before index of the decimation (see decimate), the redraw picks the
+    // same vertices from there on. Only walks the times, nothing is drawn.
+    template<typename Points = vector<TimePoint>>
+    size_t getPointsTailFrom(const Points& points, size_t from, size_t index) const {
+        if (index > points.size()) index = points.size();
+        if (index <= from) return from;
+        const double lodSeconds = static_cast<double>(valueLast - valueFirst) / static_cast<double>(innerWidth());
+        size_t anchor = from;
+        time_sec t1 = points[from].getTime();
+        for (size_t n = from + 1; n < index; n++) {
+            const time_sec t2 = points[n].getTime();
+            const time_sec dt = t2 > t1 ? t2 - t1 : t1 - t2;
+            if (dt < lodSeconds) continue;
+            if (isnan(points[n].getValue())) continue;
+            anchor = n;
+            t1 = t2;
+        }
+        return anchor;
+    }
+
+    // Blocks narrower than 2 pixels on average are better drawn from their summaries
+    bool isSummaryLevel(size_t blocks) const {
+        int widthPx = innerWidth();
+        return widthPx > 0 && blocks * 2 >= (size_t)widthPx;
+    }
+
     // Check if data bounds are valid (valueLast > valueFirst)
     bool hasValidDataBounds() const {
         return valueLast > valueFirst && valueFirst > 0 && valueLast > 0;
@@ -221,6 +386,10 @@ public:
         if (!hasValidDataBounds()) return valueFirst;
         
         double ratio = (double)(pixelX - spacingLeft) / innerWidth();
+        if (hasTimeAxis()) {
+            double first = toAxis(valueFirst);
+            return fromAxis(first + ratio * (toAxis(valueLast) - first));
+        }
         return valueFirst + (time_sec)(ratio * (valueLast - valueFirst));
     }
 
@@ -233,6 +402,11 @@ public:
         if (!hasValidViewBounds())
             return;
         
+        if (hasTimeAxis()) {
+            zoomAtOnAxis(factor, pixelX);
+            return;
+        }
+        
         time_sec visibleDuration = viewLast - viewFirst;
         time_sec dataDuration = valueLast - valueFirst;
         
@@ -301,6 +475,11 @@ public:
     void scrollBy(double deltaPixels) {
         if (!hasValidDataBounds() || !hasValidViewBounds()) return;
         
+        if (hasTimeAxis()) {
+            scrollByOnAxis(deltaPixels);
+            return;
+        }
+        
         // Calculate seconds per pixel based on VISIBLE view range (not full data range)
         // This ensures 1:1 mapping between mouse movement and chart movement
         double secondsPerPixel = (double)(viewLast - viewFirst) / innerWidth();
@@ -333,11 +512,31 @@ public:
         unsigned int bearishColor = CHART_COLOR_BEARISH,
         double shoulderSpacing = 0.1
     ) {
+        showCandlesRange(
+            candles, 0, candles.size(), interval, 
+            bullishColor, bearishColor, shoulderSpacing
+        );
+    }
+
+    // Show only candles[from..to) - e.g. the tail changed by a CandleAggregator
+    void showCandlesRange(
+        const vector<Candle>& candles,
+        size_t from, size_t to,
+        time_sec interval,
+        unsigned int bullishColor = CHART_COLOR_BULLISH, 
+        unsigned int bearishColor = CHART_COLOR_BEARISH,
+        double shoulderSpacing = 0.1
+    ) {
+        if (to > candles.size()) to = candles.size();
+
         //  Calculate the candle body with in pixels (double) from interval
         // Use the VISIBLE time range (view window), not the full data range
         time_sec visibleDuration = viewLast - viewFirst; // Calculate the visible time span of the chart        
         int canvasWidth = innerWidth(); // Use inner width instead of full canvas width
-        double candleBodyWidth = (double)canvasWidth * interval / visibleDuration; // Calculate the width of one interval in pixels
+        double candleBodyWidth = hasTimeAxis() ? 
+            getCandleBodyWidth(interval) : // Bars by index, gaps removed
+            (double)canvasWidth * interval / visibleDuration; // Calculate the width of one interval in pixels
+        if (hasTimeAxis() && candleBodyWidth <= 0) return;
         
         // DEBUG: Log the LOD calculation
         // std::cerr << "DEBUG showCandles: viewFirst=" << viewFirst << " viewLast=" << viewLast 
@@ -347,9 +546,10 @@ public:
         
         // Select the right level of details (LOD)
         if (candleBodyWidth > 5) { // Show each candles...
-            for (const Candle& candle: candles) 
+            if (counters) counters->candlesFull += to > from ? to - from : 0;
+            for (size_t n = from; n < to; n++) 
                 if (!showCandle(
-                    candle, candleBodyWidth, 
+                    candles[n], candleBodyWidth, 
                     bullishColor, bearishColor, 
                     shoulderSpacing
                 )) continue;
@@ -357,14 +557,17 @@ public:
         }
 
         if (candleBodyWidth >= 1) { // Show only a representing line
-            for (const Candle& candle: candles) 
-                if (!showCandleAsLine(candle, candleBodyWidth, bullishColor, bearishColor)) continue;
+            if (counters) counters->candlesAsLines += to > from ? to - from : 0;
+            for (size_t n = from; n < to; n++) 
+                if (!showCandleAsLine(candles[n], candleBodyWidth, bullishColor, bearishColor)) continue;
             return;
         }
 
-        Candle prevCandle = candles[0];
+        if (from >= to) return;
+        if (counters) counters->candlesMerged += to - from;
+        Candle prevCandle = candles[from];
         int step = 1 / candleBodyWidth;
-        for (size_t n = step; n < candles.size(); n += step) {
+        for (size_t n = from + step; n < to; n += step) {
             const Candle& thisCandle = candles[n];
             
             float open = prevCandle.getOpen();
@@ -381,17 +584,42 @@ public:
 
     }
 
+    template<typename Points = vector<TimePoint>>
     void showBars(
-        const vector<TimePoint>& points,
+        const Points& points,
         unsigned int color = CHART_COLOR_PLOTTER //,
         // double spacing = 0.1 // TODO give width for the bars somehow!
     ) {
+        showBarsRange(points, 0, points.size(), color);
+    }
+
+    // Show only points[from..to).
+    // A series identified by seriesId (and its version, see TimePointSeries) is
+    // decimated through the decimation cache, if any.
+    template<typename Points = vector<TimePoint>>
+    void showBarsRange(
+        const Points& points,
+        size_t from, size_t to,
+        unsigned int color = CHART_COLOR_PLOTTER,
+        size_t seriesId = 0,
+        size_t version = 0
+    ) {
+        if (to > points.size()) to = points.size();
+
         // If we don't have a valid time range or drawable width, bail out
-        if (points.size() < 2) return;
+        if (to < from + 2) return;
         if (!hasValidDataBounds()) return;
         int widthPx = innerWidth();
         if (widthPx <= 0) return;
 
+        // Bars at the cached vertices but the first one
+        if (decimationCache && seriesId) {
+            DecimationCache::Vertices vertices = getDecimated(points, from, to, true, seriesId, version);
+            for (size_t n = 1; n < vertices->size(); n++)
+                (void)showBar((*vertices)[n].getTime(), (*vertices)[n].getValue(), color);
+            return;
+        }
+
         // How many seconds correspond to one pixel (computed once)
         double secondsPerPixel = static_cast<double>(valueLast - valueFirst) / static_cast<double>(widthPx);
 
@@ -402,7 +630,8 @@ public:
         const int lod = 1; // number of pixels to skip
         double lodSeconds = lod * secondsPerPixel; // computed once, in seconds
 
-        for (const TimePoint& point: points) {
+        for (size_t n = from; n < to; n++) {
+            const TimePoint& point = points[n];
             if (first) {
                 t1 = point.getTime();
                 first = false;
@@ -421,16 +650,42 @@ public:
     }
 
 
+    template<typename Points = vector<TimePoint>>
     void showPoints(
-        const vector<TimePoint>& points,
+        const Points& points,
         unsigned int color = CHART_COLOR_PLOTTER
     ) {
+        showPointsRange(points, 0, points.size(), color);
+    }
+
+    // Show only points[from..to), the identified series through the decimation cache (see showBarsRange)
+    template<typename Points = vector<TimePoint>>
+    void showPointsRange(
+        const Points& points,
+        size_t from, size_t to,
+        unsigned int color = CHART_COLOR_PLOTTER,
+        size_t seriesId = 0,
+        size_t version = 0
+    ) {
+        if (to > points.size()) to = points.size();
+
         // If we don't have a valid time range or drawable width, bail out
-        if (points.size() < 2) return;
+        if (to < from + 2) return;
         if (!hasValidDataBounds()) return;
         int widthPx = innerWidth();
         if (widthPx <= 0) return;
 
+        // Lines between the cached vertices
+        if (decimationCache && seriesId) {
+            DecimationCache::Vertices vertices = getDecimated(points, from, to, false, seriesId, version);
+            for (size_t n = 1; n < vertices->size(); n++) {
+                const TimePoint& point1 = (*vertices)[n - 1];
+                const TimePoint& point2 = (*vertices)[n];
+                (void)showLine(point1.getTime(), point1.getValue(), point2.getTime(), point2.getValue(), color);
+            }
+            return;
+        }
+
         // How many seconds correspond to one pixel (computed once)
         double secondsPerPixel = static_cast<double>(valueLast - valueFirst) / static_cast<double>(widthPx);
 
@@ -441,7 +696,8 @@ public:
         const int lod = 1; // number of pixels to skip
         double lodSeconds = lod * secondsPerPixel; // computed once, in seconds
 
-        for (const TimePoint& point: points) {
+        for (size_t n = from; n < to; n++) {
+            const TimePoint& point = points[n];
             if (first) {
                 t1 = point.getTime();
                 v1 = point.getValue();
@@ -461,7 +717,79 @@ public:
         }
     }
 
+    // Draw blocks from their summaries only: a min-max line per block,
+    // connected from the last value of the previous block to the first value of the next one
+    void showSummaries(
+        const vector<SeriesBlockSummary>& summaries,
+        unsigned int color = CHART_COLOR_PLOTTER
+    ) {
+        bool hasPrev = false;
+        time_sec prevTime = 0;
+        float prevValue = 0;
+        for (const SeriesBlockSummary& summary: summaries) {
+            if (summary.count == 0) continue;
+
+            // Connect to the previous block (not shown if any end is NaN)
+            if (hasPrev) (void)showLine(prevTime, prevValue, summary.first, summary.firstValue, color);
+            hasPrev = true;
+            prevTime = summary.last;
+            prevValue = summary.lastValue;
+
+            if (summary.minValue > summary.maxValue) continue; // no valid value in the block
+            const time_sec middle = summary.first + (summary.last - summary.first) / 2;
+            (void)showLine(middle, summary.minValue, middle, summary.maxValue, color);
+        }
+    }
+
+    // Decimate an identified series into the decimation cache ahead of showBarsRange()
+    // or showPointsRange() with the same range and bounds, e.g. on a RenderPool worker
+    // preparing the chart, so the draw only looks the vertices up
+    template<typename Points = vector<TimePoint>>
+    void cacheDecimated(const Points& points, size_t from, size_t to, bool bars, size_t seriesId, size_t version) {
+        if (to > points.size()) to = points.size();
+        if (!decimationCache || !seriesId || to < from + 2) return;
+        if (!hasValidDataBounds() || innerWidth() <= 0) return;
+        (void)getDecimated(points, from, to, bars, seriesId, version);
+    }
+
 protected:
+    // The points showPointsRange() connects (showBarsRange() draws all but the first one):
+    // the first point, then each one at least a pixel after the previous vertex,
+    // NaN values are skipped (lines skip everything after a NaN first point)
+    template<typename Points>
+    void decimate(const Points& points, size_t from, size_t to, bool bars, vector<TimePoint>& vertices) const {
+        const double lodSeconds = static_cast<double>(valueLast - valueFirst) / static_cast<double>(innerWidth());
+        const TimePoint& firstPoint = points[from];
+        vertices.push_back(TimePoint(firstPoint.getTime(), firstPoint.getValue()));
+        if (!bars && isnan(firstPoint.getValue())) return;
+        time_sec t1 = firstPoint.getTime();
+        for (size_t n = from + 1; n < to; n++) {
+            const TimePoint& point = points[n];
+            const time_sec t2 = point.getTime();
+            const time_sec dt = t2 > t1 ? t2 - t1 : t1 - t2;
+            if (dt < lodSeconds) continue;
+            if (isnan(point.getValue())) continue;
+            vertices.push_back(TimePoint(t2, point.getValue()));
+            t1 = t2;
+        }
+    }
+
+    // Decimated vertices of an identified series from the decimation cache (decimated and cached on a miss)
+    template<typename Points>
+    DecimationCache::Vertices getDecimated(const Points& points, size_t from, size_t to, bool bars, size_t seriesId, size_t version) {
+        const TimePoint& last = points[to - 1];
+        const DecimationKey key = {
+            seriesId, version, points.size(), from, to, last.getTime(), last.getValue(),
+            valueFirst, valueLast, innerWidth(), bars
+        };
+        DecimationCache::Vertices vertices = decimationCache->find(key);
+        if (vertices) return vertices;
+        shared_ptr<vector<TimePoint>> decimated = make_shared<vector<TimePoint>>();
+        decimate(points, from, to, bars, *decimated);
+        decimationCache->store(key, decimated);
+        return decimated;
+    }
+
     // Helper methods to get inner drawing area dimensions
     int innerWidth() const {
         return canvas.width() - spacingLeft - spacingRight;
@@ -479,6 +807,83 @@ protected:
         return y + spacingTop;
     }
 
+    bool hasTimeAxis() const {
+        return timeAxis && !timeAxis->empty();
+    }
+
+    // Everything is visible while the view is not initialized
+    bool isTimeVisible(time_sec time) const {
+        return !viewInitialized || (time >= viewFirst && time <= viewLast);
+    }
+
+    // Position on the projected axis (bar ordinal on a trading time axis, the time otherwise)
+    double toAxis(time_sec time) const {
+        return hasTimeAxis() ? timeAxis->timeToOrdinal(time) : (double)time;
+    }
+
+    time_sec fromAxis(double position) const {
+        return hasTimeAxis() ? timeAxis->ordinalToTime(position) : (time_sec)position;
+    }
+
+    // zoomAt() on the trading time axis: same edge/center logic, in bars instead of seconds
+    void zoomAtOnAxis(double factor, int pixelX) {
+        const double dataFirst = toAxis(valueFirst);
+        const double dataLast = toAxis(valueLast);
+        const double dataBars = dataLast - dataFirst;
+        double newBars = (toAxis(viewLast) - toAxis(viewFirst)) / factor;
+        if (newBars > dataBars) newBars = dataBars;
+        if (newBars < 1) newBars = min(1.0, dataBars); // keep at least one bar
+
+        double relativeX = (double)(pixelX - spacingLeft) / innerWidth();
+        if (relativeX < 0.0 || relativeX > 1.0) relativeX = 0.5;
+
+        double first, last;
+        if (relativeX < 0.25) {
+            first = dataFirst;
+            last = first + newBars;
+        } else if (relativeX > 0.75) {
+            last = dataLast;
+            first = last - newBars;
+        } else {
+            first = dataFirst + relativeX * dataBars - relativeX * newBars;
+            last = first + newBars;
+            if (first < dataFirst) {
+                first = dataFirst;
+                last = first + newBars;
+            }
+            if (last > dataLast) {
+                last = dataLast;
+                first = last - newBars;
+            }
+        }
+
+        viewFirst = fromAxis(first);
+        viewLast = fromAxis(last);
+        if (viewLast - viewFirst < 1) viewLast = viewFirst + 1;
+    }
+
+    // scrollBy() on the trading time axis: a pixel moves the same number of bars across gaps
+    void scrollByOnAxis(double deltaPixels) {
+        const double dataFirst = toAxis(valueFirst);
+        const double dataLast = toAxis(valueLast);
+        double first = toAxis(viewFirst);
+        double last = toAxis(viewLast);
+        const double bars = last - first;
+        const double delta = -deltaPixels * bars / innerWidth();
+        first += delta;
+        last += delta;
+        if (first < dataFirst) {
+            first = dataFirst;
+            last = first + bars;
+        }
+        if (last > dataLast) {
+            last = dataLast;
+            first = last - bars;
+        }
+        viewFirst = fromAxis(first);
+        viewLast = fromAxis(last);
+    }
+
     [[nodiscard]] 
     bool showCandle(
         const Candle& candle, 
@@ -515,6 +920,7 @@ protected:
         int heightPx = bottom - top;
 
         canvas.rectf(left, top, widthPx, heightPx, color);
+        if (counters) counters->rects++;
         return true;
     }
 
@@ -553,6 +959,7 @@ protected:
             timeToX(x), valueToY(0), 
             color
         );
+        if (counters) counters->lines++;
         return true;
     }
 
@@ -568,6 +975,7 @@ protected:
             timeToX(x2), valueToY(y2), 
             color
         );
+        if (counters) counters->lines++;
         return true;
     }
 
@@ -582,6 +990,14 @@ protected:
         
         if (viewEnd <= viewStart) return innerWidth() / 2;
         
+        // Trading time: linear in bar ordinals
+        if (hasTimeAxis()) {
+            double start = toAxis(viewStart);
+            double end = toAxis(viewEnd);
+            if (end <= start) return innerWidth() / 2;
+            return innerX((int)((toAxis(time) - start) / (end - start) * innerWidth()));
+        }
+        
         // Linear interpolation: map [viewFirst, viewLast] to [spacingLeft, canvas.width()-spacingRight]
         double ratio = (double)(time - viewStart) / (viewEnd - viewStart);
         int x = (int)(ratio * innerWidth());
@@ -611,6 +1027,9 @@ protected:
     time_sec viewFirst;
     time_sec viewLast;
     bool viewInitialized = false;
+    shared_ptr<TradingTimeAxis> timeAxis = nullptr;
+    ChartCounters* counters = nullptr;
+    shared_ptr<DecimationCache> decimationCache = nullptr;
 
 protected:
     double zoomInFactor;
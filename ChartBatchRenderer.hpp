@@ -0,0 +1,174 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "Chart.hpp"
+#include "ImageCanvas.hpp"
+#include "SubCanvas.hpp"
+#include "PngWriter.hpp"
+#include "CsvImporter.hpp"
+#include "RenderPool.hpp"
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+// The data of one chart of a batch image
+struct BatchChartData {
+    vector<TimePoint> points;   // drawn as a line
+    vector<Candle> candles;     // drawn as candles, if any
+};
+
+// One image of the batch: one chart per series file, stacked like UI_MultiChart does
+struct BatchChartJob {
+    vector<string> files;
+    string output;              // PNG filename
+};
+
+// Geometry and input format of the batch images
+struct BatchChartLayout {
+    int width = 800;            // of the image, the charts are spacing narrower on both sides
+    int chartHeight = 200;
+    int spacing = 10;           // around the column of charts
+    unsigned int background = EGA_BLACK;
+    unsigned int color = CHART_COLOR_PLOTTER;
+    bool candles = false;       // the files have time, open, high, low, close (and volume) columns
+    char delimiter = ',';
+    bool hasHeader = true;
+    CsvImporter::TimeFormat timeFormat = CsvImporter::TIME_SECONDS;
+
+    int getImageHeight(size_t charts) const { return spacing * 2 + (int)charts * chartHeight; }
+};
+
+struct BatchChartStats {
+    size_t images = 0;
+    size_t charts = 0;
+    size_t failed = 0;          // images not written (see errors)
+    double seconds = 0;
+    vector<string> errors;
+
+    double getChartsPerSecond() const { return seconds > 0 ? charts / seconds : 0; }
+};
+
+// Renders batches of chart images headless: plain Chart instances drawn on an
+// ImageCanvas (no FLTK, no display), one image per RenderPool job, so all the
+// cores are busy. Each worker reuses its image and PNG buffers between jobs.
+class ChartBatchRenderer {
+public:
+    typedef function<void(const string& filename, const BatchChartLayout& layout, BatchChartData& data)> Loader;
+
+    ChartBatchRenderer(const BatchChartLayout& layout, RenderPool& pool = RenderPool::getInstance()):
+        layout(layout),
+        pool(pool)
+    {
+        if (layout.width <= layout.spacing * 2 || layout.chartHeight <= 0)
+            throw ERROR("Invalid batch chart layout");
+    }
+
+    virtual ~ChartBatchRenderer() {}
+
+    // Where the series come from (CSV files by default)
+    void setLoader(Loader loader) { this->loader = loader; }
+
+    // Called after each image (from the worker threads), e.g. for a progress line
+    function<void(const BatchChartJob& job, const string& error)> onImage = nullptr;
+
+    // Render and write all the images, errors are collected per image
+    BatchChartStats run(const vector<BatchChartJob>& jobs) {
+        BatchChartStats stats;
+        mutex statsMutex;
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        vector<shared_ptr<RenderJob>> renderJobs;
+        renderJobs.reserve(jobs.size());
+        for (const BatchChartJob& job: jobs)
+            renderJobs.push_back(pool.submit([this, &job, &stats, &statsMutex](const RenderJob&) {
+                string error;
+                try {
+                    renderFile(job);
+                } catch (exception& e) {
+                    error = job.output + ": " + e.what();
+                }
+                if (onImage) onImage(job, error);
+                lock_guard<mutex> lock(statsMutex);
+                if (error.empty()) {
+                    stats.images++;
+                    stats.charts += job.files.size();
+                } else {
+                    stats.failed++;
+                    stats.errors.push_back(error);
+                }
+            }, RENDER_PRIORITY_BACKGROUND));
+        pool.waitAll(renderJobs);
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    // Load, render and write one image
+    void renderFile(const BatchChartJob& job) {
+        thread_local vector<BatchChartData> charts;
+        thread_local ImageCanvas image;
+        thread_local vector<unsigned char> png;
+        charts.resize(job.files.size());
+        for (size_t n = 0; n < job.files.size(); n++) {
+            charts[n].points.clear();
+            charts[n].candles.clear();
+            loader(job.files[n], layout, charts[n]);
+        }
+        render(charts, image);
+        PngWriter::encode(image, png);
+        PngWriter::write(job.output, png);
+    }
+
+    // Stack the charts into the image (resized to fit them all)
+    void render(const vector<BatchChartData>& charts, ImageCanvas& image) const {
+        image.setBackground(layout.background);
+        image.resize(layout.width, layout.getImageHeight(charts.size()));
+        SubCanvas canvas(image, 0, 0, 0, 0);
+        for (size_t n = 0; n < charts.size(); n++) {
+            canvas.setRect(
+                layout.spacing, layout.spacing + (int)n * layout.chartHeight,
+                layout.width - layout.spacing * 2, layout.chartHeight
+            );
+            renderChart(canvas, charts[n], layout.color);
+        }
+    }
+
+    // Fit a chart to all of its data and draw it, the way Fl_ChartBox draws one pane
+    static void renderChart(Canvas& canvas, const BatchChartData& data, unsigned int color) {
+        Chart chart(canvas);
+        chart.fitToCandles(data.candles);
+        chart.fitToPoints(data.points);
+        chart.resetView();
+        chart.fitToVisibleCandles(data.candles);
+        chart.fitToVisiblePoints(data.points);
+        if (!data.candles.empty())
+            chart.showCandlesRange(data.candles, 0, data.candles.size(), getInterval(data.candles));
+        if (!data.points.empty())
+            chart.showPointsRange(data.points, 0, data.points.size(), color);
+    }
+
+    // Smallest time step between the candles (1 for less than two)
+    static time_sec getInterval(const vector<Candle>& candles) {
+        time_sec interval = 0;
+        for (size_t n = 1; n < candles.size(); n++) {
+            const time_sec step = candles[n].getTime() - candles[n - 1].getTime();
+            if (step > 0 && (!interval || step < interval)) interval = step;
+        }
+        return interval ? interval : 1;
+    }
+
+    // One series per CSV file, parsed on the calling thread (the images are the parallel unit)
+    static void loadCsv(const string& filename, const BatchChartLayout& layout, BatchChartData& data) {
+        CsvImporter importer(filename, layout.delimiter, layout.hasHeader, layout.timeFormat, 1);
+        if (layout.candles) importer.importCandles(data.candles, 0, 1, 2, 3, 4, CSV_NO_COLUMN);
+        else importer.importPoints(data.points);
+    }
+
+protected:
+    BatchChartLayout layout;
+    RenderPool& pool;
+    Loader loader = loadCsv;
+};
@@ -3,32 +3,65 @@
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include "Chart.hpp"
+#include "Tracer.hpp"
 
 using namespace std;
 
+// Charts zoomed and scrolled together. They share a DecimationCache, so a series
+// shown by several of them (same TimePointSeries id, e.g. copies of one series
+// added to each chart box) is decimated once per view.
 class ChartGroup {
 public:
     ChartGroup(bool syncXAxis = true) : syncXAxis(syncXAxis) {}
     
     // Callback to notify when charts need to be redrawn (set by UI_MultiChart)
     function<void()> onSync = nullptr;
+
+    // Callback before the group changes the views of the charts (set by UI_MultiChart
+    // to cancel the fits of the previous view still running on the render pool)
+    function<void()> onBeforeSync = nullptr;
     
     void addChart(Chart& chart) {
         Chart* ptr = &chart;
         if (find(charts.begin(), charts.end(), ptr) == charts.end())
             charts.push_back(ptr);
+        if (timeAxis) chart.setTimeAxis(timeAxis);
+        chart.setDecimationCache(decimationCache);
     }
     
     void removeChart(Chart& chart) {
         Chart* ptr = &chart;
         charts.erase(remove(charts.begin(), charts.end(), ptr), charts.end());
+        if (chart.getDecimationCache() == decimationCache) chart.setDecimationCache(nullptr);
     }
     
     void setSyncXAxis(bool sync) { syncXAxis = sync; }
     bool getSyncXAxis() const { return syncXAxis; }
     
+    // Share one trading time axis between the charts (nullptr = back to wall-clock time),
+    // so the same time lands on the same pixel in every chart. Only candle serieses add
+    // their times to it (merged across the charts), a chart of bars or points alone
+    // projects onto the candle times of the others.
+    void setTimeAxis(shared_ptr<TradingTimeAxis> timeAxis) {
+        this->timeAxis = timeAxis;
+        for (Chart* chart : charts)
+            chart->setTimeAxis(timeAxis);
+    }
+    shared_ptr<TradingTimeAxis> getTimeAxis() const { return timeAxis; }
+
+    // Decimation cache of the charts (nullptr to decimate in each chart)
+    void setDecimationCache(shared_ptr<DecimationCache> decimationCache) {
+        this->decimationCache = decimationCache;
+        for (Chart* chart : charts)
+            chart->setDecimationCache(decimationCache);
+    }
+    shared_ptr<DecimationCache> getDecimationCache() const { return decimationCache; }
+    
     void zoomAt(double factor, int pixelX) {
+        TraceSpan span("ChartGroup::zoomAt", "sync");
+        if (onBeforeSync) onBeforeSync();
         if (syncXAxis && !charts.empty()) {
             // Calculate shared data bounds across all charts
             time_sec sharedFirst = charts[0]->getValueFirst();
@@ -49,7 +82,10 @@ public:
             }
             
             // Notify that all charts need to be redrawn
-            if (onSync) onSync();
+            if (onSync) {
+                TraceSpan syncSpan("ChartGroup::onSync", "sync");
+                onSync();
+            }
         } else {
             // Independent zoom (original behavior)
             for (Chart* chart : charts)
@@ -58,6 +94,8 @@ public:
     }
     
     void scrollBy(double deltaPixels) {
+        TraceSpan span("ChartGroup::scrollBy", "sync");
+        if (onBeforeSync) onBeforeSync();
         if (syncXAxis && !charts.empty()) {
             // Calculate shared data bounds across all charts
             time_sec sharedFirst = charts[0]->getValueFirst();
@@ -78,7 +116,10 @@ public:
             }
             
             // Notify that all charts need to be redrawn
-            if (onSync) onSync();
+            if (onSync) {
+                TraceSpan syncSpan("ChartGroup::onSync", "sync");
+                onSync();
+            }
         } else {
             // Independent scroll (original behavior)
             for (Chart* chart : charts)
@@ -89,6 +130,7 @@ public:
     // Synchronize all charts to show the same X-axis range
     void synchronizeXAxis() {
         if (charts.empty()) return;
+        if (onBeforeSync) onBeforeSync();
         
         // Calculate shared data bounds across all charts
         time_sec sharedFirst = charts[0]->getValueFirst();
@@ -111,4 +153,6 @@ public:
 private:
     vector<Chart*> charts;
     bool syncXAxis;
+    shared_ptr<TradingTimeAxis> timeAxis = nullptr;
+    shared_ptr<DecimationCache> decimationCache = make_shared<DecimationCache>();
 };
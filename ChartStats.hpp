@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Tracer.hpp"
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+
+using namespace std;
+
+// Phases of a frame (see Fl_ChartBox::draw)
+enum ChartPhase {
+    CHART_PHASE_INDICATORS, // updating the indicators from their sources
+    CHART_PHASE_FIT,        // resetBounds, fitTo* of the whole data, resetView
+    CHART_PHASE_VISIBLE,    // extracting the visible data
+    CHART_PHASE_WINDOWED,   // fetching the view of the windowed series
+    CHART_PHASE_FIT_Y,      // fitting the Y-axis to the visible data
+    CHART_PHASE_DRAW,       // LOD selection and canvas calls
+    CHART_PHASE_COUNT
+};
+
+inline const char* getChartPhaseName(ChartPhase phase) {
+    static const char* names[CHART_PHASE_COUNT] = {
+        "indicators", "fit", "visible", "windowed", "fitY", "draw"
+    };
+    return phase < CHART_PHASE_COUNT ? names[phase] : "unknown";
+}
+
+// Primitives emitted by a Chart, counted while a ChartCounters is attached (Chart::setCounters)
+struct ChartCounters {
+    size_t lines = 0;
+    size_t rects = 0;
+    size_t candlesFull = 0;     // LOD: candles drawn with body
+    size_t candlesAsLines = 0;  // LOD: candles drawn as a line
+    size_t candlesMerged = 0;   // LOD: candles merged into one line per pixel
+};
+
+struct ChartSeriesStats {
+    string kind;                // "candles", "bars", "points", "indicator", "windowed", "adapted"
+    size_t index = 0;           // index of the series of its kind in the pane
+    size_t pointsScanned = 0;   // points looked at for the view
+    size_t pointsCulled = 0;    // points outside of the view
+    size_t lines = 0;
+    size_t rects = 0;
+    double drawNs = 0;
+};
+
+struct ChartPaneStats {
+    double phaseNs[CHART_PHASE_COUNT] = {};
+    size_t pointsScanned = 0;
+    size_t pointsCulled = 0;
+    size_t lines = 0;
+    size_t rects = 0;
+    size_t cacheHits = 0;       // windowed series blocks/chunks found in their cache
+    size_t cacheMisses = 0;     // ... and loaded or computed
+    vector<ChartSeriesStats> series;
+
+    void reset() {
+        for (double& ns: phaseNs) ns = 0;
+        pointsScanned = 0;
+        pointsCulled = 0;
+        lines = 0;
+        rects = 0;
+        cacheHits = 0;
+        cacheMisses = 0;
+        series.clear();
+    }
+
+    double getTotalNs() const {
+        double total = 0;
+        for (double ns: phaseNs) total += ns;
+        return total;
+    }
+};
+
+struct ChartFrameStats {
+    size_t frame = 0;           // frames counted since the stats were enabled
+    bool tail = false;          // only the tail was repainted (see Fl_ChartBox::redrawTail)
+    double totalNs = 0;
+    vector<ChartPaneStats> panes;
+};
+
+// Adds the time of its scope to a phase of a pane, does nothing without a pane
+// (stats disabled), so the instrumented code pays only a null check.
+// The phase is also traced as a span while the Tracer is enabled.
+class ChartPhaseTimer {
+public:
+    ChartPhaseTimer(ChartPaneStats* stats, ChartPhase phase):
+        span(getChartPhaseName(phase), "phase"),
+        stats(stats),
+        phase(phase)
+    {
+        if (stats) start = chrono::steady_clock::now();
+    }
+
+    virtual ~ChartPhaseTimer() {
+        if (stats) stats->phaseNs[phase] += getElapsedNs(start);
+    }
+
+    static double getElapsedNs(chrono::steady_clock::time_point start) {
+        return (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    }
+
+protected:
+    TraceSpan span;
+    ChartPaneStats* stats;
+    ChartPhase phase;
+    chrono::steady_clock::time_point start;
+};
+
+// Records the stats of one series around its show* call: the points it
+// scanned and culled, the primitives it added to the counters and its time
+class ChartSeriesTimer {
+public:
+    ChartSeriesTimer(
+        ChartPaneStats* stats,
+        const ChartCounters& counters,
+        const char* kind,
+        size_t index,
+        size_t scanned,
+        size_t visible
+    ):
+        stats(stats),
+        counters(counters)
+    {
+        if (!stats) return;
+        series.kind = kind;
+        series.index = index;
+        series.pointsScanned = scanned;
+        series.pointsCulled = scanned - min(scanned, visible);
+        lines = counters.lines;
+        rects = counters.rects;
+        start = chrono::steady_clock::now();
+    }
+
+    virtual ~ChartSeriesTimer() {
+        if (!stats) return;
+        series.drawNs = ChartPhaseTimer::getElapsedNs(start);
+        series.lines = counters.lines - lines;
+        series.rects = counters.rects - rects;
+        stats->pointsScanned += series.pointsScanned;
+        stats->pointsCulled += series.pointsCulled;
+        stats->lines += series.lines;
+        stats->rects += series.rects;
+        stats->series.push_back(series);
+    }
+
+protected:
+    ChartPaneStats* stats;
+    const ChartCounters& counters;
+    ChartSeriesStats series;
+    size_t lines = 0;
+    size_t rects = 0;
+    chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "Chart.hpp"
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// View of a chart that is not backed by a widget (see ChartVirtualizer)
+struct ChartViewState {
+    bool initialized = false;
+    time_sec viewFirst = 0;
+    time_sec viewLast = 0;
+
+    void save(const Chart& chart) {
+        initialized = chart.isViewInitialized();
+        viewFirst = chart.getViewFirst();
+        viewLast = chart.getViewLast();
+    }
+
+    void restore(Chart& chart) const {
+        if (!initialized) {
+            chart.clearView();
+            return;
+        }
+        chart.setViewFirst(viewFirst);
+        chart.setViewLast(viewLast);
+    }
+};
+
+// Layout of a vertical list of charts, of which only the ones intersecting
+// the viewport (plus bufferCharts on both sides) are live, i.e. backed by a
+// widget. The others keep their view state only. update() tells which slots
+// left and entered the live range, so the widgets can be recycled between them.
+class ChartVirtualizer {
+public:
+    ChartVirtualizer(size_t bufferCharts = 2): bufferCharts(bufferCharts) {}
+
+    virtual ~ChartVirtualizer() {}
+
+    void setBufferCharts(size_t bufferCharts) { this->bufferCharts = bufferCharts; }
+    size_t getBufferCharts() const { return bufferCharts; }
+
+    // Slots are added top to bottom, without overlapping
+    size_t addSlot(int top, int height) {
+        if (height < 0) throw ERROR("Chart slot height can not be negative");
+        if (!slots.empty() && top < slots.back().top + slots.back().height)
+            throw ERROR("Chart slots must be added top to bottom");
+        slots.push_back({ top, height, ChartViewState() });
+        return slots.size() - 1;
+    }
+
+    void clear() {
+        slots.clear();
+        liveFrom = 0;
+        liveTo = 0;
+    }
+
+    size_t size() const { return slots.size(); }
+    int getSlotTop(size_t n) const { return slots.at(n).top; }
+    int getSlotHeight(size_t n) const { return slots.at(n).height; }
+    int getContentHeight() const { return slots.empty() ? 0 : slots.back().top + slots.back().height; }
+
+    ChartViewState& getViewState(size_t n) { return slots.at(n).viewState; }
+
+    bool isLive(size_t n) const { return n >= liveFrom && n < liveTo; }
+    size_t getLiveFrom() const { return liveFrom; }
+    size_t getLiveTo() const { return liveTo; }
+
+    // Slots [from..to) intersecting the viewport, extended by the buffer
+    void getLiveRange(int viewportTop, int viewportHeight, size_t& from, size_t& to) const {
+        from = to = 0;
+        if (viewportHeight <= 0 || slots.empty()) return;
+        const int viewportBottom = viewportTop + viewportHeight;
+        from = partition_point(slots.begin(), slots.end(), 
+            [viewportTop](const Slot& slot) { return slot.top + slot.height <= viewportTop; }
+        ) - slots.begin();
+        to = partition_point(slots.begin() + from, slots.end(), 
+            [viewportBottom](const Slot& slot) { return slot.top < viewportBottom; }
+        ) - slots.begin();
+        if (from >= to) return; // between or after the slots, nothing visible
+        from = from > bufferCharts ? from - bufferCharts : 0;
+        to = min(slots.size(), to + bufferCharts);
+    }
+
+    // Move the live range to the viewport, the slots leaving it are listed in
+    // released, the ones entering it in acquired (both in index order)
+    void update(int viewportTop, int viewportHeight, vector<size_t>& released, vector<size_t>& acquired) {
+        released.clear();
+        acquired.clear();
+        size_t from, to;
+        getLiveRange(viewportTop, viewportHeight, from, to);
+        for (size_t n = liveFrom; n < liveTo; n++)
+            if (n < from || n >= to) released.push_back(n);
+        for (size_t n = from; n < to; n++)
+            if (!isLive(n)) acquired.push_back(n);
+        liveFrom = from;
+        liveTo = to;
+    }
+
+protected:
+    struct Slot {
+        int top;
+        int height;
+        ChartViewState viewState;
+    };
+
+    size_t bufferCharts;
+    vector<Slot> slots;
+    size_t liveFrom = 0;
+    size_t liveTo = 0;
+};
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "WindowedPointSeries.hpp"
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+
+// Bit stream of a compressed block (most significant bit first)
+class CompressedBitWriter {
+public:
+    void write(uint64_t value, int bits) {
+        while (bits > 0) {
+            const size_t used = bitCount % 64;
+            if (used == 0) words.push_back(0);
+            const int space = 64 - (int)used;
+            const int take = bits < space ? bits : space;
+            const uint64_t chunk = (value >> (bits - take)) & (take == 64 ? ~0ull : ((1ull << take) - 1));
+            words.back() |= chunk << (space - take);
+            bits -= take;
+            bitCount += take;
+        }
+    }
+
+    void shrink() { words.shrink_to_fit(); }
+
+    const vector<uint64_t>& getWords() const { return words; }
+    size_t getBitCount() const { return bitCount; }
+
+protected:
+    vector<uint64_t> words;
+    size_t bitCount = 0;
+};
+
+class CompressedBitReader {
+public:
+    CompressedBitReader(const vector<uint64_t>& words): words(words) {}
+
+    uint64_t read(int bits) {
+        uint64_t value = 0;
+        while (bits > 0) {
+            const size_t used = position % 64;
+            const int space = 64 - (int)used;
+            const int take = bits < space ? bits : space;
+            const uint64_t word = words[position / 64];
+            const uint64_t chunk = (word >> (space - take)) & (take == 64 ? ~0ull : ((1ull << take) - 1));
+            value = take == 64 ? chunk : (value << take) | chunk;
+            bits -= take;
+            position += take;
+        }
+        return value;
+    }
+
+    bool readBit() { return read(1) != 0; }
+
+protected:
+    const vector<uint64_t>& words;
+    size_t position = 0;
+};
+
+// Point series compressed in the style of Facebook's Gorilla:
+// delta-of-delta encoded timestamps and XOR encoded float values, in blocks of
+// blockSize points. Each block decodes independently and carries a summary
+// (first/last/min/max), so the chart decodes only the blocks in the view and
+// draws from the summaries alone when zoomed out far enough.
+// Regular ticks take a bit for the timestamp and a few bits for the value
+// instead of the 24 bytes of a TimePoint.
+class CompressedPointSeries: public WindowedPointSeries {
+public:
+    CompressedPointSeries(
+        unsigned int color = CHART_COLOR_PLOTTER,
+        size_t blockSize = 1024
+    ):
+        WindowedPointSeries(color),
+        blockSize(blockSize)
+    {
+        if (blockSize < 2) throw ERROR("Compressed block size must be at least 2");
+    }
+
+    CompressedPointSeries(
+        const vector<TimePoint>& points,
+        unsigned int color = CHART_COLOR_PLOTTER,
+        size_t blockSize = 1024
+    ):
+        CompressedPointSeries(color, blockSize)
+    {
+        for (const TimePoint& point: points) append(point);
+    }
+
+    virtual ~CompressedPointSeries() {}
+
+    // Points has to be appended in time order
+    void append(const TimePoint& point) {
+        const time_sec time = point.getTime();
+        const float value = point.getValue();
+        if (!blocks.empty() && time < summaries.back().last)
+            throw ERROR("Compressed points must be appended in time order");
+
+        if (blocks.empty() || summaries.back().count >= blockSize) {
+            if (!blocks.empty()) blocks.back().bits.shrink();
+            openBlock(time, value);
+            return;
+        }
+
+        Block& block = blocks.back();
+        SeriesBlockSummary& summary = summaries.back();
+
+        // Timestamp: delta of delta
+        const time_sec delta = time - summary.last;
+        const long long dod = (long long)(delta - block.prevDelta);
+        if (dod == 0) block.bits.write(0, 1);
+        else if (dod >= -63 && dod <= 64) {
+            block.bits.write(0b10, 2);
+            block.bits.write((uint64_t)(dod + 63), 7);
+        } else if (dod >= -255 && dod <= 256) {
+            block.bits.write(0b110, 3);
+            block.bits.write((uint64_t)(dod + 255), 9);
+        } else if (dod >= -2047 && dod <= 2048) {
+            block.bits.write(0b1110, 4);
+            block.bits.write((uint64_t)(dod + 2047), 12);
+        } else {
+            block.bits.write(0b1111, 4);
+            block.bits.write((uint64_t)dod, 64);
+        }
+        block.prevDelta = delta;
+
+        // Value: XOR with the previous one
+        const uint32_t valueBits = floatBits(value);
+        const uint32_t xored = valueBits ^ block.prevValueBits;
+        if (xored == 0) block.bits.write(0, 1);
+        else {
+            const int leading = countLeadingZeros(xored);
+            const int trailing = countTrailingZeros(xored);
+            if (block.prevLeading >= 0 && leading >= block.prevLeading && trailing >= block.prevTrailing) {
+                // Fits into the previous meaningful window
+                const int meaningful = 32 - block.prevLeading - block.prevTrailing;
+                block.bits.write(0b10, 2);
+                block.bits.write(xored >> block.prevTrailing, meaningful);
+            } else {
+                const int meaningful = 32 - leading - trailing;
+                block.bits.write(0b11, 2);
+                block.bits.write((uint64_t)leading, 5);
+                block.bits.write((uint64_t)(meaningful - 1), 5);
+                block.bits.write(xored >> trailing, meaningful);
+                block.prevLeading = leading;
+                block.prevTrailing = trailing;
+            }
+        }
+        block.prevValueBits = valueBits;
+
+        addToSummary(summary, time, value);
+    }
+
+    size_t size() const override { return count; }
+    size_t getBlockCount() const { return blocks.size(); }
+    size_t getBlockSize() const { return blockSize; }
+    const vector<SeriesBlockSummary>& getBlockSummaries() const { return summaries; }
+
+    // Approximate memory held by the compressed data and the summaries
+    size_t getCompressedBytes() const {
+        size_t bytes = summaries.size() * sizeof(SeriesBlockSummary);
+        for (const Block& block: blocks) bytes += sizeof(Block) + block.bits.getWords().size() * sizeof(uint64_t);
+        return bytes;
+    }
+
+    // Append the points of the nth block to the output
+    void decodeBlock(size_t n, vector<TimePoint>& points) const {
+        const Block& block = blocks.at(n);
+        const SeriesBlockSummary& summary = summaries.at(n);
+        CompressedBitReader reader(block.bits.getWords());
+
+        time_sec time = summary.first;
+        uint32_t valueBits = floatBits(summary.firstValue);
+        time_sec delta = 0;
+        int leading = 0;
+        int trailing = 0;
+        points.push_back(TimePoint(time, summary.firstValue));
+
+        for (size_t i = 1; i < summary.count; i++) {
+            long long dod;
+            if (!reader.readBit()) dod = 0;
+            else if (!reader.readBit()) dod = (long long)reader.read(7) - 63;
+            else if (!reader.readBit()) dod = (long long)reader.read(9) - 255;
+            else if (!reader.readBit()) dod = (long long)reader.read(12) - 2047;
+            else dod = (long long)reader.read(64);
+            delta += dod;
+            time += delta;
+
+            if (reader.readBit()) {
+                if (reader.readBit()) {
+                    leading = (int)reader.read(5);
+                    const int meaningful = (int)reader.read(5) + 1;
+                    trailing = 32 - leading - meaningful;
+                }
+                const int meaningful = 32 - leading - trailing;
+                valueBits ^= (uint32_t)reader.read(meaningful) << trailing;
+            }
+            points.push_back(TimePoint(time, bitsFloat(valueBits)));
+        }
+    }
+
+    bool empty() const override { return count == 0; }
+    time_sec getFirstTime() const override { return summaries.empty() ? 0 : summaries.front().first; }
+    time_sec getLastTime() const override { return summaries.empty() ? 0 : summaries.back().last; }
+
+    void getSummaries(time_sec first, time_sec last, vector<SeriesBlockSummary>& out) override {
+        out.clear();
+        for (size_t n = findSummaryIndex(summaries, first); n < summaries.size() && summaries[n].first <= last; n++)
+            out.push_back(summaries[n]);
+    }
+
+    void getPoints(time_sec first, time_sec last, vector<TimePoint>& out) override {
+        out.clear();
+        for (size_t n = findSummaryIndex(summaries, first); n < summaries.size() && summaries[n].first <= last; n++)
+            decodeBlock(n, out);
+    }
+
+protected:
+    struct Block {
+        CompressedBitWriter bits;
+        // Encoder state, needed only while the block is open
+        time_sec prevDelta = 0;
+        uint32_t prevValueBits = 0;
+        int prevLeading = -1;
+        int prevTrailing = 0;
+    };
+
+    void openBlock(time_sec time, float value) {
+        // First point is stored raw in the summary
+        Block block;
+        block.prevValueBits = floatBits(value);
+        blocks.push_back(block);
+
+        SeriesBlockSummary summary;
+        summary.first = time;
+        summary.last = time;
+        summary.firstValue = value;
+        summary.lastValue = value;
+        summary.minValue = numeric_limits<float>::infinity();
+        summary.maxValue = -numeric_limits<float>::infinity();
+        summary.count = 0;
+        addToSummary(summary, time, value);
+        summaries.push_back(summary);
+    }
+
+    void addToSummary(SeriesBlockSummary& summary, time_sec time, float value) {
+        summary.last = time;
+        summary.lastValue = value;
+        if (!isnan(value)) {
+            if (value < summary.minValue) summary.minValue = value;
+            if (value > summary.maxValue) summary.maxValue = value;
+        }
+        summary.count++;
+        count++;
+    }
+
+    static uint32_t floatBits(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static float bitsFloat(uint32_t bits) {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    static int countLeadingZeros(uint32_t value) {
+        int n = 0;
+        for (uint32_t bit = 1u << 31; bit && !(value & bit); bit >>= 1) n++;
+        return n;
+    }
+
+    static int countTrailingZeros(uint32_t value) {
+        int n = 0;
+        for (uint32_t bit = 1; bit && !(value & bit); bit <<= 1) n++;
+        return n;
+    }
+
+    size_t blockSize;
+    size_t count = 0;
+    vector<Block> blocks;
+    vector<SeriesBlockSummary> summaries;
+};
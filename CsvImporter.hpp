@@ -0,0 +1,347 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "../trading/CandleSeries.hpp"
+#include "TimePointSeries.hpp"
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+const size_t CSV_NO_COLUMN = (size_t)-1;
+
+// Read-only memory mapped file (POSIX)
+class CsvMappedFile {
+public:
+    CsvMappedFile(const string& filename) {
+        fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw ERROR("Unable to open file: " + filename);
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw ERROR("Unable to stat file: " + filename);
+        }
+        length = (size_t)st.st_size;
+        if (length == 0) return;
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw ERROR("Unable to map file: " + filename);
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        bytes = (const char*)mapped;
+    }
+
+    virtual ~CsvMappedFile() {
+        if (bytes) munmap((void*)bytes, length);
+        if (fd >= 0) close(fd);
+    }
+
+    CsvMappedFile(const CsvMappedFile&) = delete;
+    CsvMappedFile& operator=(const CsvMappedFile&) = delete;
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+protected:
+    int fd = -1;
+    const char* bytes = nullptr;
+    size_t length = 0;
+};
+
+// Imports time series from large CSV/text exports.
+// The file is memory mapped, split into chunks at line boundaries and the chunks
+// are parsed in parallel with from_chars, then appended in file order.
+// Lines that can not be parsed (e.g. the header, empty or broken lines) are skipped
+// and counted, a field has to be a number (or time) as a whole: "1.5x" is broken.
+// Quoted fields are not supported.
+class CsvImporter {
+public:
+    enum TimeFormat {
+        TIME_SECONDS,       // unix epoch seconds
+        TIME_MILLISECONDS,  // unix epoch milliseconds
+        TIME_MICROSECONDS,  // unix epoch microseconds
+        TIME_NANOSECONDS,   // unix epoch nanoseconds
+        TIME_DATETIME,      // "YYYY-MM-DD HH:MM:SS" or "YYYY-MM-DDTHH:MM:SS" in UTC, fractions are ignored
+    };
+
+    CsvImporter(
+        const string& filename,
+        char delimiter = ',',
+        bool hasHeader = true,
+        TimeFormat timeFormat = TIME_SECONDS,
+        size_t threads = 0 // 0 = hardware concurrency
+    ):
+        file(filename),
+        delimiter(delimiter),
+        hasHeader(hasHeader),
+        timeFormat(timeFormat),
+        threads(threads ? threads : max(1u, thread::hardware_concurrency()))
+    {}
+
+    virtual ~CsvImporter() {}
+
+    size_t getSkippedLines() const { return skippedLines; }
+
+    // Line number (1 based, in the file) of the first broken line, 0 if none
+    size_t getFirstSkippedLine() const { return firstSkippedLine; }
+
+    // Append (time, value) points from the given columns (0 based)
+    void importPoints(vector<TimePoint>& points, size_t timeColumn = 0, size_t valueColumn = 1) {
+        const size_t columns = max(timeColumn, valueColumn) + 1;
+        parse<TimePoint>(points, [&](const char** fields, const char** ends, vector<TimePoint>& out) {
+            time_sec time;
+            float value;
+            if (!parseTime(fields[timeColumn], ends[timeColumn], time)) return false;
+            if (!parseFloat(fields[valueColumn], ends[valueColumn], value)) return false;
+            out.push_back(TimePoint(time, value));
+            return true;
+        }, columns);
+    }
+
+    void importPoints(TimePointSeries& series, size_t timeColumn = 0, size_t valueColumn = 1) {
+        importPoints(series.getPointsRef(), timeColumn, valueColumn);
+    }
+
+    // Append candles from the given columns (0 based), volume is optional (CSV_NO_COLUMN)
+    void importCandles(
+        vector<Candle>& candles,
+        size_t timeColumn = 0,
+        size_t openColumn = 1,
+        size_t highColumn = 2,
+        size_t lowColumn = 3,
+        size_t closeColumn = 4,
+        size_t volumeColumn = 5
+    ) {
+        size_t columns = max({ timeColumn, openColumn, highColumn, lowColumn, closeColumn }) + 1;
+        if (volumeColumn != CSV_NO_COLUMN && volumeColumn + 1 > columns) columns = volumeColumn + 1;
+        parse<Candle>(candles, [&](const char** fields, const char** ends, vector<Candle>& out) {
+            time_sec time;
+            float open, high, low, close, volume = 0;
+            if (!parseTime(fields[timeColumn], ends[timeColumn], time)) return false;
+            if (!parseFloat(fields[openColumn], ends[openColumn], open)) return false;
+            if (!parseFloat(fields[highColumn], ends[highColumn], high)) return false;
+            if (!parseFloat(fields[lowColumn], ends[lowColumn], low)) return false;
+            if (!parseFloat(fields[closeColumn], ends[closeColumn], close)) return false;
+            if (volumeColumn != CSV_NO_COLUMN && !parseFloat(fields[volumeColumn], ends[volumeColumn], volume)) return false;
+            out.push_back(Candle(time, open, high, low, close, volume));
+            return true;
+        }, columns);
+    }
+
+    void importCandles(
+        CandleSeries& series,
+        size_t timeColumn = 0,
+        size_t openColumn = 1,
+        size_t highColumn = 2,
+        size_t lowColumn = 3,
+        size_t closeColumn = 4,
+        size_t volumeColumn = 5
+    ) {
+        importCandles(
+            series.getCandlesRef(),
+            timeColumn, openColumn, highColumn, lowColumn, closeColumn, volumeColumn
+        );
+    }
+
+    // Days since 1970-01-01 of a proleptic Gregorian date (Howard Hinnant's algorithm)
+    static long long daysFromCivil(long long y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        const long long era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = (unsigned)(y - era * 400);
+        const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + (long long)doe - 719468;
+    }
+
+protected:
+    static constexpr size_t maxColumns = 64;
+    static constexpr size_t minChunkSize = 1 << 20; // don't bother threads for small files
+
+    typedef const char* FieldPtr;
+
+    template<typename T, typename ParseLine>
+    void parse(vector<T>& out, ParseLine parseLine, size_t columns) {
+        if (columns > maxColumns) throw ERROR("Too many CSV columns");
+        skippedLines = 0;
+        firstSkippedLine = 0;
+        const char* begin = file.data();
+        const char* end = begin + file.size();
+        if (!begin) return;
+
+        if (hasHeader) begin = nextLine(begin, end);
+
+        // Split to chunks at line boundaries
+        const size_t size = end - begin;
+        size_t chunks = min(threads, size / minChunkSize + 1);
+        vector<const char*> bounds = { begin };
+        for (size_t n = 1; n < chunks; n++) {
+            const char* bound = nextLine(begin + size * n / chunks, end);
+            if (bound > bounds.back()) bounds.push_back(bound);
+        }
+        bounds.push_back(end);
+        chunks = bounds.size() - 1;
+
+        // Parse chunks in parallel
+        vector<vector<T>> results(chunks);
+        vector<size_t> lineCounts(chunks, 0);
+        vector<size_t> firstSkipped(chunks, 0); // line in the chunk, 1 based
+        atomic<size_t> skipped{0};
+        auto parseChunk = [&](size_t chunk) {
+            const char* line = bounds[chunk];
+            const char* stop = bounds[chunk + 1];
+            vector<T>& result = results[chunk];
+            result.reserve((stop - line) / 32); // rough guess of the line count
+            FieldPtr fields[maxColumns];
+            FieldPtr ends[maxColumns];
+            size_t skippedHere = 0;
+            size_t lineCount = 0;
+            while (line < stop) {
+                const char* lineEnd = (const char*)memchr(line, '\n', stop - line);
+                if (!lineEnd) lineEnd = stop;
+                const char* contentEnd = lineEnd;
+                if (contentEnd > line && contentEnd[-1] == '\r') contentEnd--;
+                lineCount++;
+                if (contentEnd > line) {
+                    if (
+                        splitFields(line, contentEnd, fields, ends, columns) < columns ||
+                        !parseLine(fields, ends, result)
+                    ) {
+                        if (!skippedHere) firstSkipped[chunk] = lineCount;
+                        skippedHere++;
+                    }
+                }
+                line = lineEnd + 1;
+            }
+            lineCounts[chunk] = lineCount;
+            skipped += skippedHere;
+        };
+        if (chunks == 1) parseChunk(0);
+        else {
+            vector<thread> workers;
+            for (size_t chunk = 0; chunk < chunks; chunk++)
+                workers.push_back(thread(parseChunk, chunk));
+            for (thread& worker: workers) worker.join();
+        }
+        skippedLines = skipped;
+        size_t lineOffset = hasHeader ? 1 : 0;
+        for (size_t chunk = 0; chunk < chunks && !firstSkippedLine; chunk++) {
+            if (firstSkipped[chunk]) firstSkippedLine = lineOffset + firstSkipped[chunk];
+            lineOffset += lineCounts[chunk];
+        }
+
+        // Append in file order
+        size_t total = out.size();
+        for (const vector<T>& result: results) total += result.size();
+        out.reserve(total);
+        for (vector<T>& result: results) {
+            out.insert(out.end(), result.begin(), result.end());
+            vector<T>().swap(result); // release early, the results can be big
+        }
+    }
+
+    const char* nextLine(const char* from, const char* end) const {
+        const char* newline = (const char*)memchr(from, '\n', end - from);
+        return newline ? newline + 1 : end;
+    }
+
+    size_t splitFields(const char* line, const char* end, FieldPtr* fields, FieldPtr* ends, size_t columns) const {
+        size_t count = 0;
+        const char* field = line;
+        while (count < columns) {
+            const char* next = (const char*)memchr(field, delimiter, end - field);
+            fields[count] = field;
+            ends[count] = next ? next : end;
+            count++;
+            if (!next) break;
+            field = next + 1;
+        }
+        return count;
+    }
+
+    static const char* skipSpaces(const char* from, const char* end) {
+        while (from < end && (*from == ' ' || *from == '\t')) from++;
+        return from;
+    }
+
+    static bool parseFloat(const char* from, const char* end, float& value) {
+        from = skipSpaces(from, end);
+        if (from < end && *from == '+') from++;
+        from_chars_result result = from_chars(from, end, value);
+        return result.ec == errc() && isFieldEnd(result.ptr, end);
+    }
+
+    // The whole field has to be the number, unless the rest is parsed from next on
+    static bool parseInt(const char* from, const char* end, long long& value, const char** next = nullptr) {
+        from_chars_result result = from_chars(from, end, value);
+        if (result.ec != errc()) return false;
+        if (next) *next = result.ptr;
+        return next || isFieldEnd(result.ptr, end);
+    }
+
+    // Only trailing spaces are left in the field
+    static bool isFieldEnd(const char* from, const char* end) {
+        return skipSpaces(from, end) == end;
+    }
+
+    bool parseTime(const char* from, const char* end, time_sec& time) const {
+        from = skipSpaces(from, end);
+        long long value;
+        switch (timeFormat) {
+            case TIME_SECONDS:
+                if (!parseInt(from, end, value)) return false;
+                time = value;
+                return true;
+            case TIME_MILLISECONDS:
+                if (!parseInt(from, end, value)) return false;
+                time = value / 1000;
+                return true;
+            case TIME_MICROSECONDS:
+                if (!parseInt(from, end, value)) return false;
+                time = value / 1000000;
+                return true;
+            case TIME_NANOSECONDS:
+                if (!parseInt(from, end, value)) return false;
+                time = value / 1000000000;
+                return true;
+            case TIME_DATETIME:
+                return parseDateTime(from, end, time);
+        }
+        return false;
+    }
+
+    static bool parseDateTime(const char* from, const char* end, time_sec& time) {
+        long long year, month, day, hour = 0, minute = 0, second = 0;
+        const char* p;
+        if (!parseInt(from, end, year, &p) || p >= end || *p != '-') return false;
+        if (!parseInt(p + 1, end, month, &p) || p >= end || *p != '-') return false;
+        if (!parseInt(p + 1, end, day, &p)) return false;
+        if (p < end && (*p == ' ' || *p == 'T')) {
+            if (!parseInt(p + 1, end, hour, &p) || p >= end || *p != ':') return false;
+            if (!parseInt(p + 1, end, minute, &p)) return false;
+            if (p < end && *p == ':' && !parseInt(p + 1, end, second, &p)) return false;
+            if (p < end && *p == '.') do p++; while (p < end && *p >= '0' && *p <= '9');
+            if (p < end && *p == 'Z') p++;
+        }
+        if (!isFieldEnd(p, end)) return false;
+        if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+        time = daysFromCivil(year, (unsigned)month, (unsigned)day) * 86400 + hour * 3600 + minute * 60 + second;
+        return true;
+    }
+
+    CsvMappedFile file;
+    char delimiter;
+    bool hasHeader;
+    TimeFormat timeFormat;
+    size_t threads;
+    size_t skippedLines = 0;
+    size_t firstSkippedLine = 0;
+};
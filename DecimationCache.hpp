@@ -0,0 +1,131 @@
+#pragma once
+
+#include "TimePoint.hpp"
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+using namespace std;
+
+// What the decimated vertices of a series depend on: the series (its identity
+// and version, the size and the last point of the range as a guard against
+// unversioned appends and tick updates), the range drawn and the seconds per
+// pixel (the data range over the inner width). Nothing of the Y axis: the
+// vertices are times and values, each chart projects them on its own.
+struct DecimationKey {
+    size_t seriesId;
+    size_t version;
+    size_t size;
+    size_t from;
+    size_t to;
+    time_sec lastTime;
+    float lastValue;
+    time_sec valueFirst;
+    time_sec valueLast;
+    int width;
+    bool bars;
+
+    bool operator==(const DecimationKey& other) const {
+        return
+            seriesId == other.seriesId &&
+            version == other.version &&
+            size == other.size &&
+            from == other.from &&
+            to == other.to &&
+            lastTime == other.lastTime &&
+            (lastValue == other.lastValue || (lastValue != lastValue && other.lastValue != other.lastValue)) &&
+            valueFirst == other.valueFirst &&
+            valueLast == other.valueLast &&
+            width == other.width &&
+            bars == other.bars;
+    }
+};
+
+struct DecimationKeyHash {
+    size_t operator()(const DecimationKey& key) const {
+        size_t hash = key.seriesId;
+        const auto mix = [&hash](size_t value) { hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2); };
+        mix(key.version);
+        mix(key.size);
+        mix(key.from);
+        mix(key.to);
+        mix((size_t)key.lastTime);
+        mix((size_t)key.valueFirst);
+        mix((size_t)key.valueLast);
+        mix((size_t)key.width);
+        mix(key.bars);
+        return hash;
+    }
+};
+
+// Decimated vertices of point and bar series, shared by the charts of a
+// ChartGroup: synchronized charts showing the same series (e.g. the price line
+// overlaid in each indicator chart) cull and decimate it once per view.
+// Least recently used entries are dropped above maxEntries. Thread safe, the
+// charts may render on RenderPool workers.
+class DecimationCache {
+public:
+    typedef shared_ptr<const vector<TimePoint>> Vertices;
+
+    DecimationCache(size_t maxEntries = 256): maxEntries(maxEntries) {}
+    virtual ~DecimationCache() {}
+
+    // The vertices cached for the key, nullptr if there are none
+    Vertices find(const DecimationKey& key) {
+        lock_guard<mutex> lock(cacheMutex);
+        unordered_map<DecimationKey, Entry, DecimationKeyHash>::iterator found = entries.find(key);
+        if (found == entries.end()) {
+            misses++;
+            return nullptr;
+        }
+        lru.splice(lru.begin(), lru, found->second.lru);
+        hits++;
+        return found->second.vertices;
+    }
+
+    void store(const DecimationKey& key, Vertices vertices) {
+        lock_guard<mutex> lock(cacheMutex);
+        unordered_map<DecimationKey, Entry, DecimationKeyHash>::iterator found = entries.find(key);
+        if (found != entries.end()) {
+            found->second.vertices = vertices;
+            lru.splice(lru.begin(), lru, found->second.lru);
+            return;
+        }
+        lru.push_front(key);
+        entries[key] = { vertices, lru.begin() };
+        while (entries.size() > maxEntries) {
+            entries.erase(lru.back());
+            lru.pop_back();
+        }
+    }
+
+    void clear() {
+        lock_guard<mutex> lock(cacheMutex);
+        entries.clear();
+        lru.clear();
+    }
+
+    size_t size() const {
+        lock_guard<mutex> lock(cacheMutex);
+        return entries.size();
+    }
+
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+
+protected:
+    struct Entry {
+        Vertices vertices;
+        list<DecimationKey>::iterator lru;
+    };
+
+    size_t maxEntries;
+    mutable mutex cacheMutex;
+    unordered_map<DecimationKey, Entry, DecimationKeyHash> entries;
+    list<DecimationKey> lru;
+    atomic<size_t> hits{0};
+    atomic<size_t> misses{0};
+};
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "Fl_ImageChartBox.hpp"
+#include <FL/Fl_Group.H>
+
+// Chart box rendering its frames off the UI thread. Each change of the view,
+// the size or the data is a new generation; the frame of a generation is drawn
+// by an offscreen Fl_ImageChartBox on the render pool, and draw() only blits the
+// newest finished image. The UI thread never fits nor draws the chart, so the
+// wheel and drag input stay responsive however heavy the chart is.
+// One frame renders at a time: a frame superseded while rendering stops at the
+// next pane and is dropped, then the newest generation is rendered.
+// The serieses are copied to the renderer when they change, but the patches of
+// patch*Series() are replayed on its copies instead (the windowed serieses and
+// indicators are shared with it, and used from its thread only: patches of their
+// sources reach the indicators when no frame is in flight).
+// Lazy indicators read their source from this chart box, don't add them here.
+// Candle field serieses are fine: the renderer gets its own, reading its copy of
+// the candles (see Fl_ChartBox::copySerieses). Other adapted serieses are shared
+// and must not read data this chart box changes.
+class Fl_AsyncChartBox: public Fl_ChartBox {
+public:
+    Fl_AsyncChartBox(
+        int X, int Y, int W, int H,
+        int spacingTop = CHART_SPACING_TOP,
+        int spacingBottom = CHART_SPACING_BOTTOM,
+        int spacingLeft = CHART_SPACING_LEFT,
+        int spacingRight = CHART_SPACING_RIGHT,
+        RenderPool& pool = RenderPool::getInstance()
+    ):
+        Fl_ChartBox(X, Y, W, H, spacingTop, spacingBottom, spacingLeft, spacingRight),
+        pool(pool)
+    {}
+
+    virtual ~Fl_AsyncChartBox() {
+        // The frame in flight keeps its renderer, its result is ignored
+        *latestGeneration = 0;
+        alive.reset();
+    }
+
+    void setBackground(unsigned int background) { this->background = background; }
+
+    // Generation requested last, and the one of the image shown
+    size_t getGeneration() const { return generation; }
+    size_t getShownGeneration() const { return shownGeneration; }
+    bool isRendering() const { return rendering; }
+    size_t getRenderedFrames() const { return renderedFrames; }
+    size_t getDroppedFrames() const { return droppedFrames; }
+    size_t getSeriesCopies() const { return seriesCopies; } // full copies to the renderer
+
+    // The newest finished frame (empty until the first one)
+    const ImageCanvas& getShownImage() const { return shown; }
+
+    // Frames render on their own, there is nothing to prepare
+    shared_ptr<RenderJob> prepareAsync(RenderPool& pool, RenderPriority priority = RENDER_PRIORITY_VISIBLE) override {
+        (void)pool;
+        (void)priority;
+        return nullptr;
+    }
+
+    // The whole frame is rendered again (off the UI thread)
+    void redrawTail(time_sec from) override {
+        (void)from;
+        redraw();
+    }
+
+    // Patched here, then replayed on the copy of the renderer before its next frame
+    void patchCandleSeries(size_t pane, size_t index, const SeriesPatch<Candle>& patch) override {
+        const bool replayable = isReplayable();
+        Fl_ChartBox::patchCandleSeries(pane, index, patch);
+        forwardPatch(replayable, { pane, index, true, false, patch, {} });
+    }
+
+    void patchBarSeries(size_t pane, size_t index, const SeriesPatch<TimePoint>& patch) override {
+        const bool replayable = isReplayable();
+        Fl_ChartBox::patchBarSeries(pane, index, patch);
+        forwardPatch(replayable, { pane, index, false, true, {}, patch });
+    }
+
+    void patchPointSeries(size_t pane, size_t index, const SeriesPatch<TimePoint>& patch) override {
+        const bool replayable = isReplayable();
+        Fl_ChartBox::patchPointSeries(pane, index, patch);
+        forwardPatch(replayable, { pane, index, false, false, {}, patch });
+    }
+
+    // Start rendering a new generation if the view, the size or the data changed
+    // since the last request (draw() calls it)
+    void requestFrame() {
+        updateTimeAxis();
+        const PrepareKey key = getPrepareKey();
+        if (requested && key == requestedKey) return;
+        requested = true;
+        requestedKey = key;
+        *latestGeneration = ++generation;
+        if (!rendering) submitFrame(); // else it is rendered when the one in flight is done
+    }
+
+    // LCOV_EXCL_START
+    // Coverage excluded - draw() requires GUI display environment
+    void draw() override {
+        requestFrame();
+        const int width = min(w(), shown.width());
+        const int height = min(h(), shown.height());
+        if (width < w() || height < h()) Fl_CanvasBox::draw(); // no frame yet, or resized
+        if (width > 0 && height > 0) fl_draw_image(shown.getData(), x(), y(), width, height, 3, shown.width() * 3);
+    }
+    // LCOV_EXCL_STOP
+
+protected:
+    // A patch of a series, for the copy of the renderer
+    struct SeriesPatchRecord {
+        size_t pane;
+        size_t index;
+        bool candles;
+        bool bars;
+        SeriesPatch<Candle> candlesPatch;
+        SeriesPatch<TimePoint> pointsPatch;
+    };
+
+    // The offscreen chart box, replays the patches on its copies of the serieses only
+    // (the indicators are shared, this chart box patches them)
+    class Renderer: public Fl_ImageChartBox {
+    public:
+        using Fl_ImageChartBox::Fl_ImageChartBox;
+
+        void replay(const SeriesPatchRecord& patch) {
+            if (patch.candles) patch.candlesPatch.apply(candlesSerieses.at(patch.pane).at(patch.index).getCandlesRef());
+            else {
+                vector<vector<TimePointSeries>>& serieses = patch.bars ? barsSerieses : pointsSerieses;
+                patch.pointsPatch.apply(serieses.at(patch.pane).at(patch.index).getPointsRef());
+            }
+            touchPane(patch.pane);
+        }
+    };
+
+    // Only the data counts, the view and the size don't reach the copies
+    static bool isSameData(const PrepareKey& key, const PrepareKey& other) {
+        return 
+            key.contentVersion == other.contentVersion &&
+            key.dataVersion == other.dataVersion &&
+            key.dataSize == other.dataSize;
+    }
+
+    // The copies of the renderer and the patches queued for it give the serieses of now
+    bool isReplayable() const {
+        return synced && isSameData(getPrepareKey(), replayedKey);
+    }
+
+    // Queue the patch for the renderer, or give up on replaying until the next full copy
+    void forwardPatch(bool replayable, const SeriesPatchRecord& patch) {
+        if (!replayable) {
+            seriesPatches.clear();
+            return;
+        }
+        seriesPatches.push_back(patch);
+        replayedKey = getPrepareKey();
+    }
+
+    // Bring the renderer up to date (it is idle) and render the current generation on the pool
+    void submitFrame() {
+        if (!renderer) {
+            Fl_Group* current = Fl_Group::current();
+            Fl_Group::current(nullptr); // never shown, don't let it join a group
+            renderer = make_shared<Renderer>(
+                w(), h(),
+                chart.getSpacingTop(), chart.getSpacingBottom(),
+                chart.getSpacingLeft(), chart.getSpacingRight()
+            );
+            Fl_Group::current(current);
+        }
+        renderer->getImage().setBackground(background);
+
+        // Replay the patches if nothing else changed since the copy, copy all the serieses
+        // if anything did (dataVersion: changed in place)
+        const PrepareKey key = getPrepareKey();
+        if (synced && isSameData(key, replayedKey)) {
+            for (const SeriesPatchRecord& patch: seriesPatches) renderer->replay(patch);
+        } else if (!synced || !isSameData(key, syncedKey)) {
+            renderer->copySerieses(*this);
+            seriesCopies++;
+        }
+        seriesPatches.clear();
+        shared_ptr<TradingTimeAxis> timeAxis = chart.getTimeAxis();
+        if (!synced || timeAxis != syncedTimeAxis || key.timeAxisSize != syncedKey.timeAxisSize)
+            renderer->getChart().setTimeAxis(timeAxis ? make_shared<TradingTimeAxis>(*timeAxis) : nullptr);
+        synced = true;
+        syncedKey = key;
+        replayedKey = key;
+        syncedTimeAxis = timeAxis;
+
+        renderer->size(w(), h());
+        renderer->getChart().setBounds(chart.getBounds());
+        renderer->getChart().setDecimationCache(chart.getDecimationCache()); // of the group, thread safe
+
+        rendering = true;
+        shared_ptr<Renderer> renderer = this->renderer;
+        shared_ptr<atomic<size_t>> latest = latestGeneration;
+        weak_ptr<bool> living = alive;
+        const size_t frameGeneration = generation;
+        Post post = this->post;
+        pool.submit([this, renderer, latest, living, frameGeneration, post](const RenderJob&) {
+            const bool complete = renderer->render([latest, frameGeneration]() { return *latest != frameGeneration; });
+            post([this, living, frameGeneration, complete]() {
+                if (living.expired()) return;
+                onFrameDone(frameGeneration, complete);
+            });
+        }, Fl::focus() == this ? RENDER_PRIORITY_FOCUSED : RENDER_PRIORITY_VISIBLE);
+    }
+
+    // The renderer may be updating the indicator, patch it before the next frame then
+    void patchIndicator(const shared_ptr<Indicator>& indicator, size_t droppedHead, time_sec firstTime, size_t from) override {
+        if (rendering) indicatorPatches.push_back({ indicator, droppedHead, firstTime, from });
+        else Fl_ChartBox::patchIndicator(indicator, droppedHead, firstTime, from);
+    }
+
+    void applyIndicatorPatches() {
+        for (const IndicatorPatch& patch: indicatorPatches)
+            Fl_ChartBox::patchIndicator(patch.indicator, patch.droppedHead, patch.firstTime, patch.from);
+        indicatorPatches.clear();
+    }
+
+    // On the UI thread, the renderer is idle again
+    void onFrameDone(size_t frameGeneration, bool complete) {
+        rendering = false;
+        applyIndicatorPatches();
+        if (complete && frameGeneration > shownGeneration) {
+            shown.swap(renderer->getImage());
+            shownGeneration = frameGeneration;
+            renderedFrames++;
+            adoptBounds(frameGeneration);
+            redraw();
+        } else {
+            droppedFrames++;
+        }
+        if (generation != frameGeneration) submitFrame(); // superseded meanwhile
+    }
+
+    // Take the data range (and the initial view) fitted by the renderer,
+    // the scroll and zoom of the UI thread work on them
+    void adoptBounds(size_t frameGeneration) {
+        ChartBounds bounds = renderer->getChart().getBounds();
+        if (chart.isViewInitialized()) {
+            bounds.viewInitialized = true;
+            bounds.viewFirst = chart.getViewFirst();
+            bounds.viewLast = chart.getViewLast();
+        }
+        chart.setBounds(bounds);
+        if (frameGeneration == generation) requestedKey = getPrepareKey(); // the frame shows this view already
+    }
+
+    struct IndicatorPatch {
+        shared_ptr<Indicator> indicator;
+        size_t droppedHead;
+        time_sec firstTime;
+        size_t from;
+    };
+
+    RenderPool& pool;
+    unsigned int background = 0x000000;
+    shared_ptr<Renderer> renderer = nullptr;
+    ImageCanvas shown;
+    size_t generation = 0;
+    size_t shownGeneration = 0;
+    shared_ptr<atomic<size_t>> latestGeneration = make_shared<atomic<size_t>>(0);
+    shared_ptr<bool> alive = make_shared<bool>(true);
+    bool rendering = false;
+    bool requested = false;
+    PrepareKey requestedKey = {};
+    bool synced = false;
+    PrepareKey syncedKey = {};
+    PrepareKey replayedKey = {}; // of the serieses once the queued patches are replayed
+    vector<SeriesPatchRecord> seriesPatches;
+    size_t seriesCopies = 0;
+    shared_ptr<TradingTimeAxis> syncedTimeAxis = nullptr;
+    size_t renderedFrames = 0;
+    size_t droppedFrames = 0;
+    vector<IndicatorPatch> indicatorPatches;
+};
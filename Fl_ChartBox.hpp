@@ -1,13 +1,30 @@
 #pragma once
 
+#include "../misc/ERROR.hpp"
 #include "../misc/Fl_CanvasBox.hpp"
+#include <FL/fl_draw.H>
 #include "../trading/CandleSeries.hpp"
 #include "TimePointSeries.hpp"
+#include "WindowedPointSeries.hpp"
+#include "Indicators.hpp"
+#include "LazyIndicatorSeries.hpp"
+#include "PointSeriesAdapter.hpp"
 #include "ChartGroup.hpp"
+#include "AsyncSeriesLoad.hpp"
+#include "RenderPool.hpp"
+#include "SubCanvas.hpp"
+#include "InteractionRecorder.hpp"
+#include "SeriesPatch.hpp"
+#include <FL/Fl.H>
 
-// Fl_ChartBox will contain a Chart object and handle its drawing
+// Fl_ChartBox will contain a Chart object and handle its drawing.
+// The panes are stacked top down, each with its share of the height (see
+// setPaneRatio) and its own Y scale, all of them on the same X projection.
+// The chart draws one pane at a time on the rectangle of that pane.
 class Fl_ChartBox: public Fl_CanvasBox {
 public:
+    typedef function<void(function<void()> task)> Post;
+
     Fl_ChartBox(
         int X, int Y, int W, int H,
         int spacingTop = CHART_SPACING_TOP,
@@ -16,8 +33,9 @@ public:
         int spacingRight = CHART_SPACING_RIGHT
     ):
         Fl_CanvasBox(X, Y, W, H),
+        paneCanvas(*static_cast<Canvas*>(this), 0, 0, W, H), // Itself, shifted to the selected pane
         chart(
-            *static_cast<Canvas*>(this), // Pass itself as Canvas reference
+            paneCanvas,
             spacingTop,
             spacingBottom,
             spacingLeft,
@@ -30,12 +48,7 @@ public:
         scroll = [this](int left, int top, int dx, int dy, int button) {
             // LCOV_EXCL_START
             // Coverage excluded - requires actual FLTK mouse wheel event
-            (void)top;
-            (void)dx;
-            (void)button;
-            if (dy != 0) {
-                onMouseWheel(left, dy);
-            }
+            handleInteraction({ INTERACTION_WHEEL, 0, 0, left, top, dx, dy, button });
             // LCOV_EXCL_STOP
         };
         
@@ -43,12 +56,7 @@ public:
         drag = [this](int left, int top, int button) {
             // LCOV_EXCL_START
             // Coverage excluded - requires actual FLTK drag event
-            (void)top;
-            (void)button;
-            if (lastDragX != 0) {
-                onDrag(left, left - lastDragX);
-            }
-            lastDragX = left;
+            handleInteraction({ INTERACTION_DRAG, 0, 0, left, top, 0, 0, button });
             // LCOV_EXCL_STOP
         };
         
@@ -56,135 +64,606 @@ public:
         push = [this](int left, int top, int button) {
             // LCOV_EXCL_START
             // Coverage excluded - requires actual FLTK push event
-            (void)top;
-            (void)button;
-            lastDragX = left;
+            handleInteraction({ INTERACTION_PUSH, 0, 0, left, top, 0, 0, button });
             // LCOV_EXCL_STOP
         };
     }
 
-    virtual ~Fl_ChartBox() {}
+    virtual ~Fl_ChartBox() {
+        settlePrepare(); // the job points to this
+        // Pending flushes hold the loads, not the chart, cancelled ones won't touch it anymore.
+        // The loaders post through their own copy of post, their workers are joined here.
+        for (vector<shared_ptr<AsyncSeriesLoadBase>>* loads: { &candlesLoads, &barsLoads, &pointsLoads }) {
+            cancelLoads(*loads);
+            for (shared_ptr<AsyncSeriesLoadBase>& load: *loads) load->join();
+        }
+    }
 
     void setChartGroup(ChartGroup* group) { this->group = group; }
+
+    // Runs a task on the UI thread (Fl::awake by default): the flushes of the loads, and
+    // the finished frames of Fl_AsyncChartBox. A load keeps the one set when it started.
+    void setPost(Post post) { this->post = post; }
+
+    // Record the input events of this box as the given chart of the screen
+    // (nullptr to stop), see InteractionReplayer
+    void setInteractionRecorder(InteractionRecorder* recorder, size_t chartIndex = 0) {
+        this->recorder = recorder;
+        recorderChart = chartIndex;
+    }
+
+    // Handle a wheel, drag or push event, as the mouse callbacks do (replays call it too)
+    void handleInteraction(const InteractionEvent& event) {
+        if (recorder) recorder->record(event, recorderChart);
+        switch (event.kind) {
+            case INTERACTION_WHEEL:
+                if (event.dy != 0) onMouseWheel(event.x, event.dy);
+                break;
+            case INTERACTION_DRAG:
+                if (lastDragX != 0) onDrag(event.x, event.x - lastDragX);
+                lastDragX = event.x;
+                break;
+            case INTERACTION_PUSH:
+                lastDragX = event.x;
+                break;
+        }
+    }
     Chart& getChart() { return chart; }
 
+    void resize(int X, int Y, int W, int H) override {
+        Fl_CanvasBox::resize(X, Y, W, H);
+        selectPane(selectedPane);
+    }
+
+    // Height of a pane relative to the other panes (1 by default),
+    // e.g. 3 for the price and 1 for the volume under it
+    void setPaneRatio(size_t pane, double ratio) {
+        if (!(ratio > 0)) throw ERROR("Invalid pane ratio");
+        changed();
+        while (paneRatios.size() < pane + 1) paneRatios.push_back(1);
+        paneRatios[pane] = ratio;
+        redraw();
+    }
+
+    double getPaneRatio(size_t pane) const {
+        return paneRatios.size() > pane ? paneRatios[pane] : 1;
+    }
+
+    // Rows of the box a pane is drawn in (the spacing at the top and the
+    // bottom of the box goes to the first and the last pane)
+    void getPaneRegion(size_t pane, int& top, int& height) const {
+        int canvasTop, canvasHeight;
+        getPaneLayout(pane, canvasTop, canvasHeight, top, height);
+    }
+
+    // Repaint one pane only, e.g. the one whose serieses changed
+    // (the other panes keep their pixels and their fit)
+    void redrawPane(size_t pane) {
+        settlePrepare();
+        if (paneCaches.size() > pane) paneCaches[pane].valid = false;
+        if (paneDirty.size() < pane + 1) paneDirty.resize(pane + 1, false);
+        paneDirty[pane] = true;
+        int top, height;
+        getPaneRegion(pane, top, height);
+        damage(FL_DAMAGE_USER2, x(), y() + top, w(), height);
+    }
+
+    // Trading time axis, the candle times of the chart are added to it on each draw,
+    // bars and points are projected onto them (set it on the ChartGroup instead to
+    // share it between charts)
+    void setTimeAxis(shared_ptr<TradingTimeAxis> timeAxis) {
+        changed();
+        chart.setTimeAxis(timeAxis);
+    }
+
+    // Add the new candle times of all panes to the trading time axis (if any).
+    // The axis may be shared by the charts of a group, so preparing charts in
+    // parallel needs this done for each chart before any is submitted.
+    void updateTimeAxis() {
+        shared_ptr<TradingTimeAxis> timeAxis = chart.getTimeAxis();
+        if (!timeAxis) return;
+        for (const vector<CandleSeries>& candlesPane: candlesSerieses)
+            for (const CandleSeries& candleSeries: candlesPane)
+                timeAxis->addTimes(candleSeries.getCandlesCRef());
+    }
+
+    // Fit all panes on a RenderPool worker ahead of draw(). draw() waits for the
+    // job and uses its result as long as the view, the size and the serieses are
+    // unchanged (it fits again otherwise). A previous job is cancelled first, so
+    // a view that changed again doesn't wait for the stale one.
+    // The serieses and indicators of the chart must not be shared with another
+    // chart prepared at the same time, and the chart must not be changed from the
+    // outside (e.g. by its ChartGroup) before waitPrepared().
+    virtual shared_ptr<RenderJob> prepareAsync(RenderPool& pool, RenderPriority priority = RENDER_PRIORITY_VISIBLE) {
+        settlePrepare();
+        updateTimeAxis();
+        preparePool = &pool;
+        prepareJob = pool.submit([this](const RenderJob& job) { prepare(&job); }, priority);
+        return prepareJob;
+    }
+
+    // Wait for the job of prepareAsync() (helping the pool meanwhile)
+    void waitPrepared() {
+        if (!prepareJob) return;
+        shared_ptr<RenderJob> job = prepareJob;
+        prepareJob = nullptr;
+        preparePool->wait(job);
+    }
+
+    // The prepared fit is still valid for the next draw()
+    bool isPrepared() const {
+        return preparedValid && preparedBounds.size() == getPaneCount() && getPrepareKey() == preparedKey;
+    }
+
+    // Per phase timings and counters of each drawn frame, off by default.
+    // Disabled, the instrumented draw pays a null check per phase and series.
+    void setStatsEnabled(bool statsEnabled) {
+        this->statsEnabled = statsEnabled;
+        if (!statsEnabled) {
+            chart.setCounters(nullptr);
+            statsFrameActive = false;
+        }
+        frameStats = ChartFrameStats();
+    }
+    bool isStatsEnabled() const { return statsEnabled; }
+
+    // Stats of the last frame drawn while enabled (e.g. for an overlay or a regression check)
+    const ChartFrameStats& getLastFrameStats() const { return frameStats; }
+
+    // Called after each frame drawn while the stats are enabled
+    function<void(const ChartFrameStats&)> onFrameStats = nullptr;
+
     void clearAllSerieses() {
         clearCandlesSerieses();
         clearBarsSerieses();
         clearPointsSerieses();
+        clearWindowedSerieses();
+        clearAdaptedSerieses();
+        clearIndicators();
+    }
+
+    // Back to an empty chart box that keeps its view only (e.g. recycled by UI_MultiChart
+    // for another chart): the serieses, the pane ratios, the time axis and the
+    // interaction recorder are dropped
+    void recycle() {
+        clearAllSerieses();
+        paneRatios.clear();
+        setTimeAxis(nullptr);
+        setInteractionRecorder(nullptr);
+        redraw();
+    }
+
+    // Take over the serieses, windowed serieses and indicators of another chart box
+    // (e.g. into an offscreen one rendering its frames), the shared ones are shared.
+    // The candle field serieses are bound to the candles of this chart box instead.
+    void copySerieses(const Fl_ChartBox& other) {
+        changed();
+        candlesSerieses = other.candlesSerieses;
+        barsSerieses = other.barsSerieses;
+        pointsSerieses = other.pointsSerieses;
+        windowedSerieses = other.windowedSerieses;
+        windowedFrames.resize(windowedSerieses.size());
+        for (size_t pane = 0; pane < windowedSerieses.size(); pane++)
+            windowedFrames[pane].resize(windowedSerieses[pane].size());
+        adaptedSerieses = other.adaptedSerieses;
+        candleFields.clear();
+        for (const CandleFieldBinding& binding: other.candleFields) {
+            CandleFieldBinding rebound = binding;
+            rebound.series = makeCandleField(binding);
+            for (shared_ptr<PointSeriesAdapter>& adaptedSeries: adaptedSerieses[binding.pane])
+                if (adaptedSeries == binding.series) adaptedSeries = rebound.series;
+            candleFields.push_back(rebound);
+        }
+        indicators = other.indicators;
+        lazyIndicators = other.lazyIndicators;
     }
 
     void clearCandlesSerieses() {
+        changed();
+        cancelLoads(candlesLoads);
         candlesSerieses.clear();
     }
 
     void addCandleSeries(const CandleSeries& candleSeries, size_t pane = 0) {
+        changed();
         while (candlesSerieses.size() < pane + 1) candlesSerieses.push_back({});
         candlesSerieses[pane].push_back(candleSeries);
     }
 
     void clearBarsSerieses() {
+        changed();
+        cancelLoads(barsLoads);
         barsSerieses.clear();
     }
 
     void addBarSeries(const TimePointSeries& barSeries, size_t pane = 0) {
+        changed();
         while (barsSerieses.size() < pane + 1) barsSerieses.push_back({});
         barsSerieses[pane].push_back(barSeries);
     }
 
     void clearPointsSerieses() {
+        changed();
+        cancelLoads(pointsLoads);
         pointsSerieses.clear();
     }
 
     void addPointSeries(const TimePointSeries& pointSeries, size_t pane = 0) {
+        changed();
         while (pointsSerieses.size() < pane + 1) pointsSerieses.push_back({});
         pointsSerieses[pane].push_back(pointSeries);
     }
 
+    void clearWindowedSerieses() {
+        changed();
+        windowedSerieses.clear();
+        windowedFrames.clear();
+        lazyIndicators.clear();
+    }
+
+    // Windowed series are shared, not copied: they are usually big and keep their own caches
+    void addWindowedSeries(shared_ptr<WindowedPointSeries> windowedSeries, size_t pane = 0) {
+        changed();
+        while (windowedSerieses.size() < pane + 1) windowedSerieses.push_back({});
+        while (windowedFrames.size() < pane + 1) windowedFrames.push_back({});
+        windowedSerieses[pane].push_back(windowedSeries);
+        windowedFrames[pane].push_back({});
+    }
+
+    void clearAdaptedSerieses() {
+        changed();
+        adaptedSerieses.clear();
+        candleFields.clear();
+    }
+
+    // Adapted serieses are shared, they draw data kept elsewhere without copying it (see PointSeriesAdapter)
+    void addAdaptedSeries(shared_ptr<PointSeriesAdapter> adaptedSeries, size_t pane = 0) {
+        changed();
+        while (adaptedSerieses.size() < pane + 1) adaptedSerieses.push_back({});
+        adaptedSerieses[pane].push_back(adaptedSeries);
+    }
+
+    // One field of the sourceIndex-th candle series of sourcePane, shown in pane as a line
+    // or as bars (e.g. the volumes in a pane under the candles). It reads the candles
+    // from this chart box, so it is only valid while the chart box lives; copySerieses
+    // binds a new one to the candles of the copy.
+    shared_ptr<CandleFieldSeries> addCandleFieldSeries(
+        CandleField field,
+        size_t pane = 0,
+        size_t sourcePane = 0,
+        size_t sourceIndex = 0,
+        unsigned int color = CHART_COLOR_PLOTTER,
+        bool bars = false
+    ) {
+        CandleFieldBinding binding = { field, sourcePane, sourceIndex, pane, color, bars, nullptr };
+        binding.series = makeCandleField(binding);
+        addAdaptedSeries(binding.series, pane);
+        candleFields.push_back(binding);
+        return binding.series;
+    }
+
+    void clearIndicators() {
+        changed();
+        indicators.clear();
+    }
+
+    // Indicators are shared, not copied, and follow their source series on each draw:
+    // only the candles/points appended since the previous draw are processed.
+    // The source is the sourceIndex-th candle series of sourcePane, the outputs are shown in pane.
+    void addCandleIndicator(
+        shared_ptr<Indicator> indicator, 
+        size_t pane = 0, 
+        size_t sourcePane = 0, 
+        size_t sourceIndex = 0
+    ) {
+        addIndicator({ indicator, true, sourcePane, sourceIndex }, pane);
+    }
+
+    // Same as addCandleIndicator() with a point series as the source
+    void addPointIndicator(
+        shared_ptr<Indicator> indicator, 
+        size_t pane = 0, 
+        size_t sourcePane = 0, 
+        size_t sourceIndex = 0
+    ) {
+        addIndicator({ indicator, false, sourcePane, sourceIndex }, pane);
+    }
+
+    // Indicator computed on demand for the viewed blocks of its source only (see
+    // LazyIndicatorSeries), shown as a windowed series. It reads the source from this
+    // chart box, so it is only valid while the chart box lives.
+    shared_ptr<LazyIndicatorSeries<Candle>> addLazyCandleIndicator(
+        LazyIndicatorSeries<Candle>::Factory factory,
+        size_t warmup,
+        size_t output = 0,
+        size_t pane = 0,
+        size_t sourcePane = 0,
+        size_t sourceIndex = 0
+    ) {
+        shared_ptr<LazyIndicatorSeries<Candle>> series = make_shared<LazyIndicatorSeries<Candle>>(
+            [this, sourcePane, sourceIndex]() -> const vector<Candle>& {
+                static const vector<Candle> empty;
+                const vector<CandleSeries>& sources = getCandlesPane(sourcePane);
+                return sourceIndex < sources.size() ? sources[sourceIndex].getCandlesCRef() : empty;
+            },
+            factory, warmup, output
+        );
+        addWindowedSeries(series, pane);
+        lazyIndicators.push_back({ true, sourcePane, sourceIndex, pane, [series](size_t from) { series->invalidateFrom(from); } });
+        return series;
+    }
+
+    // Same as addLazyCandleIndicator() with a point series as the source
+    shared_ptr<LazyIndicatorSeries<TimePoint>> addLazyPointIndicator(
+        LazyIndicatorSeries<TimePoint>::Factory factory,
+        size_t warmup,
+        size_t output = 0,
+        size_t pane = 0,
+        size_t sourcePane = 0,
+        size_t sourceIndex = 0
+    ) {
+        shared_ptr<LazyIndicatorSeries<TimePoint>> series = make_shared<LazyIndicatorSeries<TimePoint>>(
+            [this, sourcePane, sourceIndex]() -> const vector<TimePoint>& {
+                static const vector<TimePoint> empty;
+                const vector<TimePointSeries>& sources = getPointsPane(sourcePane);
+                return sourceIndex < sources.size() ? sources[sourceIndex].getPointsCRef() : empty;
+            },
+            factory, warmup, output
+        );
+        addWindowedSeries(series, pane);
+        lazyIndicators.push_back({ false, sourcePane, sourceIndex, pane, [series](size_t from) { series->invalidateFrom(from); } });
+        return series;
+    }
+
+    // Attach an empty candle series (a copy of candleSeries without its candles) and fill it
+    // on a worker thread. The loader pushes chunks with load.append(), each chunk is added
+    // on the UI thread and shown right away, the view follows the load until it is moved.
+    // Cancel the returned load to stop it, clearing the candle serieses or destroying the
+    // chart cancels it as well (destroying waits for the loader to return).
+    shared_ptr<AsyncSeriesLoad<Candle>> loadCandleSeriesAsync(
+        const CandleSeries& candleSeries, 
+        AsyncSeriesLoad<Candle>::Loader loader, 
+        size_t pane = 0
+    ) {
+        addCandleSeries(candleSeries, pane);
+        const size_t index = candlesSerieses[pane].size() - 1;
+        candlesSerieses[pane][index].getCandlesRef().clear();
+        shared_ptr<AsyncSeriesLoad<Candle>> load = AsyncSeriesLoad<Candle>::start(
+            loader,
+            [this, pane, index](vector<Candle>& candles, bool /*finished*/) {
+                if (candles.empty()) return;
+                vector<Candle>& target = candlesSerieses[pane][index].getCandlesRef();
+                target.insert(target.end(), candles.begin(), candles.end());
+                showLoaded(candles.front().getTime());
+            },
+            post
+        );
+        addLoad(candlesLoads, load);
+        return load;
+    }
+
+    // Same as loadCandleSeriesAsync() for a bar series
+    shared_ptr<AsyncSeriesLoad<TimePoint>> loadBarSeriesAsync(
+        AsyncSeriesLoad<TimePoint>::Loader loader, 
+        unsigned int color = CHART_COLOR_PLOTTER, 
+        size_t pane = 0
+    ) {
+        addBarSeries(TimePointSeries({}, color), pane);
+        const size_t index = barsSerieses[pane].size() - 1;
+        shared_ptr<AsyncSeriesLoad<TimePoint>> load = AsyncSeriesLoad<TimePoint>::start(
+            loader,
+            [this, pane, index](vector<TimePoint>& points, bool /*finished*/) {
+                appendLoadedPoints(barsSerieses[pane][index], points);
+            },
+            post
+        );
+        addLoad(barsLoads, load);
+        return load;
+    }
+
+    // Same as loadCandleSeriesAsync() for a point (line) series
+    shared_ptr<AsyncSeriesLoad<TimePoint>> loadPointSeriesAsync(
+        AsyncSeriesLoad<TimePoint>::Loader loader, 
+        unsigned int color = CHART_COLOR_PLOTTER, 
+        size_t pane = 0
+    ) {
+        addPointSeries(TimePointSeries({}, color), pane);
+        const size_t index = pointsSerieses[pane].size() - 1;
+        shared_ptr<AsyncSeriesLoad<TimePoint>> load = AsyncSeriesLoad<TimePoint>::start(
+            loader,
+            [this, pane, index](vector<TimePoint>& points, bool /*finished*/) {
+                appendLoadedPoints(pointsSerieses[pane][index], points);
+            },
+            post
+        );
+        addLoad(pointsLoads, load);
+        return load;
+    }
+
+    // Change the index-th candle series of a pane in place (see SeriesPatch) instead of
+    // clearing the serieses and adding a full copy, e.g. { 0, 1, { liveCandle } } to
+    // refresh the last candle. What follows the series is updated from the first changed
+    // sample on: its indicators, lazy indicator blocks and decimated vertices, and the
+    // fit of the panes showing it; only the changed tail is repainted (the whole chart
+    // when the head was dropped).
+    virtual void patchCandleSeries(size_t pane, size_t index, const SeriesPatch<Candle>& patch) {
+        if (patch.empty()) return;
+        settlePrepare();
+        vector<Candle>& candles = candlesSerieses.at(pane).at(index).getCandlesRef();
+        const size_t from = patch.apply(candles);
+        patched(pane, index, true, true, patch.truncateHead, from, candles);
+    }
+
+    // Same as patchCandleSeries() for a bar series
+    virtual void patchBarSeries(size_t pane, size_t index, const SeriesPatch<TimePoint>& patch) {
+        if (patch.empty()) return;
+        settlePrepare();
+        TimePointSeries& barSeries = barsSerieses.at(pane).at(index);
+        const size_t from = patch.apply(barSeries.getPointsRef());
+        barSeries.changed();
+        patched(pane, index, false, false, patch.truncateHead, from, barSeries.getPointsCRef());
+    }
+
+    // Same as patchCandleSeries() for a point (line) series
+    virtual void patchPointSeries(size_t pane, size_t index, const SeriesPatch<TimePoint>& patch) {
+        if (patch.empty()) return;
+        settlePrepare();
+        TimePointSeries& pointSeries = pointsSerieses.at(pane).at(index);
+        const size_t from = patch.apply(pointSeries.getPointsRef());
+        pointSeries.changed();
+        patched(pane, index, true, false, patch.truncateHead, from, pointSeries.getPointsCRef());
+    }
+
+    // Repaint only the part of the chart that changed from the given time on
+    // (e.g. a live tick updated the last candle or point).
+    // The damaged column is passed to FLTK so the next draw() clips to it and
+    // draws only the tail. Falls back to a full redraw() when the Y autoscale
+    // or the view would change, or when the chart has more than one pane.
+    virtual void redrawTail(time_sec from) {
+        settlePrepare();
+
+        // Of several panes only the ones having data from that time on are repainted
+        if (drawnValid && drawnPanes > 1 && drawnPanes == getPaneCount()) {
+            for (size_t pane = 0; pane < drawnPanes; pane++)
+                if (isPaneAffected(pane, from)) redrawPane(pane);
+            return;
+        }
+
+        if (!drawnValid || drawnPanes != 1 || getPaneCount() != 1 || !getWindowedPane(0).empty()) {
+            redraw();
+            return;
+        }
+
+        // Fit the same way as draw() does and see if the scale shifted
+        fitPane(0);
+        if (
+            getTimeAxisSize() != drawnTimeAxisSize ||
+            chart.getValueLower() != drawnValueLower ||
+            chart.getValueUpper() != drawnValueUpper ||
+            chart.getViewFirst() != drawnViewFirst ||
+            chart.getViewLast() != drawnViewLast
+        ) {
+            redraw();
+            return;
+        }
+        tailBounds = chart.getBounds(); // drawTail draws with this fit
+
+        // The column starts where drawTail starts drawing: lines and bars at the vertex
+        // before the changed point, candles at their merged candle (and half body width
+        // to the left of its time)
+        const time_sec changed = tailPending ? min(tailChanged, from) : from;
+        const time_sec viewFirst = chart.getViewFirst();
+        const time_sec tailFirst = max(changed, viewFirst);
+        time_sec tailFrom = from;
+        double halfWidthPx = 0;
+        for (const CandleSeries& candleSeries: getCandlesPane(0)) {
+            halfWidthPx = max(halfWidthPx, chart.getCandleBodyWidth(candleSeries.getInterval()) / 2);
+            const vector<Candle>& candles = candleSeries.getCandlesCRef();
+            const size_t n = getCandlesTailFrom(candleSeries, viewFirst, tailFirst);
+            if (n < candles.size()) tailFrom = min(tailFrom, candles[n].getTime());
+        }
+        for (const TimePointSeries& barSeries: getBarsPane(0))
+            tailFrom = min(tailFrom, getPointsTailTime(barSeries.getPointsCRef(), viewFirst, tailFirst));
+        for (const TimePointSeries& pointSeries: getPointsPane(0))
+            tailFrom = min(tailFrom, getPointsTailTime(pointSeries.getPointsCRef(), viewFirst, tailFirst));
+        for (const IndicatorBinding& binding: getIndicatorsPane(0))
+            for (const TimePointSeries& output: binding.indicator->getOutputs())
+                tailFrom = min(tailFrom, getPointsTailTime(output.getPointsCRef(), viewFirst, tailFirst));
+        for (const shared_ptr<PointSeriesAdapter>& adaptedSeries: getAdaptedPane(0))
+            tailFrom = min(tailFrom, adaptedSeries->getTailTime(chart, tailFirst));
+
+        int left, top, width, height;
+        if (!chart.getTailRect(tailFrom, halfWidthPx, left, top, width, height))
+            return; // change is out of view, nothing to repaint
+
+        // Merge with a tail that is still waiting to be drawn
+        if (tailPending) {
+            int right = max(tailLeft + tailWidth, left + width);
+            int bottom = max(tailTop + tailHeight, top + height);
+            left = min(tailLeft, left);
+            top = min(tailTop, top);
+            width = right - left;
+            height = bottom - top;
+            tailFrom = min(tailTime, tailFrom);
+        }
+        tailPending = true;
+        tailTime = tailFrom;
+        tailChanged = changed;
+        tailLeft = left;
+        tailTop = top;
+        tailWidth = width;
+        tailHeight = height;
+
+        damage(FL_DAMAGE_USER1, x() + left, y() + top, width, height);
+    }
+
     // LCOV_EXCL_START
     // Coverage excluded - draw() requires GUI display environment
     void draw() override {
-        Fl_CanvasBox::draw(); // Call the base class draw method (draws the box itself)
-        
-        // Fit per pane
-        size_t panes = max({ 
-            candlesSerieses.size(), 
-            barsSerieses.size(),
-            pointsSerieses.size(),
-        });
-        for (size_t pane = 0; pane < panes; pane++) {
-            const vector<CandleSeries>& candlesSeries = candlesSerieses.size() > pane ? candlesSerieses[pane] : vector<CandleSeries>();
-            const vector<TimePointSeries>& barsSeries = barsSerieses.size() > pane ? barsSerieses[pane] : vector<TimePointSeries>();
-            const vector<TimePointSeries>& pointsSeries = pointsSerieses.size() > pane ? pointsSerieses[pane] : vector<TimePointSeries>();
+        waitPrepared();
 
-            // Fit the chart to the contents
-            chart.resetBounds();
-            for (const CandleSeries& candleSeries: candlesSeries)
-                chart.fitToCandles(candleSeries.getCandlesCRef());
-            for (const TimePointSeries& barSeries: barsSeries)
-                chart.fitToPoints(barSeries.getPointsCRef());
-            for (const TimePointSeries& pointSeries: pointsSeries)
-                chart.fitToPoints(pointSeries.getPointsCRef());
-            
-            // Initialize view if not set
-            chart.resetView();
-            
-            // Get visible data and fit Y-axis to visible
-            vector<Candle> visibleCandles;
-            for (const CandleSeries& candleSeries: candlesSeries) {
-                vector<Candle> vc = chart.getVisibleCandles(candleSeries.getCandlesCRef());
-                visibleCandles.insert(visibleCandles.end(), vc.begin(), vc.end());
-            }
-            chart.fitToVisibleCandles(visibleCandles);
-            
-            vector<TimePoint> visibleBars;
-            for (const TimePointSeries& barSeries: barsSeries) {
-                vector<TimePoint> vb = chart.getVisiblePoints(barSeries.getPointsCRef());
-                visibleBars.insert(visibleBars.end(), vb.begin(), vb.end());
-            }
-            chart.fitToVisiblePoints(visibleBars);
-            
-            vector<TimePoint> visiblePoints;
-            for (const TimePointSeries& pointSeries: pointsSeries) {
-                vector<TimePoint> vp = chart.getVisiblePoints(pointSeries.getPointsCRef());
-                visiblePoints.insert(visiblePoints.end(), vp.begin(), vp.end());
-            }
-            chart.fitToVisiblePoints(visiblePoints);
+        // Only a live tail update is pending
+        if (tailPending && damage() == FL_DAMAGE_USER1) {
+            TraceSpan span("Fl_ChartBox::drawTail", "render");
+            beginFrameStats(true);
+            drawTail();
+            endFrameStats();
+            return;
+        }
 
-            // Draw visible data
-            for (const CandleSeries& candleSeries: candlesSeries) {
-                vector<Candle> visible = chart.getVisibleCandles(candleSeries.getCandlesCRef());
-                if (!visible.empty())
-                    chart.showCandles(
-                        visible, 
-                        candleSeries.getInterval(), 
-                        candleSeries.getBullishColor(),
-                        candleSeries.getBearishColor(),
-                        candleSeries.getShoulderSpacing()
-                    );
-            }
-            for (const TimePointSeries& barSeries: barsSeries) {
-                vector<TimePoint> visible = chart.getVisiblePoints(barSeries.getPointsCRef());
-                if (!visible.empty())
-                    chart.showBars(
-                        visible, 
-                        barSeries.getColor()
-                    );
+        TraceSpan span("Fl_ChartBox::draw", "render");
+        beginFrameStats(false);
+
+        // Only some panes were damaged (see redrawPane)
+        size_t panes = getPaneCount();
+        const bool panesOnly = damage() == FL_DAMAGE_USER2 && drawnValid && drawnPanes == panes;
+        if (!panesOnly) Fl_CanvasBox::draw(); // Call the base class draw method (draws the box itself)
+        
+        // Fit (or take the prepared fit) and draw per pane, clipped to the pane.
+        // A full redraw fits again, the fit of the other frames (e.g. an expose) is
+        // cached per pane, the panes damaged by redrawPane() are fitted again.
+        const bool prepared = isPrepared();
+        const bool refit = damage() & FL_DAMAGE_ALL;
+        paneDirty.resize(panes, false);
+        for (size_t pane = 0; pane < panes; pane++) {
+            if (panesOnly && !paneDirty[pane]) continue;
+            int top, height;
+            getPaneRegion(pane, top, height);
+            fl_push_clip(x(), y() + top, w(), height);
+            if (panesOnly) Fl_CanvasBox::draw(); // clear the background of the pane
+            if (prepared) {
+                selectPane(pane);
+                chart.setBounds(preparedBounds[pane]);
+                cachePane(pane);
             }
-            for (const TimePointSeries& pointSeries: pointsSeries) {
-                vector<TimePoint> visible = chart.getVisiblePoints(pointSeries.getPointsCRef());
-                if (!visible.empty())
-                    chart.showPoints(
-                        visible, 
-                        pointSeries.getColor()
-                    );
+            else if (refit) {
+                fitPane(pane);
+                cachePane(pane);
             }
+            else fitPaneCached(pane);
+            drawPane(pane);
+            fl_pop_clip();
+            paneDirty[pane] = false;
         }
+        preparedValid = false;
+
+        rememberDrawnScale(panes);
+        endFrameStats();
     }
     // LCOV_EXCL_STOP
 
  protected:
+    // Indicator and where it takes its samples from (see add*Indicator)
+    struct IndicatorBinding {
+        shared_ptr<Indicator> indicator;
+        bool fromCandles;
+        size_t sourcePane;
+        size_t sourceIndex;
+    };
+
     void onMouseWheel(int pixelX, int deltaY) {
+        TraceSpan span("Fl_ChartBox::onMouseWheel", "input");
+        settlePrepare();
         double factor = deltaY < 0 ? chart.getZoomInFactor() : chart.getZoomOutFactor();
         
         if (group) {
@@ -197,6 +676,8 @@ public:
     }
     
     void onDrag(int pixelX, int deltaX) {
+        TraceSpan span("Fl_ChartBox::onDrag", "input");
+        settlePrepare();
         // No previous drag position or view not initialized, ignore
         if (lastDragX == 0 || !chart.isViewInitialized()) return;
         
@@ -209,11 +690,860 @@ public:
         lastDragX = pixelX;
     }
     
+    size_t getPaneCount() const {
+        return max({ 
+            candlesSerieses.size(), 
+            barsSerieses.size(),
+            pointsSerieses.size(),
+            windowedSerieses.size(),
+            adaptedSerieses.size(),
+            indicators.size(),
+        });
+    }
+
+    const vector<CandleSeries>& getCandlesPane(size_t pane) const {
+        static const vector<CandleSeries> empty;
+        return candlesSerieses.size() > pane ? candlesSerieses[pane] : empty;
+    }
+
+    const vector<TimePointSeries>& getBarsPane(size_t pane) const {
+        static const vector<TimePointSeries> empty;
+        return barsSerieses.size() > pane ? barsSerieses[pane] : empty;
+    }
+
+    const vector<TimePointSeries>& getPointsPane(size_t pane) const {
+        static const vector<TimePointSeries> empty;
+        return pointsSerieses.size() > pane ? pointsSerieses[pane] : empty;
+    }
+
+    const vector<shared_ptr<WindowedPointSeries>>& getWindowedPane(size_t pane) const {
+        static const vector<shared_ptr<WindowedPointSeries>> empty;
+        return windowedSerieses.size() > pane ? windowedSerieses[pane] : empty;
+    }
+
+    const vector<shared_ptr<PointSeriesAdapter>>& getAdaptedPane(size_t pane) const {
+        static const vector<shared_ptr<PointSeriesAdapter>> empty;
+        return adaptedSerieses.size() > pane ? adaptedSerieses[pane] : empty;
+    }
+
+    const vector<IndicatorBinding>& getIndicatorsPane(size_t pane) const {
+        static const vector<IndicatorBinding> empty;
+        return indicators.size() > pane ? indicators[pane] : empty;
+    }
+
+    void addIndicator(const IndicatorBinding& binding, size_t pane) {
+        changed();
+        while (indicators.size() < pane + 1) indicators.push_back({});
+        indicators[pane].push_back(binding);
+    }
+
+    // Bring the indicators of a pane up to date with their sources
+    void updateIndicators(size_t pane) {
+        for (const IndicatorBinding& binding: getIndicatorsPane(pane)) {
+            if (binding.fromCandles) {
+                const vector<CandleSeries>& sources = getCandlesPane(binding.sourcePane);
+                if (binding.sourceIndex < sources.size())
+                    binding.indicator->update(sources[binding.sourceIndex].getCandlesCRef());
+            } else {
+                const vector<TimePointSeries>& sources = getPointsPane(binding.sourcePane);
+                if (binding.sourceIndex < sources.size())
+                    binding.indicator->update(sources[binding.sourceIndex].getPointsCRef());
+            }
+        }
+    }
+
+    // A series changed in place from the index from on, after droppedHead samples were
+    // dropped at its head (see patch*Series). Indicators take candle and point serieses
+    // as their source (isSource), fromCandles tells which of them it is.
+    template<typename T>
+    void patched(size_t pane, size_t index, bool isSource, bool fromCandles, size_t droppedHead, size_t from, const vector<T>& items) {
+        touchPane(pane);
+        if (isSource) {
+            const time_sec firstTime = items.empty() ? 0 : items.front().getTime();
+            for (size_t indicatorPane = 0; indicatorPane < indicators.size(); indicatorPane++) {
+                for (const IndicatorBinding& binding: indicators[indicatorPane]) {
+                    if (binding.fromCandles != fromCandles || binding.sourcePane != pane || binding.sourceIndex != index) continue;
+                    patchIndicator(binding.indicator, droppedHead, firstTime, from);
+                    touchPane(indicatorPane);
+                }
+            }
+            for (LazyIndicatorBinding& binding: lazyIndicators) {
+                if (binding.fromCandles != fromCandles || binding.sourcePane != pane || binding.sourceIndex != index) continue;
+                binding.invalidateFrom(droppedHead ? 0 : from); // the blocks are by index
+                touchPane(binding.pane);
+            }
+        }
+
+        // Dropping the head changes the time range
+        if (droppedHead || items.empty()) {
+            redraw();
+            return;
+        }
+        // Dropped tail samples were after the last one left
+        redrawTail(items[min(from, items.size() - 1)].getTime());
+    }
+
+    // Tell an indicator that its source changed (see patched), Fl_AsyncChartBox defers
+    // it while its renderer updates the indicator
+    virtual void patchIndicator(const shared_ptr<Indicator>& indicator, size_t droppedHead, time_sec firstTime, size_t from) {
+        indicator->dropHead(droppedHead, firstTime);
+        indicator->changedFrom(from);
+    }
+
+    // The data of a pane changed in a way its size doesn't tell
+    void touchPane(size_t pane) {
+        if (paneVersions.size() < pane + 1) paneVersions.resize(pane + 1, 0);
+        paneVersions[pane]++;
+        dataVersion++;
+    }
+
+    // Fit the chart bounds to a pane (time range to all data, Y-axis to the visible data)
+    void fitPane(size_t pane, bool updateAxis = true) {
+        selectPane(pane);
+        const vector<CandleSeries>& candlesSeries = getCandlesPane(pane);
+        const vector<TimePointSeries>& barsSeries = getBarsPane(pane);
+        const vector<TimePointSeries>& pointsSeries = getPointsPane(pane);
+        ChartPaneStats* paneStats = getPaneStats(pane);
+
+        {
+            ChartPhaseTimer timer(paneStats, CHART_PHASE_INDICATORS);
+            updateIndicators(pane);
+        }
+
+        {
+            ChartPhaseTimer timer(paneStats, CHART_PHASE_FIT);
+
+            // New bars shift the projection of a trading time axis
+            shared_ptr<TradingTimeAxis> timeAxis = updateAxis ? chart.getTimeAxis() : nullptr;
+            if (timeAxis)
+                for (const CandleSeries& candleSeries: candlesSeries)
+                    timeAxis->addTimes(candleSeries.getCandlesCRef());
+
+            // Fit the chart to the contents
+            chart.resetBounds();
+            for (const CandleSeries& candleSeries: candlesSeries)
+                chart.fitToCandles(candleSeries.getCandlesCRef());
+            for (const TimePointSeries& barSeries: barsSeries)
+                chart.fitToPoints(barSeries.getPointsCRef());
+            for (const TimePointSeries& pointSeries: pointsSeries)
+                chart.fitToPoints(pointSeries.getPointsCRef());
+            for (const IndicatorBinding& binding: getIndicatorsPane(pane))
+                for (const TimePointSeries& output: binding.indicator->getOutputs())
+                    chart.fitToPoints(output.getPointsCRef());
+            for (const shared_ptr<WindowedPointSeries>& windowedSeries: getWindowedPane(pane))
+                if (!windowedSeries->empty())
+                    chart.fitToTimeRange(windowedSeries->getFirstTime(), windowedSeries->getLastTime());
+            for (const shared_ptr<PointSeriesAdapter>& adaptedSeries: getAdaptedPane(pane))
+                adaptedSeries->fit(chart);
+
+            // The panes share the X projection: the time range of all of them
+            time_sec first, last;
+            if (getPaneCount() > 1 && getSharedTimeRange(first, last)) chart.fitToTimeRange(first, last);
+            
+            // Initialize view if not set
+            chart.resetView();
+        }
+        
+        // Get visible data (into the scratch buffers, no allocation once they grew)
+        vector<Candle>& visibleCandles = scratchCandles;
+        vector<TimePoint>& visibleBars = scratchBars;
+        vector<TimePoint>& visiblePoints = scratchPoints;
+        visibleCandles.clear();
+        visibleBars.clear();
+        visiblePoints.clear();
+        {
+            ChartPhaseTimer timer(paneStats, CHART_PHASE_VISIBLE);
+            for (const CandleSeries& candleSeries: candlesSeries)
+                chart.appendVisible(candleSeries.getCandlesCRef(), visibleCandles);
+            for (const TimePointSeries& barSeries: barsSeries)
+                chart.appendVisible(barSeries.getPointsCRef(), visibleBars);
+            for (const TimePointSeries& pointSeries: pointsSeries)
+                chart.appendVisible(pointSeries.getPointsCRef(), visiblePoints);
+            for (const IndicatorBinding& binding: getIndicatorsPane(pane))
+                for (const TimePointSeries& output: binding.indicator->getOutputs())
+                    chart.appendVisible(output.getPointsCRef(), visiblePoints);
+
+            // Only the value range of the adapted serieses, not their points
+            float lower, upper;
+            for (const shared_ptr<PointSeriesAdapter>& adaptedSeries: getAdaptedPane(pane)) {
+                if (!adaptedSeries->getVisibleValueRange(chart, lower, upper)) continue;
+                vector<TimePoint>& visible = adaptedSeries->isBars() ? visibleBars : visiblePoints;
+                visible.push_back(TimePoint(chart.getViewFirst(), lower));
+                visible.push_back(TimePoint(chart.getViewFirst(), upper));
+            }
+        }
+        {
+            ChartPhaseTimer timer(paneStats, CHART_PHASE_WINDOWED);
+            const size_t cacheHits = getWindowedCacheHits(pane);
+            const size_t cacheMisses = getWindowedCacheMisses(pane);
+            fetchWindowed(pane, visiblePoints);
+            if (paneStats) {
+                paneStats->cacheHits += getWindowedCacheHits(pane) - cacheHits;
+                paneStats->cacheMisses += getWindowedCacheMisses(pane) - cacheMisses;
+            }
+        }
+
+        // Fit Y-axis to visible (each kind overrides the previous one)
+        {
+            ChartPhaseTimer timer(paneStats, CHART_PHASE_FIT_Y);
+            chart.fitToVisibleCandles(visibleCandles);
+            chart.fitToVisiblePoints(visibleBars);
+            chart.fitToVisiblePoints(visiblePoints);
+        }
+    }
+
+    // Fetch the view of the windowed serieses of a pane into their frames
+    // (summaries when zoomed out far enough, points otherwise) and add their
+    // value range to the points the Y-axis is fitted to
+    void fetchWindowed(size_t pane, vector<TimePoint>& visiblePoints) {
+        const vector<shared_ptr<WindowedPointSeries>>& windowedSeries = getWindowedPane(pane);
+        if (windowedSeries.empty()) return;
+        const time_sec viewFirst = chart.getViewFirst();
+        const time_sec viewLast = chart.getViewLast();
+        for (size_t n = 0; n < windowedSeries.size(); n++) {
+            WindowedFrame& frame = windowedFrames[pane][n];
+            frame.points.clear();
+            windowedSeries[n]->getSummaries(viewFirst, viewLast, frame.summaries);
+            frame.summaryLevel = chart.isSummaryLevel(frame.summaries.size());
+            if (frame.summaryLevel) {
+                for (const SeriesBlockSummary& summary: frame.summaries) {
+                    if (summary.minValue > summary.maxValue) continue;
+                    visiblePoints.push_back(TimePoint(max(summary.first, viewFirst), summary.minValue));
+                    visiblePoints.push_back(TimePoint(min(summary.last, viewLast), summary.maxValue));
+                }
+                continue;
+            }
+            windowedSeries[n]->getPoints(viewFirst, viewLast, frame.points);
+            visiblePoints.insert(
+                visiblePoints.end(), 
+                frame.points.begin() + chart.findTimeIndex(frame.points, viewFirst),
+                frame.points.begin() + chart.findTimeIndex(frame.points, viewLast + 1)
+            );
+        }
+    }
+
+    // What a prepared fit depends on besides the serieses themselves (see isPrepared)
+    struct PrepareKey {
+        bool viewInitialized;
+        time_sec viewFirst;
+        time_sec viewLast;
+        int width;
+        int height;
+        size_t contentVersion;
+        size_t dataVersion;
+        size_t dataSize;
+        size_t timeAxisSize;
+
+        bool operator==(const PrepareKey& other) const {
+            return 
+                viewInitialized == other.viewInitialized &&
+                viewFirst == other.viewFirst &&
+                viewLast == other.viewLast &&
+                width == other.width &&
+                height == other.height &&
+                contentVersion == other.contentVersion &&
+                dataVersion == other.dataVersion &&
+                dataSize == other.dataSize &&
+                timeAxisSize == other.timeAxisSize;
+        }
+    };
+
+    PrepareKey getPrepareKey() const {
+        size_t dataSize = 0;
+        for (const vector<CandleSeries>& candlesPane: candlesSerieses)
+            for (const CandleSeries& candleSeries: candlesPane) dataSize += candleSeries.getCandlesCRef().size();
+        for (const vector<TimePointSeries>& barsPane: barsSerieses)
+            for (const TimePointSeries& barSeries: barsPane) dataSize += barSeries.getPointsCRef().size();
+        for (const vector<TimePointSeries>& pointsPane: pointsSerieses)
+            for (const TimePointSeries& pointSeries: pointsPane) dataSize += pointSeries.getPointsCRef().size();
+        size_t windowedVersion = 0; // versions only grow, so does their sum
+        for (const vector<shared_ptr<WindowedPointSeries>>& windowedPane: windowedSerieses)
+            for (const shared_ptr<WindowedPointSeries>& windowedSeries: windowedPane) {
+                dataSize += windowedSeries->size();
+                windowedVersion += windowedSeries->getVersion();
+            }
+        for (const vector<shared_ptr<PointSeriesAdapter>>& adaptedPane: adaptedSerieses)
+            for (const shared_ptr<PointSeriesAdapter>& adaptedSeries: adaptedPane) dataSize += adaptedSeries->size();
+        return {
+            chart.isViewInitialized(), chart.getViewFirst(), chart.getViewLast(),
+            w(), h(), contentVersion, dataVersion + windowedVersion, dataSize, getTimeAxisSize()
+        };
+    }
+
+    // Fit every pane and keep the bounds for the next draw(), stops early when the job is cancelled.
+    // The decimated vertices of the panes go to the decimation cache meanwhile, so draw() only
+    // projects them. Doesn't touch FLTK, runs on a RenderPool worker (see prepareAsync).
+    bool prepare(const RenderJob* job = nullptr) {
+        TraceSpan span("Fl_ChartBox::prepare", "render");
+        preparedValid = false;
+        const size_t panes = getPaneCount();
+        preparedBounds.resize(panes);
+        for (size_t pane = 0; pane < panes; pane++) {
+            if (job && job->isCancelled()) return false;
+            fitPane(pane, false);
+            preparedBounds[pane] = chart.getBounds();
+            decimatePane(pane);
+        }
+        preparedKey = getPrepareKey();
+        preparedValid = true;
+        return true;
+    }
+
+    // Decimate the identified serieses drawPane() shows into the decimation cache, with the
+    // bounds of the fitted pane (see Chart::cacheDecimated)
+    void decimatePane(size_t pane) {
+        if (!chart.getDecimationCache()) return;
+        ChartPhaseTimer timer(getPaneStats(pane), CHART_PHASE_DRAW); // the LOD selection of the draw
+        size_t from, to;
+        for (const TimePointSeries& barSeries: getBarsPane(pane)) {
+            chart.getVisibleRange(barSeries.getPointsCRef(), from, to);
+            chart.cacheDecimated(barSeries.getPointsCRef(), from, to, true, barSeries.getId(), barSeries.getVersion());
+        }
+        for (const TimePointSeries& pointSeries: getPointsPane(pane)) {
+            chart.getVisibleRange(pointSeries.getPointsCRef(), from, to);
+            chart.cacheDecimated(pointSeries.getPointsCRef(), from, to, false, pointSeries.getId(), pointSeries.getVersion());
+        }
+        for (const IndicatorBinding& binding: getIndicatorsPane(pane))
+            for (const TimePointSeries& output: binding.indicator->getOutputs()) {
+                chart.getVisibleRange(output.getPointsCRef(), from, to);
+                chart.cacheDecimated(output.getPointsCRef(), from, to, false, output.getId(), output.getVersion());
+            }
+    }
+
+    // Cancel and wait for a pending preparation, before the chart is changed
+    void settlePrepare() {
+        if (prepareJob) prepareJob->cancel();
+        waitPrepared();
+    }
+
+    // The serieses changed, a prepared fit is stale
+    void changed() {
+        settlePrepare();
+        contentVersion++;
+    }
+
+    // Draw the chart on a pane from now on (fitPane and drawPane select their pane)
+    void selectPane(size_t pane) {
+        int canvasTop, canvasHeight, regionTop, regionHeight;
+        getPaneLayout(pane, canvasTop, canvasHeight, regionTop, regionHeight);
+        paneCanvas.setRect(0, canvasTop, w(), canvasHeight);
+        selectedPane = pane;
+    }
+
+    // The canvas of a pane reaches over the spacing of the box around the inner
+    // rows of the pane, so its Y axis spans these rows only; the region of the
+    // pane is where it is clipped to (its inner rows, and the outer spacing of
+    // the box for the first and the last pane)
+    void getPaneLayout(size_t pane, int& canvasTop, int& canvasHeight, int& regionTop, int& regionHeight) const {
+        const size_t panes = max((size_t)1, getPaneCount());
+        if (panes == 1) {
+            canvasTop = regionTop = 0;
+            canvasHeight = regionHeight = h();
+            return;
+        }
+        const int spacingTop = chart.getSpacingTop();
+        const int spacingBottom = chart.getSpacingBottom();
+        const int inner = max(0, h() - spacingTop - spacingBottom);
+        double before = 0, total = 0;
+        for (size_t n = 0; n < panes; n++) {
+            if (n < pane) before += getPaneRatio(n);
+            total += getPaneRatio(n);
+        }
+        const int top = spacingTop + (int)lround(inner * before / total);
+        const int bottom = spacingTop + (int)lround(inner * (before + getPaneRatio(pane)) / total);
+        canvasTop = top - spacingTop;
+        canvasHeight = bottom - top + spacingTop + spacingBottom;
+        if (pane + 1 < panes) canvasHeight--; // the lowest value is drawn on the bottom row, keep it off the next pane
+        regionTop = pane ? top : 0;
+        regionHeight = (pane + 1 < panes ? bottom : h()) - regionTop;
+    }
+
+    // Time range of the serieses of all panes, from the ends of each (they are time sorted)
+    bool getSharedTimeRange(time_sec& first, time_sec& last) const {
+        first = numeric_limits<time_sec>::max();
+        last = numeric_limits<time_sec>::min();
+        const auto add = [&first, &last](time_sec from, time_sec to) {
+            first = min(first, from);
+            last = max(last, to);
+        };
+        for (const vector<CandleSeries>& candlesPane: candlesSerieses)
+            for (const CandleSeries& candleSeries: candlesPane)
+                if (!candleSeries.getCandlesCRef().empty())
+                    add(candleSeries.getCandlesCRef().front().getTime(), candleSeries.getCandlesCRef().back().getTime());
+        for (const vector<vector<TimePointSeries>>* serieses: { &barsSerieses, &pointsSerieses })
+            for (const vector<TimePointSeries>& pointsPane: *serieses)
+                for (const TimePointSeries& pointSeries: pointsPane)
+                    if (!pointSeries.getPointsCRef().empty())
+                        add(pointSeries.getPointsCRef().front().getTime(), pointSeries.getPointsCRef().back().getTime());
+        for (const vector<shared_ptr<WindowedPointSeries>>& windowedPane: windowedSerieses)
+            for (const shared_ptr<WindowedPointSeries>& windowedSeries: windowedPane)
+                if (!windowedSeries->empty()) add(windowedSeries->getFirstTime(), windowedSeries->getLastTime());
+        time_sec from, to;
+        for (const vector<shared_ptr<PointSeriesAdapter>>& adaptedPane: adaptedSerieses)
+            for (const shared_ptr<PointSeriesAdapter>& adaptedSeries: adaptedPane)
+                if (adaptedSeries->getTimeRange(from, to)) add(from, to);
+        return first <= last;
+    }
+
+    // The pane shows data at or after the given time (the windowed and adapted
+    // serieses are taken as changed, their source is not known here)
+    bool isPaneAffected(size_t pane, time_sec from) const {
+        for (const CandleSeries& candleSeries: getCandlesPane(pane))
+            if (!candleSeries.getCandlesCRef().empty() && candleSeries.getCandlesCRef().back().getTime() >= from) return true;
+        for (const TimePointSeries& barSeries: getBarsPane(pane))
+            if (!barSeries.getPointsCRef().empty() && barSeries.getPointsCRef().back().getTime() >= from) return true;
+        for (const TimePointSeries& pointSeries: getPointsPane(pane))
+            if (!pointSeries.getPointsCRef().empty() && pointSeries.getPointsCRef().back().getTime() >= from) return true;
+        for (const IndicatorBinding& binding: getIndicatorsPane(pane)) {
+            time_sec last = 0;
+            if (binding.fromCandles) {
+                const vector<CandleSeries>& sources = getCandlesPane(binding.sourcePane);
+                if (binding.sourceIndex < sources.size() && !sources[binding.sourceIndex].getCandlesCRef().empty())
+                    last = sources[binding.sourceIndex].getCandlesCRef().back().getTime();
+            } else {
+                const vector<TimePointSeries>& sources = getPointsPane(binding.sourcePane);
+                if (binding.sourceIndex < sources.size() && !sources[binding.sourceIndex].getPointsCRef().empty())
+                    last = sources[binding.sourceIndex].getPointsCRef().back().getTime();
+            }
+            if (last >= from) return true;
+        }
+        return !getWindowedPane(pane).empty() || !getAdaptedPane(pane).empty();
+    }
+
+    // What the fit of one pane depends on (see fitPaneCached): the view, the size
+    // of the pane and the data the pane shows (indicators: their source)
+    PrepareKey getPaneKey(size_t pane) const {
+        int canvasTop, canvasHeight, regionTop, regionHeight;
+        getPaneLayout(pane, canvasTop, canvasHeight, regionTop, regionHeight);
+        size_t dataSize = 0;
+        for (const CandleSeries& candleSeries: getCandlesPane(pane)) dataSize += candleSeries.getCandlesCRef().size();
+        for (const TimePointSeries& barSeries: getBarsPane(pane)) dataSize += barSeries.getPointsCRef().size();
+        for (const TimePointSeries& pointSeries: getPointsPane(pane)) dataSize += pointSeries.getPointsCRef().size();
+        for (const IndicatorBinding& binding: getIndicatorsPane(pane)) {
+            if (binding.fromCandles) {
+                const vector<CandleSeries>& sources = getCandlesPane(binding.sourcePane);
+                if (binding.sourceIndex < sources.size()) dataSize += sources[binding.sourceIndex].getCandlesCRef().size();
+            } else {
+                const vector<TimePointSeries>& sources = getPointsPane(binding.sourcePane);
+                if (binding.sourceIndex < sources.size()) dataSize += sources[binding.sourceIndex].getPointsCRef().size();
+            }
+        }
+        size_t windowedVersion = 0; // versions only grow, so does their sum
+        for (const shared_ptr<WindowedPointSeries>& windowedSeries: getWindowedPane(pane)) {
+            dataSize += windowedSeries->size();
+            windowedVersion += windowedSeries->getVersion();
+        }
+        for (const shared_ptr<PointSeriesAdapter>& adaptedSeries: getAdaptedPane(pane)) dataSize += adaptedSeries->size();
+        return {
+            chart.isViewInitialized(), chart.getViewFirst(), chart.getViewLast(),
+            w(), canvasHeight, contentVersion, (pane < paneVersions.size() ? paneVersions[pane] : 0) + windowedVersion, dataSize, getTimeAxisSize()
+        };
+    }
+
+    // Fit a pane, or take its fit of a previous frame when nothing it depends on
+    // changed (only the time range shared with the other panes is updated then).
+    // Returns true if it was fitted.
+    bool fitPaneCached(size_t pane) {
+        if (paneCaches.size() > pane && paneCaches[pane].valid && paneCaches[pane].key == getPaneKey(pane)) {
+            selectPane(pane);
+            ChartBounds bounds = paneCaches[pane].bounds;
+            time_sec first, last;
+            if (getPaneCount() > 1 && getSharedTimeRange(first, last)) {
+                bounds.valueFirst = min(bounds.valueFirst, first);
+                bounds.valueLast = max(bounds.valueLast, last);
+            }
+            chart.setBounds(bounds);
+            return false;
+        }
+        fitPane(pane);
+        cachePane(pane);
+        return true;
+    }
+
+    // Keep the current fit of a pane for the next frames
+    void cachePane(size_t pane) {
+        if (paneCaches.size() < pane + 1) paneCaches.resize(pane + 1);
+        paneCaches[pane].valid = true;
+        paneCaches[pane].key = getPaneKey(pane);
+        paneCaches[pane].bounds = chart.getBounds();
+    }
+
+    size_t getWindowedCacheHits(size_t pane) const {
+        size_t hits = 0;
+        for (const shared_ptr<WindowedPointSeries>& windowedSeries: getWindowedPane(pane))
+            hits += windowedSeries->getCacheHits();
+        return hits;
+    }
+
+    size_t getWindowedCacheMisses(size_t pane) const {
+        size_t misses = 0;
+        for (const shared_ptr<WindowedPointSeries>& windowedSeries: getWindowedPane(pane))
+            misses += windowedSeries->getCacheMisses();
+        return misses;
+    }
+
+    // Stats of the pane in the frame being drawn, nullptr when not collecting
+    ChartPaneStats* getPaneStats(size_t pane) {
+        if (!statsEnabled || !statsFrameActive) return nullptr;
+        if (frameStats.panes.size() <= pane) frameStats.panes.resize(pane + 1);
+        return &frameStats.panes[pane];
+    }
+
+    // Start collecting the stats of a frame (draw() and drawTail() call it)
+    void beginFrameStats(bool tail) {
+        if (!statsEnabled) return;
+        frameStats.tail = tail;
+        frameStats.totalNs = 0;
+        for (ChartPaneStats& paneStats: frameStats.panes) paneStats.reset(); // keeps the capacity
+        frameCounters = ChartCounters();
+        chart.setCounters(&frameCounters);
+        statsFrameActive = true;
+        statsFrameStart = chrono::steady_clock::now();
+    }
+
+    void endFrameStats() {
+        if (!statsFrameActive) return;
+        frameStats.totalNs = ChartPhaseTimer::getElapsedNs(statsFrameStart);
+        frameStats.frame++;
+        if (frameStats.panes.size() > getPaneCount()) frameStats.panes.resize(getPaneCount());
+        chart.setCounters(nullptr);
+        statsFrameActive = false;
+        if (onFrameStats) onFrameStats(frameStats);
+    }
+
+    // LCOV_EXCL_START
+    // Coverage excluded - drawing requires GUI display environment
+    void drawPane(size_t pane) {
+        selectPane(pane);
+        ChartPaneStats* paneStats = getPaneStats(pane);
+        ChartPhaseTimer timer(paneStats, CHART_PHASE_DRAW);
+
+        // Draw visible data, by index range (no copy of the visible part)
+        size_t from, to;
+        const vector<CandleSeries>& candlesSeries = getCandlesPane(pane);
+        for (size_t n = 0; n < candlesSeries.size(); n++) {
+            const CandleSeries& candleSeries = candlesSeries[n];
+            const vector<Candle>& candles = candleSeries.getCandlesCRef();
+            chart.getVisibleRange(candles, from, to);
+            ChartSeriesTimer seriesTimer(paneStats, frameCounters, "candles", n, candles.size(), to - from);
+            if (from < to)
+                chart.showCandlesRange(
+                    candles, from, to,
+                    candleSeries.getInterval(), 
+                    candleSeries.getBullishColor(),
+                    candleSeries.getBearishColor(),
+                    candleSeries.getShoulderSpacing()
+                );
+        }
+        const vector<TimePointSeries>& barsSeries = getBarsPane(pane);
+        for (size_t n = 0; n < barsSeries.size(); n++) {
+            const vector<TimePoint>& points = barsSeries[n].getPointsCRef();
+            chart.getVisibleRange(points, from, to);
+            ChartSeriesTimer seriesTimer(paneStats, frameCounters, "bars", n, points.size(), to - from);
+            if (from < to)
+                chart.showBarsRange(points, from, to, barsSeries[n].getColor(), barsSeries[n].getId(), barsSeries[n].getVersion());
+        }
+        const vector<TimePointSeries>& pointsSeries = getPointsPane(pane);
+        for (size_t n = 0; n < pointsSeries.size(); n++) {
+            const vector<TimePoint>& points = pointsSeries[n].getPointsCRef();
+            chart.getVisibleRange(points, from, to);
+            ChartSeriesTimer seriesTimer(paneStats, frameCounters, "points", n, points.size(), to - from);
+            if (from < to)
+                chart.showPointsRange(points, from, to, pointsSeries[n].getColor(), pointsSeries[n].getId(), pointsSeries[n].getVersion());
+        }
+        const vector<IndicatorBinding>& bindings = getIndicatorsPane(pane);
+        for (size_t n = 0; n < bindings.size(); n++) {
+            for (const TimePointSeries& output: bindings[n].indicator->getOutputs()) {
+                const vector<TimePoint>& points = output.getPointsCRef();
+                chart.getVisibleRange(points, from, to);
+                ChartSeriesTimer seriesTimer(paneStats, frameCounters, "indicator", n, points.size(), to - from);
+                if (from < to)
+                    chart.showPointsRange(points, from, to, output.getColor(), output.getId(), output.getVersion());
+            }
+        }
+        const vector<shared_ptr<WindowedPointSeries>>& windowedSeries = getWindowedPane(pane);
+        for (size_t n = 0; n < windowedSeries.size(); n++) {
+            const WindowedFrame& frame = windowedFrames[pane][n];
+            const size_t fetched = frame.summaryLevel ? frame.summaries.size() : frame.points.size();
+            ChartSeriesTimer seriesTimer(paneStats, frameCounters, "windowed", n, fetched, fetched);
+            if (frame.summaryLevel)
+                chart.showSummaries(frame.summaries, windowedSeries[n]->getColor());
+            else
+                chart.showPointsRange(
+                    frame.points,
+                    chart.findTimeIndex(frame.points, chart.getViewFirst()),
+                    chart.findTimeIndex(frame.points, chart.getViewLast() + 1),
+                    windowedSeries[n]->getColor()
+                );
+        }
+        const vector<shared_ptr<PointSeriesAdapter>>& adaptedSeries = getAdaptedPane(pane);
+        for (size_t n = 0; n < adaptedSeries.size(); n++) {
+            adaptedSeries[n]->getVisibleRange(chart, from, to);
+            ChartSeriesTimer seriesTimer(paneStats, frameCounters, "adapted", n, adaptedSeries[n]->size(), to - from);
+            adaptedSeries[n]->show(chart, chart.getViewFirst());
+        }
+    }
+
+    // Draw the data changed from tailChanged on, clipped to the damaged column, with the fit of
+    // redrawTail. Each series starts where its full draw (see drawPane) has a vertex or
+    // a merged candle before the tail, so the level of details lines up with it.
+    // The tail ranges are decimated directly, they are not worth a decimation cache entry.
+    void drawTail() {
+        fl_push_clip(x() + tailLeft, y() + tailTop, tailWidth, tailHeight);
+        Fl_CanvasBox::draw(); // clear the background of the column
+
+        selectPane(0);
+        chart.setBounds(tailBounds);
+        ChartPhaseTimer timer(getPaneStats(0), CHART_PHASE_DRAW);
+        const time_sec viewFirst = chart.getViewFirst();
+        const time_sec viewLast = chart.getViewLast();
+        const time_sec tailFirst = max(tailChanged, viewFirst);
+        for (const CandleSeries& candleSeries: getCandlesPane(0)) {
+            const vector<Candle>& candles = candleSeries.getCandlesCRef();
+            chart.showCandlesRange(
+                candles, 
+                getCandlesTailFrom(candleSeries, viewFirst, tailFirst),
+                chart.findTimeIndex(candles, viewLast + 1),
+                candleSeries.getInterval(), 
+                candleSeries.getBullishColor(),
+                candleSeries.getBearishColor(),
+                candleSeries.getShoulderSpacing()
+            );
+        }
+        for (const TimePointSeries& barSeries: getBarsPane(0)) {
+            const vector<TimePoint>& points = barSeries.getPointsCRef();
+            chart.showBarsRange(
+                points, 
+                getPointsTailFrom(points, viewFirst, tailFirst),
+                chart.findTimeIndex(points, viewLast + 1),
+                barSeries.getColor()
+            );
+        }
+        for (const TimePointSeries& pointSeries: getPointsPane(0)) {
+            const vector<TimePoint>& points = pointSeries.getPointsCRef();
+            chart.showPointsRange(
+                points, 
+                getPointsTailFrom(points, viewFirst, tailFirst),
+                chart.findTimeIndex(points, viewLast + 1),
+                pointSeries.getColor()
+            );
+        }
+        for (const IndicatorBinding& binding: getIndicatorsPane(0)) {
+            for (const TimePointSeries& output: binding.indicator->getOutputs()) {
+                const vector<TimePoint>& points = output.getPointsCRef();
+                chart.showPointsRange(
+                    points, 
+                    getPointsTailFrom(points, viewFirst, tailFirst),
+                    chart.findTimeIndex(points, viewLast + 1),
+                    output.getColor()
+                );
+            }
+        }
+        for (const shared_ptr<PointSeriesAdapter>& adaptedSeries: getAdaptedPane(0))
+            adaptedSeries->show(chart, adaptedSeries->getTailTime(chart, tailFirst));
+
+        fl_pop_clip();
+        tailPending = false;
+    }
+    // LCOV_EXCL_STOP
+
+    // Remember the scale of the last full draw, tail redraws are only valid while it holds
+    void rememberDrawnScale(size_t panes) {
+        drawnValid = chart.isViewInitialized();
+        drawnPanes = panes;
+        drawnValueLower = chart.getValueLower();
+        drawnValueUpper = chart.getValueUpper();
+        drawnViewFirst = chart.getViewFirst();
+        drawnViewLast = chart.getViewLast();
+        drawnTimeAxisSize = getTimeAxisSize();
+        tailPending = false;
+    }
+
+    size_t getTimeAxisSize() const {
+        shared_ptr<TradingTimeAxis> timeAxis = chart.getTimeAxis();
+        return timeAxis ? timeAxis->size() : 0;
+    }
+
+    // First point of the tail to draw (see Chart::getPointsTailFrom)
+    size_t getPointsTailFrom(const vector<TimePoint>& points, time_sec viewFirst, time_sec tailFirst) const {
+        return chart.getPointsTailFrom(points, chart.findTimeIndex(points, viewFirst), chart.findTimeIndex(points, tailFirst));
+    }
+
+    // Time of that point (the tail time itself if there is none)
+    time_sec getPointsTailTime(const vector<TimePoint>& points, time_sec viewFirst, time_sec tailFirst) const {
+        const size_t n = getPointsTailFrom(points, viewFirst, tailFirst);
+        return n < points.size() ? min(points[n].getTime(), tailFirst) : tailFirst;
+    }
+
+    // First candle of the tail to draw (see Chart::getCandlesTailFrom)
+    size_t getCandlesTailFrom(const CandleSeries& candleSeries, time_sec viewFirst, time_sec tailFirst) const {
+        const vector<Candle>& candles = candleSeries.getCandlesCRef();
+        return chart.getCandlesTailFrom(
+            chart.findTimeIndex(candles, viewFirst),
+            chart.findTimeIndex(candles, tailFirst),
+            candleSeries.getInterval()
+        );
+    }
+
+    void appendLoadedPoints(TimePointSeries& series, const vector<TimePoint>& points) {
+        if (points.empty()) return;
+        vector<TimePoint>& target = series.getPointsRef();
+        target.insert(target.end(), points.begin(), points.end());
+        series.changed();
+        showLoaded(points.front().getTime());
+    }
+
+    // Show a loaded chunk. Until the view is moved it follows the load: the first draw
+    // (of an empty or partial series) set the view to the data of then, it is dropped
+    // so the next fit shows everything loaded so far.
+    void showLoaded(time_sec from) {
+        if (
+            !chart.isViewInitialized() ||
+            (chart.getViewFirst() == chart.getValueFirst() && chart.getViewLast() == chart.getValueLast())
+        ) {
+            chart.clearView();
+            redraw();
+            return;
+        }
+        redrawTail(from);
+    }
+
+    // The loads are kept until their loader returned, cancelled or not (see ~Fl_ChartBox)
+    void addLoad(vector<shared_ptr<AsyncSeriesLoadBase>>& loads, shared_ptr<AsyncSeriesLoadBase> load) {
+        loads.erase(remove_if(loads.begin(), loads.end(), 
+            [](const shared_ptr<AsyncSeriesLoadBase>& l) { return l->isDone(); }
+        ), loads.end());
+        loads.push_back(load);
+    }
+
+    void cancelLoads(vector<shared_ptr<AsyncSeriesLoadBase>>& loads) {
+        for (shared_ptr<AsyncSeriesLoadBase>& load: loads) load->cancel();
+    }
+
+    // LCOV_EXCL_START
+    // Coverage excluded - needs a running FLTK event loop (Fl::lock() is called by UI_Window::run)
+    static void postToUI(function<void()> task) {
+        Fl::awake([](void* data) {
+            function<void()>* task = (function<void()>*)data;
+            (*task)();
+            delete task;
+        }, new function<void()>(task));
+    }
+    // LCOV_EXCL_STOP
+
+    SubCanvas paneCanvas;
     Chart chart;
     ChartGroup* group;
     int lastDragX;
+    InteractionRecorder* recorder = nullptr;
+    size_t recorderChart = 0;
+    Post post = postToUI;
+
+    // Background loads filling the serieses (see load*SeriesAsync)
+    vector<shared_ptr<AsyncSeriesLoadBase>> candlesLoads;
+    vector<shared_ptr<AsyncSeriesLoadBase>> barsLoads;
+    vector<shared_ptr<AsyncSeriesLoadBase>> pointsLoads;
+
+    // State of the last full draw and the pending tail (see redrawTail)
+    bool drawnValid = false;
+    size_t drawnPanes = 0;
+    float drawnValueLower = 0;
+    float drawnValueUpper = 0;
+    time_sec drawnViewFirst = 0;
+    time_sec drawnViewLast = 0;
+    size_t drawnTimeAxisSize = 0;
+    bool tailPending = false;
+    time_sec tailTime = 0;
+    time_sec tailChanged = 0; // earliest change of the pending tail, tailTime is where its column starts
+    ChartBounds tailBounds = {};
+    int tailLeft = 0;
+    int tailTop = 0;
+    int tailWidth = 0;
+    int tailHeight = 0;
 
     vector<vector<CandleSeries>> candlesSerieses;
     vector<vector<TimePointSeries>> barsSerieses;
     vector<vector<TimePointSeries>> pointsSerieses;
+
+    vector<vector<IndicatorBinding>> indicators;
+
+    // Candle field series and the candles it reads (see addCandleFieldSeries, copySerieses)
+    struct CandleFieldBinding {
+        CandleField field;
+        size_t sourcePane;
+        size_t sourceIndex;
+        size_t pane;
+        unsigned int color;
+        bool bars;
+        shared_ptr<CandleFieldSeries> series;
+    };
+    vector<CandleFieldBinding> candleFields;
+
+    shared_ptr<CandleFieldSeries> makeCandleField(const CandleFieldBinding& binding) {
+        const size_t sourcePane = binding.sourcePane;
+        const size_t sourceIndex = binding.sourceIndex;
+        return makeCandleFieldSeries(
+            [this, sourcePane, sourceIndex]() -> const vector<Candle>& {
+                static const vector<Candle> empty;
+                const vector<CandleSeries>& sources = getCandlesPane(sourcePane);
+                return sourceIndex < sources.size() ? sources[sourceIndex].getCandlesCRef() : empty;
+            },
+            binding.field, binding.color, binding.bars
+        );
+    }
+
+    // Lazy indicator and where it takes its samples from (see addLazy*Indicator, patched)
+    struct LazyIndicatorBinding {
+        bool fromCandles;
+        size_t sourcePane;
+        size_t sourceIndex;
+        size_t pane;
+        function<void(size_t)> invalidateFrom;
+    };
+    vector<LazyIndicatorBinding> lazyIndicators;
+
+    // View of a windowed series, fetched by fitPane() and drawn by drawPane()
+    struct WindowedFrame {
+        bool summaryLevel = false;
+        vector<SeriesBlockSummary> summaries;
+        vector<TimePoint> points;
+    };
+    vector<vector<shared_ptr<WindowedPointSeries>>> windowedSerieses;
+    vector<vector<WindowedFrame>> windowedFrames;
+
+    vector<vector<shared_ptr<PointSeriesAdapter>>> adaptedSerieses;
+
+    // Layout of the panes, the pane the chart draws on and the fit of each pane
+    // kept between frames (see fitPaneCached)
+    struct PaneCache {
+        bool valid = false;
+        PrepareKey key = {};
+        ChartBounds bounds = {};
+    };
+    vector<double> paneRatios;
+    size_t selectedPane = 0;
+    vector<PaneCache> paneCaches;
+    vector<bool> paneDirty;
+
+    // Reused by fitPane() each frame, so a steady state redraw doesn't allocate
+    vector<Candle> scratchCandles;
+    vector<TimePoint> scratchBars;
+    vector<TimePoint> scratchPoints;
+
+    // Fit prepared on a RenderPool worker (see prepareAsync)
+    RenderPool* preparePool = nullptr;
+    shared_ptr<RenderJob> prepareJob = nullptr;
+    vector<ChartBounds> preparedBounds;
+    PrepareKey preparedKey = {};
+    bool preparedValid = false;
+    size_t contentVersion = 0;
+    size_t dataVersion = 0;       // patches of all panes (see touchPane)
+    vector<size_t> paneVersions;  // patches of the data each pane shows
+
+    // Draw stats (see setStatsEnabled), the counters are attached to the chart during a frame only
+    bool statsEnabled = false;
+    bool statsFrameActive = false;
+    chrono::steady_clock::time_point statsFrameStart;
+    ChartCounters frameCounters;
+    ChartFrameStats frameStats;
 };
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Fl_ChartBox.hpp"
+#include "ImageCanvas.hpp"
+
+// Chart box drawing into an ImageCanvas instead of the window. It is never shown
+// (create it outside of any group), render() fits and draws all its panes without
+// touching FLTK, so it may run on a worker thread (one thread at a time).
+class Fl_ImageChartBox: public Fl_ChartBox {
+public:
+    Fl_ImageChartBox(
+        int W, int H,
+        int spacingTop = CHART_SPACING_TOP,
+        int spacingBottom = CHART_SPACING_BOTTOM,
+        int spacingLeft = CHART_SPACING_LEFT,
+        int spacingRight = CHART_SPACING_RIGHT,
+        unsigned int background = 0x000000
+    ):
+        Fl_ChartBox(0, 0, W, H, spacingTop, spacingBottom, spacingLeft, spacingRight),
+        image(W, H, background)
+    {}
+
+    virtual ~Fl_ImageChartBox() {}
+
+    ImageCanvas& getImage() { return image; }
+
+    void resize(int X, int Y, int W, int H) override {
+        Fl_ChartBox::resize(X, Y, W, H);
+        if (W != image.width() || H != image.height()) image.resize(W, H);
+    }
+
+    // Draw a frame into the image, returns false if isCancelled() said so
+    // between the panes (the image is incomplete then).
+    // The trading time axis is not updated here: it may be shared with the UI thread,
+    // give this chart its own copy (see Fl_AsyncChartBox).
+    bool render(const function<bool()>& isCancelled = nullptr) {
+        TraceSpan span("Fl_ImageChartBox::render", "render");
+        image.clear();
+        const size_t panes = getPaneCount();
+        for (size_t pane = 0; pane < panes; pane++) {
+            if (isCancelled && isCancelled()) return false;
+            fitPane(pane, false);
+            if (isCancelled && isCancelled()) return false;
+            drawPane(pane);
+        }
+        return true;
+    }
+
+    void line(int left1, int top1, int left2, int top2, unsigned int color, int style = 0) override {
+        image.line(left1, top1, left2, top2, color, style);
+    }
+
+    void circle(int left, int top, int radius, unsigned int color) override {
+        image.circle(left, top, radius, color);
+    }
+
+    void circlef(int left, int top, int radius, unsigned int color) override {
+        image.circlef(left, top, radius, color);
+    }
+
+    void rect(int left, int top, int width, int height, unsigned int color) override {
+        image.rect(left, top, width, height, color);
+    }
+
+    void rectf(int left, int top, int width, int height, unsigned int color) override {
+        image.rectf(left, top, width, height, color);
+    }
+
+    void text(int left, int top, const string& txt, unsigned int color, int font = 0, int size = 14) override {
+        image.text(left, top, txt, color, font, size);
+    }
+
+    void measure(const string& text, int& width, int& height, int& descent, int font = 0, int size = 14) override {
+        image.measure(text, width, height, descent, font, size);
+    }
+
+    int width() override { return image.width(); }
+    int height() override { return image.height(); }
+    void clear() override { image.clear(); }
+
+protected:
+    ImageCanvas image;
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "../misc/Canvas.hpp"
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+// Canvas rasterizing into an RGB image in memory (3 bytes per pixel, rows top
+// down), so a chart can be drawn off the UI thread and blitted or saved later.
+// No antialiasing, everything is clipped to the image. Line styles are drawn
+// solid. There is no font: measure() estimates a monospace box, text() draws nothing.
+// Colors are 0xRRGGBB.
+class ImageCanvas: public Canvas {
+public:
+    ImageCanvas(int width = 0, int height = 0, unsigned int background = 0x000000):
+        background(background)
+    {
+        resize(width, height);
+    }
+
+    virtual ~ImageCanvas() {}
+
+    // Keeps the capacity, so resizing back and forth doesn't allocate
+    void resize(int width, int height) {
+        imageWidth = max(0, width);
+        imageHeight = max(0, height);
+        pixels.resize((size_t)imageWidth * imageHeight * 3);
+        clear();
+    }
+
+    void setBackground(unsigned int background) { this->background = background; }
+    unsigned int getBackground() const { return background; }
+
+    const unsigned char* getData() const { return pixels.data(); }
+    const vector<unsigned char>& getPixels() const { return pixels; }
+
+    unsigned int getPixel(int x, int y) const {
+        if (x < 0 || y < 0 || x >= imageWidth || y >= imageHeight) return background;
+        const unsigned char* p = &pixels[((size_t)y * imageWidth + x) * 3];
+        return (p[0] << 16) | (p[1] << 8) | p[2];
+    }
+
+    // Pixels of the given color
+    size_t countPixels(unsigned int color) const {
+        size_t count = 0;
+        for (int y = 0; y < imageHeight; y++)
+            for (int x = 0; x < imageWidth; x++)
+                if (getPixel(x, y) == color) count++;
+        return count;
+    }
+
+    // Swap the pixels with another image (e.g. to publish a finished frame without a copy)
+    void swap(ImageCanvas& other) {
+        std::swap(imageWidth, other.imageWidth);
+        std::swap(imageHeight, other.imageHeight);
+        pixels.swap(other.pixels);
+    }
+
+    void line(int left1, int top1, int left2, int top2, unsigned int color, int style = 0) override {
+        (void)style;
+        // Bresenham
+        const int dx = abs(left2 - left1), sx = left1 < left2 ? 1 : -1;
+        const int dy = -abs(top2 - top1), sy = top1 < top2 ? 1 : -1;
+        int error = dx + dy;
+        while (true) {
+            plot(left1, top1, color);
+            if (left1 == left2 && top1 == top2) break;
+            const int e2 = 2 * error;
+            if (e2 >= dy) { error += dy; left1 += sx; }
+            if (e2 <= dx) { error += dx; top1 += sy; }
+        }
+    }
+
+    void circle(int left, int top, int radius, unsigned int color) override {
+        plotCircle(left, top, radius, false, color);
+    }
+
+    void circlef(int left, int top, int radius, unsigned int color) override {
+        plotCircle(left, top, radius, true, color);
+    }
+
+    void rect(int left, int top, int width, int height, unsigned int color) override {
+        if (width <= 0 || height <= 0) return;
+        fill(left, top, width, 1, color);
+        fill(left, top + height - 1, width, 1, color);
+        fill(left, top, 1, height, color);
+        fill(left + width - 1, top, 1, height, color);
+    }
+
+    void rectf(int left, int top, int width, int height, unsigned int color) override {
+        fill(left, top, width, height, color);
+    }
+
+    void text(int left, int top, const string& txt, unsigned int color, int font = 0, int size = 14) override {
+        (void)left;
+        (void)top;
+        (void)txt;
+        (void)color;
+        (void)font;
+        (void)size;
+    }
+
+    void measure(const string& text, int& width, int& height, int& descent, int font = 0, int size = 14) override {
+        (void)font;
+        width = (int)text.size() * size * 6 / 10;
+        height = size;
+        descent = size / 4;
+    }
+
+    int width() override { return imageWidth; }
+    int height() override { return imageHeight; }
+
+    void clear() override {
+        fill(0, 0, imageWidth, imageHeight, background);
+    }
+
+protected:
+    void plot(int x, int y, unsigned int color) {
+        if (x < 0 || y < 0 || x >= imageWidth || y >= imageHeight) return;
+        unsigned char* p = &pixels[((size_t)y * imageWidth + x) * 3];
+        p[0] = (color >> 16) & 0xFF;
+        p[1] = (color >> 8) & 0xFF;
+        p[2] = color & 0xFF;
+    }
+
+    void fill(int left, int top, int width, int height, unsigned int color) {
+        const int x1 = max(0, left), x2 = min(imageWidth, left + width);
+        const int y1 = max(0, top), y2 = min(imageHeight, top + height);
+        for (int y = y1; y < y2; y++)
+            for (int x = x1; x < x2; x++) plot(x, y, color);
+    }
+
+    void plotCircle(int left, int top, int radius, bool filled, unsigned int color) {
+        if (radius < 0) return;
+        const int outer = radius * radius + radius; // (r + 0.5)^2 rounded down
+        const int inner = radius * radius - radius; // (r - 0.5)^2 rounded up
+        for (int y = -radius; y <= radius; y++)
+            for (int x = -radius; x <= radius; x++) {
+                const int d = x * x + y * y;
+                if (d <= outer && (filled || d >= inner)) plot(left + x, top + y, color);
+            }
+    }
+
+    int imageWidth = 0;
+    int imageHeight = 0;
+    unsigned int background;
+    vector<unsigned char> pixels;
+};
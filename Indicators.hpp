@@ -0,0 +1,505 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "../trading/Candle.hpp"
+#include "TimePointSeries.hpp"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+const unsigned int INDICATOR_COLOR_DEFAULT = EGA_YELLOW;
+const unsigned int INDICATOR_COLOR_BAND = EGA_LIGHT_BLUE;
+
+// One input sample of an indicator (a candle, or a point as high = low = close)
+struct IndicatorSample {
+    time_sec time;
+    float high;
+    float low;
+    float close;
+    float volume;
+
+    IndicatorSample(const Candle& candle):
+        time(candle.getTime()),
+        high(candle.getHigh()),
+        low(candle.getLow()),
+        close(candle.getClose()),
+        volume(candle.getVolume())
+    {}
+
+    IndicatorSample(const TimePoint& point):
+        time(point.getTime()),
+        high(point.getValue()),
+        low(point.getValue()),
+        close(point.getValue()),
+        volume(0)
+    {}
+
+    // Samples with a NaN field (gaps) are skipped by the indicators, as by Chart::fitToPoints
+    bool isNan() const {
+        return isnan(high) || isnan(low) || isnan(close) || isnan(volume);
+    }
+};
+
+// Samples as contiguous columns (structure of arrays) for the bulk kernels, NaN samples left out
+struct IndicatorColumns {
+    vector<time_sec> times;
+    vector<float> high;
+    vector<float> low;
+    vector<float> close;
+    vector<float> volume;
+
+    template<typename T>
+    IndicatorColumns(const vector<T>& source, size_t count) {
+        times.reserve(count);
+        high.reserve(count);
+        low.reserve(count);
+        close.reserve(count);
+        volume.reserve(count);
+        for (size_t n = 0; n < count; n++) {
+            const IndicatorSample sample(source[n]);
+            if (sample.isNan()) continue;
+            times.push_back(sample.time);
+            high.push_back(sample.high);
+            low.push_back(sample.low);
+            close.push_back(sample.close);
+            volume.push_back(sample.volume);
+        }
+    }
+
+    size_t size() const { return times.size(); }
+};
+
+// Bulk kernels. The element-wise loops are branch free over plain arrays so the
+// compiler auto-vectorizes them (-O2/-O3), the scans stay scalar.
+class IndicatorKernels {
+public:
+    // out[n] = in[n - period + 1] + ... + in[n] for n >= period - 1 (out has in.size() elements)
+    static void rollingSum(const vector<double>& in, size_t period, vector<double>& out) {
+        const size_t count = in.size();
+        vector<double> prefix(count + 1);
+        prefix[0] = 0;
+        for (size_t n = 0; n < count; n++) prefix[n + 1] = prefix[n] + in[n]; // scan
+        out.assign(count, 0);
+        if (count < period) return;
+        const double* hi = prefix.data() + period;
+        const double* lo = prefix.data();
+        double* o = out.data() + period - 1;
+        const size_t windows = count - period + 1;
+        for (size_t n = 0; n < windows; n++) o[n] = hi[n] - lo[n]; // vectorized
+    }
+
+    static void widen(const vector<float>& in, vector<double>& out) {
+        out.resize(in.size());
+        const float* i = in.data();
+        double* o = out.data();
+        for (size_t n = 0; n < in.size(); n++) o[n] = i[n]; // vectorized
+    }
+
+    static void square(const vector<double>& in, vector<double>& out) {
+        out.resize(in.size());
+        const double* i = in.data();
+        double* o = out.data();
+        for (size_t n = 0; n < in.size(); n++) o[n] = i[n] * i[n]; // vectorized
+    }
+
+    static void scale(vector<double>& values, double factor) {
+        double* v = values.data();
+        for (size_t n = 0; n < values.size(); n++) v[n] *= factor; // vectorized
+    }
+};
+
+// Derives output series (e.g. a moving average) from a candle or point source and
+// keeps them up to date incrementally: update() only processes the samples appended
+// since the previous call. The last sample is provisional, it may still change in
+// place (a live candle), so the state is committed before it and rolled back on the
+// next update. A large backlog (first update of a long history) goes through the
+// bulk kernels instead of sample by sample. Samples with a NaN field are skipped,
+// they would poison the running sums of the windows.
+// If the source shrinks or its committed history changes, it is recomputed from scratch.
+class Indicator {
+public:
+    Indicator(const vector<unsigned int>& colors) {
+        for (unsigned int color: colors) outputs.push_back(TimePointSeries({}, color));
+    }
+
+    virtual ~Indicator() {}
+
+    size_t getOutputCount() const { return outputs.size(); }
+    const TimePointSeries& getOutput(size_t n) const { return outputs.at(n); }
+    const vector<TimePointSeries>& getOutputs() const { return outputs; }
+
+    // Samples at or after the start of the backlog that are computed in bulk
+    void setBulkThreshold(size_t bulkThreshold) { this->bulkThreshold = bulkThreshold; }
+
+    void update(const vector<Candle>& candles) { updateFrom(candles); }
+    void update(const vector<TimePoint>& points) { updateFrom(points); }
+
+    void reset() {
+        for (TimePointSeries& output: outputs) {
+            output.getPointsRef().clear();
+            output.changed();
+        }
+        committedCount = 0;
+        committedTime = 0;
+        committedOutputs = 0;
+        resetState();
+        commitState();
+    }
+
+    // The source changed in place from the given index on (see SeriesPatch): the next
+    // update() recomputes from scratch if committed samples changed, the provisional
+    // last sample is recomputed anyway
+    void changedFrom(size_t index) {
+        if (index < committedCount) reset();
+    }
+
+    // The source lost its first count samples, the first one left is at firstTime
+    // (e.g. a rolling history). The state only depends on the samples already seen,
+    // so it is kept, the outputs before firstTime are dropped instead of recomputed.
+    void dropHead(size_t count, time_sec firstTime) {
+        if (count == 0) return;
+        if (count >= committedCount) {
+            reset();
+            return;
+        }
+        committedCount -= count;
+        for (size_t n = 0; n < outputs.size(); n++) {
+            vector<TimePoint>& points = outputs[n].getPointsRef();
+            const size_t dropped = lower_bound(points.begin(), points.end(), firstTime,
+                [](const TimePoint& point, time_sec time) { return point.getTime() < time; }
+            ) - points.begin();
+            points.erase(points.begin(), points.begin() + dropped);
+            outputs[n].changed();
+            if (n == 0) committedOutputs -= min(dropped, committedOutputs);
+        }
+    }
+
+protected:
+    template<typename T>
+    void updateFrom(const vector<T>& source) {
+        const size_t count = source.size();
+        if (
+            count < committedCount ||
+            (committedCount > 0 && source[committedCount - 1].getTime() != committedTime)
+        ) reset();
+        if (count == 0) return;
+
+        // Back to the committed samples, drop the provisional outputs
+        rollbackState();
+        for (TimePointSeries& output: outputs) {
+            vector<TimePoint>& points = output.getPointsRef();
+            points.erase(points.begin() + committedOutputs, points.end());
+        }
+
+        size_t from = committedCount;
+        if (from == 0 && count - 1 >= bulkThreshold) {
+            bulk(IndicatorColumns(source, count - 1));
+            from = count - 1;
+        }
+        for (size_t n = from; n < count; n++) {
+            if (n == count - 1) commit(n, n > 0 ? source[n - 1].getTime() : 0);
+            const IndicatorSample sample(source[n]);
+            if (!sample.isNan()) step(sample);
+        }
+    }
+
+    void commit(size_t count, time_sec lastTime) {
+        committedCount = count;
+        committedTime = lastTime;
+        committedOutputs = outputs.empty() ? 0 : outputs[0].getPointsCRef().size();
+        commitState();
+    }
+
+    void emit(size_t output, time_sec time, double value) {
+        outputs[output].getPointsRef().push_back(TimePoint(time, (float)value));
+    }
+
+    // Process one sample, emit() the outputs once there are enough samples
+    virtual void step(const IndicatorSample& sample) = 0;
+
+    // Same as step() for each sample, on columns
+    virtual void bulk(const IndicatorColumns& columns) = 0;
+
+    virtual void resetState() = 0;
+    virtual void commitState() = 0;
+    virtual void rollbackState() = 0;
+
+    vector<TimePointSeries> outputs;
+    size_t bulkThreshold = 4096;
+    size_t committedCount = 0;
+    time_sec committedTime = 0;
+    size_t committedOutputs = 0;
+};
+
+// Keeps the state in a copyable struct, committed and rolled back by copy
+template<typename State>
+class StatefulIndicator: public Indicator {
+public:
+    StatefulIndicator(const vector<unsigned int>& colors): Indicator(colors) {}
+    virtual ~StatefulIndicator() {}
+
+protected:
+    void resetState() override { state = State(); }
+    void commitState() override { committed = state; }
+    void rollbackState() override { state = committed; }
+
+    State state;
+    State committed;
+};
+
+// Ring of the last period values with their running sum (and sum of squares)
+struct IndicatorWindow {
+    vector<double> values;
+    size_t head = 0;
+    double sum = 0;
+    double sumSquares = 0;
+
+    // Returns the value pushed out of the full window (0 while filling)
+    double push(double value, size_t period) {
+        double out = 0;
+        if (values.size() < period) values.push_back(value);
+        else {
+            out = values[head];
+            values[head] = value;
+            head = (head + 1) % period;
+        }
+        sum += value - out;
+        sumSquares += value * value - out * out;
+        return out;
+    }
+
+    // Refill from the tail of a column (after a bulk run)
+    void fill(const vector<double>& column, size_t period) {
+        const size_t from = column.size() > period ? column.size() - period : 0;
+        values.assign(column.begin() + from, column.end());
+        head = 0;
+        sum = 0;
+        sumSquares = 0;
+        for (double value: values) {
+            sum += value;
+            sumSquares += value * value;
+        }
+    }
+};
+
+// Simple moving average of the close
+class SmaIndicator: public StatefulIndicator<IndicatorWindow> {
+public:
+    SmaIndicator(size_t period, unsigned int color = INDICATOR_COLOR_DEFAULT):
+        StatefulIndicator({ color }), period(period)
+    {
+        if (period == 0) throw ERROR("Indicator period must be positive");
+    }
+
+protected:
+    void step(const IndicatorSample& sample) override {
+        state.push(sample.close, period);
+        if (state.values.size() == period) emit(0, sample.time, state.sum / period);
+    }
+
+    void bulk(const IndicatorColumns& columns) override {
+        vector<double> close, sums;
+        IndicatorKernels::widen(columns.close, close);
+        IndicatorKernels::rollingSum(close, period, sums);
+        IndicatorKernels::scale(sums, 1.0 / period);
+        for (size_t n = period - 1; n < sums.size(); n++) emit(0, columns.times[n], sums[n]);
+        state.fill(close, period);
+    }
+
+    size_t period;
+};
+
+// Bollinger bands: middle (SMA), upper and lower (middle +/- deviations * stddev)
+class BollingerIndicator: public StatefulIndicator<IndicatorWindow> {
+public:
+    BollingerIndicator(
+        size_t period = 20,
+        double deviations = 2.0,
+        unsigned int middleColor = INDICATOR_COLOR_DEFAULT,
+        unsigned int bandColor = INDICATOR_COLOR_BAND
+    ):
+        StatefulIndicator({ middleColor, bandColor, bandColor }),
+        period(period),
+        deviations(deviations)
+    {
+        if (period == 0) throw ERROR("Indicator period must be positive");
+    }
+
+protected:
+    void step(const IndicatorSample& sample) override {
+        state.push(sample.close, period);
+        if (state.values.size() == period)
+            emitBands(sample.time, state.sum, state.sumSquares);
+    }
+
+    void bulk(const IndicatorColumns& columns) override {
+        vector<double> close, squares, sums, squareSums;
+        IndicatorKernels::widen(columns.close, close);
+        IndicatorKernels::square(close, squares);
+        IndicatorKernels::rollingSum(close, period, sums);
+        IndicatorKernels::rollingSum(squares, period, squareSums);
+        for (size_t n = period - 1; n < sums.size(); n++) emitBands(columns.times[n], sums[n], squareSums[n]);
+        state.fill(close, period);
+    }
+
+    void emitBands(time_sec time, double sum, double sumSquares) {
+        const double mean = sum / period;
+        const double variance = sumSquares / period - mean * mean;
+        const double band = deviations * sqrt(variance > 0 ? variance : 0);
+        emit(0, time, mean);
+        emit(1, time, mean + band);
+        emit(2, time, mean - band);
+    }
+
+    size_t period;
+    double deviations;
+};
+
+struct EmaIndicatorState {
+    size_t count = 0;
+    double value = 0; // sum of the first period closes until seeded
+};
+
+// Exponential moving average of the close, seeded with the SMA of the first period
+class EmaIndicator: public StatefulIndicator<EmaIndicatorState> {
+public:
+    EmaIndicator(size_t period, unsigned int color = INDICATOR_COLOR_DEFAULT):
+        StatefulIndicator({ color }),
+        period(period),
+        alpha(2.0 / (period + 1))
+    {
+        if (period == 0) throw ERROR("Indicator period must be positive");
+    }
+
+protected:
+    void step(const IndicatorSample& sample) override {
+        advance(sample.time, sample.close);
+    }
+
+    // Recursive, no vector form: a tight loop over the column
+    void bulk(const IndicatorColumns& columns) override {
+        for (size_t n = 0; n < columns.size(); n++) advance(columns.times[n], columns.close[n]);
+    }
+
+    void advance(time_sec time, double close) {
+        state.count++;
+        if (state.count < period) {
+            state.value += close;
+            return;
+        }
+        if (state.count == period) state.value = (state.value + close) / period;
+        else state.value += alpha * (close - state.value);
+        emit(0, time, state.value);
+    }
+
+    size_t period;
+    double alpha;
+};
+
+struct RsiIndicatorState {
+    size_t count = 0;
+    double prevClose = 0;
+    double avgGain = 0; // sums of the first period changes until seeded
+    double avgLoss = 0;
+};
+
+// Relative strength index (Wilder's smoothing)
+class RsiIndicator: public StatefulIndicator<RsiIndicatorState> {
+public:
+    RsiIndicator(size_t period = 14, unsigned int color = INDICATOR_COLOR_DEFAULT):
+        StatefulIndicator({ color }), period(period)
+    {
+        if (period == 0) throw ERROR("Indicator period must be positive");
+    }
+
+protected:
+    void step(const IndicatorSample& sample) override {
+        advance(sample.time, sample.close);
+    }
+
+    // Recursive, no vector form: a tight loop over the column
+    void bulk(const IndicatorColumns& columns) override {
+        for (size_t n = 0; n < columns.size(); n++) advance(columns.times[n], columns.close[n]);
+    }
+
+    void advance(time_sec time, double close) {
+        const size_t count = state.count++;
+        const double change = close - state.prevClose;
+        state.prevClose = close;
+        if (count == 0) return;
+        const double gain = change > 0 ? change : 0;
+        const double loss = change < 0 ? -change : 0;
+        if (count < period) {
+            state.avgGain += gain;
+            state.avgLoss += loss;
+            return;
+        }
+        if (count == period) {
+            state.avgGain = (state.avgGain + gain) / period;
+            state.avgLoss = (state.avgLoss + loss) / period;
+        } else {
+            state.avgGain = (state.avgGain * (period - 1) + gain) / period;
+            state.avgLoss = (state.avgLoss * (period - 1) + loss) / period;
+        }
+        const double rsi = state.avgLoss == 0 ? 100 : 100 - 100 / (1 + state.avgGain / state.avgLoss);
+        emit(0, time, rsi);
+    }
+
+    size_t period;
+};
+
+struct VwapIndicatorState {
+    time_sec session = 0;
+    double priceVolume = 0;
+    double volume = 0;
+};
+
+// Volume weighted average of the typical price ((high + low + close) / 3),
+// anchored to sessions of sessionSeconds (0 = never reset)
+class VwapIndicator: public StatefulIndicator<VwapIndicatorState> {
+public:
+    VwapIndicator(time_sec sessionSeconds = 86400, unsigned int color = INDICATOR_COLOR_DEFAULT):
+        StatefulIndicator({ color }), sessionSeconds(sessionSeconds)
+    {
+        if (sessionSeconds < 0) throw ERROR("VWAP session length can not be negative");
+    }
+
+protected:
+    void step(const IndicatorSample& sample) override {
+        advance(sample.time, (sample.high + sample.low + sample.close) / 3.0, sample.volume);
+    }
+
+    void bulk(const IndicatorColumns& columns) override {
+        // Typical price, vectorized
+        const size_t count = columns.size();
+        vector<double> typical(count);
+        const float* high = columns.high.data();
+        const float* low = columns.low.data();
+        const float* close = columns.close.data();
+        double* t = typical.data();
+        for (size_t n = 0; n < count; n++) t[n] = ((double)high[n] + low[n] + close[n]) / 3.0;
+        for (size_t n = 0; n < count; n++) advance(columns.times[n], typical[n], columns.volume[n]);
+    }
+
+    void advance(time_sec time, double typical, double volume) {
+        const time_sec session = getSession(time);
+        if (session != state.session) {
+            state.session = session;
+            state.priceVolume = 0;
+            state.volume = 0;
+        }
+        state.priceVolume += typical * volume;
+        state.volume += volume;
+        if (state.volume > 0) emit(0, time, state.priceVolume / state.volume);
+    }
+
+    time_sec getSession(time_sec time) const {
+        if (sessionSeconds == 0) return 0;
+        time_sec start = time - time % sessionSeconds;
+        return start > time ? start - sessionSeconds : start;
+    }
+
+    time_sec sessionSeconds;
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include <vector>
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <cstdio>
+
+using namespace std;
+
+enum InteractionKind {
+    INTERACTION_WHEEL,
+    INTERACTION_DRAG,
+    INTERACTION_PUSH
+};
+
+inline const char* getInteractionKindName(InteractionKind kind) {
+    switch (kind) {
+        case INTERACTION_WHEEL: return "wheel";
+        case INTERACTION_DRAG: return "drag";
+        default: return "push";
+    }
+}
+
+// One input event reaching a chart box, the coordinates are the ones of the
+// Fl_CanvasBox callbacks (relative to the box)
+struct InteractionEvent {
+    InteractionKind kind;
+    double timeUs = 0;  // since the recording started
+    size_t chart = 0;   // index of the chart box in the recorded screen
+    int x = 0;
+    int y = 0;
+    int dx = 0;
+    int dy = 0;
+    int button = 0;
+};
+
+// Records the wheel, drag and push events of chart boxes (see
+// Fl_ChartBox::setInteractionRecorder) with their time, for a replay with
+// InteractionReplayer. The session file is CSV, one event per line:
+// kind,time_us,chart,x,y,dx,dy,button. Used from the UI thread only.
+class InteractionRecorder {
+public:
+    InteractionRecorder(): epoch(chrono::steady_clock::now()) {}
+    virtual ~InteractionRecorder() {}
+
+    // Forget the events recorded so far, the times start from now
+    void start() {
+        events.clear();
+        epoch = chrono::steady_clock::now();
+        recording = true;
+    }
+
+    void stop() { recording = false; }
+    bool isRecording() const { return recording; }
+
+    // Add an event of the given chart box, timed now
+    void record(InteractionEvent event, size_t chart) {
+        if (!recording) return;
+        event.timeUs = chrono::duration<double, micro>(chrono::steady_clock::now() - epoch).count();
+        event.chart = chart;
+        events.push_back(event);
+    }
+
+    const vector<InteractionEvent>& getEvents() const { return events; }
+
+    void save(ostream& out) const { write(out, events); }
+
+    void save(const string& filename) const {
+        ofstream file(filename);
+        if (!file) throw ERROR("Unable to create session file: " + filename);
+        write(file, events);
+        if (!file) throw ERROR("Unable to write session file: " + filename);
+    }
+
+    static void write(ostream& out, const vector<InteractionEvent>& events) {
+        out << "kind,time_us,chart,x,y,dx,dy,button\n";
+        char line[160];
+        for (const InteractionEvent& event: events) {
+            snprintf(
+                line, sizeof(line), "%s,%.1f,%zu,%d,%d,%d,%d,%d\n",
+                getInteractionKindName(event.kind), event.timeUs, event.chart,
+                event.x, event.y, event.dx, event.dy, event.button
+            );
+            out << line;
+        }
+    }
+
+    static vector<InteractionEvent> read(istream& in) {
+        vector<InteractionEvent> events;
+        string line;
+        size_t lineNumber = 0;
+        while (getline(in, line)) {
+            lineNumber++;
+            if (line.empty() || line.compare(0, 5, "kind,") == 0) continue;
+            char kind[16];
+            InteractionEvent event;
+            if (sscanf(
+                line.c_str(), "%15[^,],%lf,%zu,%d,%d,%d,%d,%d",
+                kind, &event.timeUs, &event.chart, &event.x, &event.y, &event.dx, &event.dy, &event.button
+            ) != 8) throw ERROR("Invalid session line " + to_string(lineNumber) + ": " + line);
+            const string name = kind;
+            if (name == "wheel") event.kind = INTERACTION_WHEEL;
+            else if (name == "drag") event.kind = INTERACTION_DRAG;
+            else if (name == "push") event.kind = INTERACTION_PUSH;
+            else throw ERROR("Invalid session event at line " + to_string(lineNumber) + ": " + name);
+            events.push_back(event);
+        }
+        return events;
+    }
+
+    static vector<InteractionEvent> load(const string& filename) {
+        ifstream file(filename);
+        if (!file) throw ERROR("Unable to open session file: " + filename);
+        return read(file);
+    }
+
+protected:
+    chrono::steady_clock::time_point epoch;
+    bool recording = false;
+    vector<InteractionEvent> events;
+};
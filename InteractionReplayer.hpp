@@ -0,0 +1,174 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "InteractionRecorder.hpp"
+#include "Fl_ImageChartBox.hpp"
+#include <FL/Fl.H>
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+
+// Percentiles of a set of durations, in microseconds (nearest rank)
+struct InteractionLatency {
+    size_t count = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double max = 0;
+    double mean = 0;
+
+    static InteractionLatency of(vector<double> durations) {
+        InteractionLatency latency;
+        latency.count = durations.size();
+        if (durations.empty()) return latency;
+        sort(durations.begin(), durations.end());
+        const auto percentile = [&durations](double p) {
+            const size_t rank = (size_t)ceil(p * durations.size());
+            return durations[rank > 0 ? rank - 1 : 0];
+        };
+        latency.p50 = percentile(0.5);
+        latency.p99 = percentile(0.99);
+        latency.max = durations.back();
+        double sum = 0;
+        for (double duration: durations) sum += duration;
+        latency.mean = sum / durations.size();
+        return latency;
+    }
+
+    string toJson() const {
+        stringstream ss;
+        ss << "{\"count\":" << count
+           << ",\"p50_us\":" << p50
+           << ",\"p99_us\":" << p99
+           << ",\"max_us\":" << max
+           << ",\"mean_us\":" << mean
+           << "}";
+        return ss.str();
+    }
+};
+
+struct InteractionReport {
+    string name;
+    size_t events = 0;
+    size_t frames = 0;
+    InteractionLatency handling;    // handling of an event by its chart box
+    InteractionLatency eventToFrame; // from the event (its recorded time in real time) to the end of its frame
+
+    // One JSON line, like the benchmark results
+    string toJson() const {
+        stringstream ss;
+        ss << "{\"name\":\"" << name << "\""
+           << ",\"events\":" << events
+           << ",\"frames\":" << frames
+           << ",\"handling\":" << handling.toJson()
+           << ",\"event_to_frame\":" << eventToFrame.toJson()
+           << "}";
+        return ss.str();
+    }
+};
+
+// Replays a recorded session (see InteractionRecorder) against chart boxes and
+// measures the input latency. Each event goes to apply(), then frame() draws.
+// As fast as possible (default): one frame per event, the replay is deterministic
+// and a frame is late by the handling and the drawing only.
+// In real time: the events are applied at their recorded time (scaled by the speed)
+// and all the ones due at once share a frame, as with the FLTK event loop, so a slow
+// frame delays the events behind it. The same session against the same data always
+// ends in the same views.
+class InteractionReplayer {
+public:
+    typedef function<void(const InteractionEvent&)> Apply;
+    typedef function<void()> Frame;
+
+    InteractionReplayer(Apply apply, Frame frame, bool realtime = false, double speed = 1):
+        apply(apply),
+        frame(frame),
+        realtime(realtime),
+        speed(speed)
+    {
+        if (!(speed > 0)) throw ERROR("Invalid replay speed");
+    }
+
+    virtual ~InteractionReplayer() {}
+
+    InteractionReport replay(const vector<InteractionEvent>& events, const string& name = "InteractionReplayer::replay") {
+        InteractionReport report;
+        report.name = name;
+        report.events = events.size();
+        vector<double> handling;
+        vector<double> eventToFrame;
+        handling.reserve(events.size());
+        eventToFrame.reserve(events.size());
+
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        const double firstUs = events.empty() ? 0 : events.front().timeUs;
+        size_t next = 0;
+        vector<chrono::steady_clock::time_point> pending; // the event times waiting for the frame
+        while (next < events.size()) {
+            pending.clear();
+            if (realtime) {
+                const chrono::steady_clock::time_point due = getDue(start, events[next].timeUs - firstUs);
+                this_thread::sleep_until(due);
+            }
+            do {
+                const chrono::steady_clock::time_point handled = chrono::steady_clock::now();
+                pending.push_back(realtime ? getDue(start, events[next].timeUs - firstUs) : handled);
+                apply(events[next]);
+                handling.push_back(getUs(handled, chrono::steady_clock::now()));
+                next++;
+            } while (realtime && next < events.size() && getDue(start, events[next].timeUs - firstUs) <= chrono::steady_clock::now());
+
+            if (frame) frame();
+            report.frames++;
+            const chrono::steady_clock::time_point drawn = chrono::steady_clock::now();
+            for (const chrono::steady_clock::time_point& time: pending) eventToFrame.push_back(getUs(time, drawn));
+        }
+
+        report.handling = InteractionLatency::of(handling);
+        report.eventToFrame = InteractionLatency::of(eventToFrame);
+        return report;
+    }
+
+    // Send each event to the chart box of its index (a ChartGroup keeps them in sync)
+    static Apply applyTo(const vector<Fl_ChartBox*>& chartBoxes) {
+        return [chartBoxes](const InteractionEvent& event) {
+            if (event.chart >= chartBoxes.size()) throw ERROR("No chart box for replayed chart " + to_string(event.chart));
+            chartBoxes[event.chart]->handleInteraction(event);
+        };
+    }
+
+    // Headless frame: render every chart box into its image
+    static Frame renderImages(const vector<Fl_ImageChartBox*>& chartBoxes) {
+        return [chartBoxes]() {
+            for (Fl_ImageChartBox* chartBox: chartBoxes) chartBox->render();
+        };
+    }
+
+    // LCOV_EXCL_START
+    // Coverage excluded - needs shown windows
+    // Window frame: draw the damaged widgets now, like the event loop does between events
+    static Frame flushWindows() {
+        return []() { Fl::flush(); };
+    }
+    // LCOV_EXCL_STOP
+
+protected:
+    chrono::steady_clock::time_point getDue(chrono::steady_clock::time_point start, double offsetUs) const {
+        return start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, micro>(offsetUs / speed));
+    }
+
+    static double getUs(chrono::steady_clock::time_point from, chrono::steady_clock::time_point to) {
+        return chrono::duration<double, micro>(to - from).count();
+    }
+
+    Apply apply;
+    Frame frame;
+    bool realtime;
+    double speed;
+};
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "WindowedPointSeries.hpp"
+#include "Indicators.hpp"
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <limits>
+
+using namespace std;
+
+// Indicator output computed on demand, only for the blocks of the source that
+// are viewed. A block of blockSize source samples is computed by a fresh
+// indicator fed from warmup samples before the block, so the output of a block
+// does not depend on anything older (for recursive indicators like EMA/RSI the
+// warmup sets the accuracy). Computed blocks are memoized in an LRU cache bounded
+// by cacheBytes; the block summaries are kept, they are small and make zoomed out
+// redraws free. Nothing is computed until the series is viewed.
+// The source is fetched through a getter so it may grow (the incomplete last
+// block is recomputed when new samples arrive); call invalidateFrom() if older
+// samples change, or invalidate() if the history was replaced. Not thread safe, Fl_ChartBox uses it from the UI thread only.
+template<typename T>
+class LazyIndicatorSeries: public WindowedPointSeries {
+public:
+    typedef function<const vector<T>&()> Source;
+    typedef function<shared_ptr<Indicator>()> Factory;
+
+    LazyIndicatorSeries(
+        Source source,
+        Factory factory,
+        size_t warmup,
+        size_t output = 0,
+        size_t blockSize = 2048,
+        size_t cacheBytes = 16 << 20
+    ):
+        WindowedPointSeries(factory()->getOutput(output).getColor()),
+        source(source),
+        factory(factory),
+        warmup(warmup),
+        output(output),
+        blockSize(blockSize),
+        cacheBytes(cacheBytes)
+    {
+        if (blockSize == 0) throw ERROR("Lazy indicator block size must be positive");
+    }
+
+    virtual ~LazyIndicatorSeries() {}
+
+    size_t getBlockSize() const { return blockSize; }
+    size_t getCachedBytes() const { return cachedBytes; }
+    size_t getCachedBlockCount() const { return cache.size(); }
+    size_t getComputedBlockCount() const { return computedBlocks; }
+    size_t getCacheHits() const override { return cacheHits; }
+    size_t getCacheMisses() const override { return computedBlocks; }
+
+    // Drop everything computed (e.g. the source history was replaced)
+    void invalidate() {
+        cache.clear();
+        lru.clear();
+        cachedBytes = 0;
+        summaries.clear();
+        summarySourceSizes.clear();
+        changed();
+    }
+
+    // The source changed from the given sample on (e.g. its tail was replaced): drop the
+    // blocks reading it, that is its block and the ones after (their warmup looks back),
+    // the blocks before keep their points and summaries
+    void invalidateFrom(size_t index) {
+        const size_t first = index / blockSize;
+        for (typename unordered_map<size_t, CachedBlock>::iterator it = cache.begin(); it != cache.end();) {
+            if (it->first < first) {
+                ++it;
+                continue;
+            }
+            cachedBytes -= it->second.points.size() * sizeof(TimePoint);
+            lru.erase(it->second.lru);
+            it = cache.erase(it);
+        }
+        if (summaries.size() > first) {
+            summaries.resize(first);
+            summarySourceSizes.resize(first);
+        }
+        lastSourceSize = min(lastSourceSize, index); // a shorter source is expected now
+        changed();
+    }
+
+    bool empty() const override { return source().empty(); }
+    time_sec getFirstTime() const override { return empty() ? 0 : source().front().getTime(); }
+    time_sec getLastTime() const override { return empty() ? 0 : source().back().getTime(); }
+    size_t size() const override { return source().size(); } // of the source, the outputs follow it
+
+    void getSummaries(time_sec first, time_sec last, vector<SeriesBlockSummary>& out) override {
+        out.clear();
+        size_t from, to;
+        getBlockRange(first, last, from, to);
+        for (size_t block = from; block < to; block++) {
+            if (!hasSummary(block)) (void)getBlock(block);
+            if (summaries[block].count > 0) out.push_back(summaries[block]);
+        }
+        evict();
+    }
+
+    void getPoints(time_sec first, time_sec last, vector<TimePoint>& out) override {
+        out.clear();
+        size_t from, to;
+        getBlockRange(first, last, from, to);
+        for (size_t block = from; block < to; block++) {
+            const vector<TimePoint>& points = getBlock(block);
+            out.insert(out.end(), points.begin(), points.end());
+        }
+        evict();
+    }
+
+protected:
+    struct CachedBlock {
+        vector<TimePoint> points;
+        size_t sourceSize; // samples of the source when computed (the last block may grow)
+        list<size_t>::iterator lru;
+    };
+
+    // Blocks [from, to) holding the source samples in [first, last]
+    void getBlockRange(time_sec first, time_sec last, size_t& from, size_t& to) {
+        const vector<T>& samples = source();
+        if (samples.size() < lastSourceSize) invalidate(); // source shrunk
+        lastSourceSize = samples.size();
+        const size_t begin = lower_bound(
+            samples.begin(), samples.end(), first,
+            [](const T& sample, time_sec t) { return sample.getTime() < t; }
+        ) - samples.begin();
+        const size_t end = upper_bound(
+            samples.begin(), samples.end(), last,
+            [](time_sec t, const T& sample) { return t < sample.getTime(); }
+        ) - samples.begin();
+        from = begin / blockSize;
+        to = end > begin ? (end - 1) / blockSize + 1 : from;
+    }
+
+    bool isComplete(size_t block, size_t sourceSize) const {
+        return (block + 1) * blockSize <= sourceSize;
+    }
+
+    bool hasSummary(size_t block) const {
+        if (block >= summarySourceSizes.size() || !summarySourceSizes[block]) return false;
+        const size_t sourceSize = summarySourceSizes[block];
+        return sourceSize == source().size() || isComplete(block, sourceSize);
+    }
+
+    // Points of a block from the cache or computed (moved to the front of the LRU list),
+    // the reference is valid until the next evict()
+    const vector<TimePoint>& getBlock(size_t block) {
+        const vector<T>& samples = source();
+        typename unordered_map<size_t, CachedBlock>::iterator found = cache.find(block);
+        if (found != cache.end()) {
+            CachedBlock& cached = found->second;
+            if (cached.sourceSize == samples.size() || isComplete(block, cached.sourceSize)) {
+                lru.splice(lru.begin(), lru, cached.lru);
+                cacheHits++;
+                return cached.points;
+            }
+            // The last block grew, compute it again
+            cachedBytes -= cached.points.size() * sizeof(TimePoint);
+            lru.erase(cached.lru);
+            cache.erase(found);
+        }
+
+        const size_t begin = block * blockSize;
+        const size_t end = min(samples.size(), begin + blockSize);
+        const size_t warmupBegin = begin > warmup ? begin - warmup : 0;
+        shared_ptr<Indicator> indicator = factory();
+        indicator->setBulkThreshold(0);
+        indicator->update(vector<T>(samples.begin() + warmupBegin, samples.begin() + end));
+        const vector<TimePoint>& outputs = indicator->getOutput(output).getPointsCRef();
+        const time_sec blockFirst = samples[begin].getTime();
+
+        CachedBlock& cached = cache[block];
+        cached.points.assign(
+            lower_bound(
+                outputs.begin(), outputs.end(), blockFirst,
+                [](const TimePoint& point, time_sec t) { return point.getTime() < t; }
+            ),
+            outputs.end()
+        );
+        cached.sourceSize = samples.size();
+        lru.push_front(block);
+        cached.lru = lru.begin();
+        cachedBytes += cached.points.size() * sizeof(TimePoint);
+        computedBlocks++;
+        summarize(block, cached.points, samples.size());
+        return cached.points;
+    }
+
+    void summarize(size_t block, const vector<TimePoint>& points, size_t sourceSize) {
+        while (summaries.size() <= block) {
+            summaries.push_back(SeriesBlockSummary());
+            summarySourceSizes.push_back(0);
+        }
+        summarySourceSizes[block] = sourceSize;
+        SeriesBlockSummary& summary = summaries[block];
+        summary.count = points.size();
+        summary.minValue = numeric_limits<float>::infinity();
+        summary.maxValue = -numeric_limits<float>::infinity();
+        if (points.empty()) return;
+        summary.first = points.front().getTime();
+        summary.last = points.back().getTime();
+        summary.firstValue = points.front().getValue();
+        summary.lastValue = points.back().getValue();
+        for (const TimePoint& point: points) {
+            const float value = point.getValue();
+            if (isnan(value)) continue;
+            if (value < summary.minValue) summary.minValue = value;
+            if (value > summary.maxValue) summary.maxValue = value;
+        }
+    }
+
+    // Drop the least recently used blocks until the cache fits into the budget
+    void evict() {
+        while (cachedBytes > cacheBytes && !lru.empty()) {
+            typename unordered_map<size_t, CachedBlock>::iterator found = cache.find(lru.back());
+            cachedBytes -= found->second.points.size() * sizeof(TimePoint);
+            cache.erase(found);
+            lru.pop_back();
+        }
+    }
+
+    Source source;
+    Factory factory;
+    size_t warmup;
+    size_t output;
+    size_t blockSize;
+    size_t cacheBytes;
+    unordered_map<size_t, CachedBlock> cache;
+    list<size_t> lru;
+    size_t cachedBytes = 0;
+    size_t computedBlocks = 0;
+    size_t cacheHits = 0;
+    vector<SeriesBlockSummary> summaries;
+    vector<size_t> summarySourceSizes; // source size when summarized, 0 = not computed yet
+    size_t lastSourceSize = 0;
+};
@@ -0,0 +1,337 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "WindowedPointSeries.hpp"
+#include <vector>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+// On-disk layout of a paged point series (native byte order):
+//   [chunk records...][index: PagedChunkIndex * chunkCount][footer: PagedFooter]
+// A chunk holds the points of one fixed time span (chunkSeconds) as
+// PagedPointRecord records, the index holds the file offset and the summary
+// of each chunk, so the summaries are available without reading any chunk.
+const uint32_t PAGED_SERIES_MAGIC = 0x53505047; // "GPPS"
+const uint32_t PAGED_SERIES_VERSION = 1;
+
+#pragma pack(push, 1)
+struct PagedPointRecord {
+    int64_t time;
+    float value;
+};
+
+struct PagedChunkIndex {
+    uint64_t offset;
+    uint64_t count;
+    int64_t first;
+    int64_t last;
+    float firstValue;
+    float lastValue;
+    float minValue;
+    float maxValue;
+};
+
+struct PagedFooter {
+    uint64_t indexOffset;
+    uint64_t chunkCount;
+    int64_t chunkSeconds;
+    uint32_t version;
+    uint32_t magic;
+};
+#pragma pack(pop)
+
+// Writes a paged point series file in one pass, points streamed in time order,
+// so the source does not have to fit into the memory either
+class PagedPointSeriesWriter {
+public:
+    PagedPointSeriesWriter(const string& filename, time_sec chunkSeconds = 86400):
+        filename(filename),
+        chunkSeconds(chunkSeconds)
+    {
+        if (chunkSeconds <= 0) throw ERROR("Paged chunk size must be positive");
+        fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw ERROR("Unable to create file: " + filename);
+    }
+
+    virtual ~PagedPointSeriesWriter() {
+        if (fd >= 0) close(fd); // unfinished file, without index
+    }
+
+    PagedPointSeriesWriter(const PagedPointSeriesWriter&) = delete;
+    PagedPointSeriesWriter& operator=(const PagedPointSeriesWriter&) = delete;
+
+    void append(const TimePoint& point) {
+        if (fd < 0) throw ERROR("Paged series already finished: " + filename);
+        const time_sec time = point.getTime();
+        const float value = point.getValue();
+        if (!index.empty() && time < index.back().last)
+            throw ERROR("Paged points must be appended in time order");
+
+        const time_sec chunk = getChunkStart(time);
+        if (index.empty() || getChunkStart(index.back().first) != chunk) {
+            flushRecords();
+            PagedChunkIndex entry;
+            entry.offset = offset;
+            entry.count = 0;
+            entry.first = time;
+            entry.firstValue = value;
+            entry.minValue = numeric_limits<float>::infinity();
+            entry.maxValue = -numeric_limits<float>::infinity();
+            index.push_back(entry);
+        }
+
+        PagedChunkIndex& entry = index.back();
+        entry.last = time;
+        entry.lastValue = value;
+        if (!isnan(value)) {
+            if (value < entry.minValue) entry.minValue = value;
+            if (value > entry.maxValue) entry.maxValue = value;
+        }
+        entry.count++;
+
+        records.push_back({ (int64_t)time, value });
+        if (records.size() >= recordBufferSize) flushRecords();
+    }
+
+    void append(const vector<TimePoint>& points) {
+        for (const TimePoint& point: points) append(point);
+    }
+
+    // Write the index and the footer, the file is usable after this
+    void finish() {
+        if (fd < 0) return;
+        flushRecords();
+        PagedFooter footer;
+        footer.indexOffset = offset;
+        footer.chunkCount = index.size();
+        footer.chunkSeconds = chunkSeconds;
+        footer.version = PAGED_SERIES_VERSION;
+        footer.magic = PAGED_SERIES_MAGIC;
+        writeAll(index.data(), index.size() * sizeof(PagedChunkIndex));
+        writeAll(&footer, sizeof(footer));
+        close(fd);
+        fd = -1;
+    }
+
+    // Floor to the chunk span, negative times included
+    time_sec getChunkStart(time_sec time) const {
+        time_sec start = time - time % chunkSeconds;
+        return start > time ? start - chunkSeconds : start;
+    }
+
+protected:
+    static constexpr size_t recordBufferSize = 1 << 16;
+
+    void flushRecords() {
+        writeAll(records.data(), records.size() * sizeof(PagedPointRecord));
+        records.clear();
+    }
+
+    void writeAll(const void* data, size_t size) {
+        const char* bytes = (const char*)data;
+        while (size > 0) {
+            ssize_t written = write(fd, bytes, size);
+            if (written <= 0) throw ERROR("Unable to write file: " + filename);
+            bytes += written;
+            size -= written;
+            offset += written;
+        }
+    }
+
+    string filename;
+    time_sec chunkSeconds;
+    int fd = -1;
+    uint64_t offset = 0;
+    vector<PagedChunkIndex> index;
+    vector<PagedPointRecord> records;
+};
+
+// Point series paged in from a file written by PagedPointSeriesWriter.
+// Only the index (one summary per chunk) is resident, chunks are read on
+// demand into an LRU cache bounded by cacheBytes. Zoomed out views are served
+// from the chunk summaries alone; zoomed in views load the chunks overlapping
+// the view and prefetch marginChunks chunks on both sides, so scrolling finds
+// its neighbours in the cache.
+// Not thread safe, Fl_ChartBox uses it from one thread at a time (the UI thread,
+// or a RenderPool worker while the UI thread waits for the prepared fit).
+class PagedPointSeries: public WindowedPointSeries {
+public:
+    PagedPointSeries(
+        const string& filename,
+        unsigned int color = CHART_COLOR_PLOTTER,
+        size_t cacheBytes = 64 << 20,
+        size_t marginChunks = 1
+    ):
+        WindowedPointSeries(color),
+        filename(filename),
+        cacheBytes(cacheBytes),
+        marginChunks(marginChunks)
+    {
+        fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw ERROR("Unable to open file: " + filename);
+        try {
+            readIndex();
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+    }
+
+    virtual ~PagedPointSeries() {
+        close(fd);
+    }
+
+    PagedPointSeries(const PagedPointSeries&) = delete;
+    PagedPointSeries& operator=(const PagedPointSeries&) = delete;
+
+    size_t getChunkCount() const { return summaries.size(); }
+    time_sec getChunkSeconds() const { return chunkSeconds; }
+    size_t getCacheBytes() const { return cacheBytes; }
+    size_t getCachedBytes() const { return cachedBytes; }
+    size_t getCachedChunkCount() const { return cache.size(); }
+    size_t getChunkLoadCount() const { return chunkLoads; }
+    size_t getCacheHits() const override { return cacheHits; }
+    size_t getCacheMisses() const override { return chunkLoads; }
+
+    void setCacheBytes(size_t cacheBytes) {
+        this->cacheBytes = cacheBytes;
+        evict();
+    }
+
+    bool empty() const override { return summaries.empty(); }
+    time_sec getFirstTime() const override { return summaries.empty() ? 0 : summaries.front().first; }
+    time_sec getLastTime() const override { return summaries.empty() ? 0 : summaries.back().last; }
+    size_t size() const override { return pointCount; }
+
+    void getSummaries(time_sec first, time_sec last, vector<SeriesBlockSummary>& out) override {
+        out.clear();
+        for (size_t n = findSummaryIndex(summaries, first); n < summaries.size() && summaries[n].first <= last; n++)
+            out.push_back(summaries[n]);
+    }
+
+    void getPoints(time_sec first, time_sec last, vector<TimePoint>& out) override {
+        out.clear();
+        const size_t from = findSummaryIndex(summaries, first);
+        size_t to = from;
+        while (to < summaries.size() && summaries[to].first <= last) to++;
+
+        // Margins first, so the chunks of the view are the most recently used
+        for (size_t n = from - min(from, marginChunks); n < from; n++) (void)getChunk(n);
+        for (size_t n = to; n < min(summaries.size(), to + marginChunks); n++) (void)getChunk(n);
+
+        size_t total = 0;
+        for (size_t n = from; n < to; n++) total += summaries[n].count;
+        out.reserve(total);
+        for (size_t n = from; n < to; n++) {
+            const vector<PagedPointRecord>& records = getChunk(n);
+            for (const PagedPointRecord& record: records)
+                out.push_back(TimePoint((time_sec)record.time, record.value));
+        }
+        evict();
+    }
+
+protected:
+    struct CachedChunk {
+        vector<PagedPointRecord> records;
+        list<size_t>::iterator lru;
+    };
+
+    void readIndex() {
+        const off_t size = lseek(fd, 0, SEEK_END);
+        if (size < (off_t)sizeof(PagedFooter)) throw ERROR("Invalid paged series file: " + filename);
+        PagedFooter footer;
+        readAll(&footer, sizeof(footer), size - sizeof(footer));
+        if (footer.magic != PAGED_SERIES_MAGIC) throw ERROR("Invalid paged series file: " + filename);
+        if (footer.version != PAGED_SERIES_VERSION) throw ERROR("Unsupported paged series version: " + filename);
+        if (
+            footer.chunkSeconds <= 0 ||
+            footer.indexOffset + footer.chunkCount * sizeof(PagedChunkIndex) + sizeof(PagedFooter) != (uint64_t)size
+        ) throw ERROR("Corrupted paged series file: " + filename);
+        chunkSeconds = (time_sec)footer.chunkSeconds;
+
+        vector<PagedChunkIndex> index(footer.chunkCount);
+        readAll(index.data(), index.size() * sizeof(PagedChunkIndex), footer.indexOffset);
+        offsets.reserve(index.size());
+        summaries.reserve(index.size());
+        for (const PagedChunkIndex& entry: index) {
+            if (entry.offset + entry.count * sizeof(PagedPointRecord) > footer.indexOffset)
+                throw ERROR("Corrupted paged series file: " + filename);
+            offsets.push_back(entry.offset);
+            SeriesBlockSummary summary;
+            summary.first = (time_sec)entry.first;
+            summary.last = (time_sec)entry.last;
+            summary.firstValue = entry.firstValue;
+            summary.lastValue = entry.lastValue;
+            summary.minValue = entry.minValue;
+            summary.maxValue = entry.maxValue;
+            summary.count = (size_t)entry.count;
+            summaries.push_back(summary);
+            pointCount += summary.count;
+        }
+    }
+
+    void readAll(void* data, size_t size, off_t offset) {
+        char* bytes = (char*)data;
+        while (size > 0) {
+            ssize_t got = pread(fd, bytes, size, offset);
+            if (got <= 0) throw ERROR("Unable to read file: " + filename);
+            bytes += got;
+            size -= got;
+            offset += got;
+        }
+    }
+
+    // Chunk from the cache (moved to the front of the LRU list) or from the file,
+    // the reference is valid until the next evict(). A chunk is cached once it was
+    // read as a whole, a failed read throws and leaves the cache as it was.
+    const vector<PagedPointRecord>& getChunk(size_t n) {
+        unordered_map<size_t, CachedChunk>::iterator found = cache.find(n);
+        if (found != cache.end()) {
+            lru.splice(lru.begin(), lru, found->second.lru);
+            cacheHits++;
+            return found->second.records;
+        }
+        vector<PagedPointRecord> records(summaries[n].count);
+        readAll(records.data(), records.size() * sizeof(PagedPointRecord), offsets[n]);
+        CachedChunk& chunk = cache[n];
+        chunk.records.swap(records);
+        lru.push_front(n);
+        chunk.lru = lru.begin();
+        cachedBytes += chunk.records.size() * sizeof(PagedPointRecord);
+        chunkLoads++;
+        return chunk.records;
+    }
+
+    // Drop the least recently used chunks until the cache fits into the budget
+    void evict() {
+        while (cachedBytes > cacheBytes && !lru.empty()) {
+            unordered_map<size_t, CachedChunk>::iterator found = cache.find(lru.back());
+            cachedBytes -= found->second.records.size() * sizeof(PagedPointRecord);
+            cache.erase(found);
+            lru.pop_back();
+        }
+    }
+
+    string filename;
+    int fd = -1;
+    time_sec chunkSeconds = 0;
+    size_t cacheBytes;
+    size_t marginChunks;
+    vector<uint64_t> offsets;
+    vector<SeriesBlockSummary> summaries;
+    unordered_map<size_t, CachedChunk> cache;
+    list<size_t> lru;
+    size_t cachedBytes = 0;
+    size_t chunkLoads = 0;
+    size_t pointCount = 0;
+    size_t cacheHits = 0;
+};
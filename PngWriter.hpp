@@ -0,0 +1,228 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "ImageCanvas.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+// Minimal PNG encoder for RGB images (8 bit, no interlace), no zlib needed.
+// Rows are filtered with "Up" (background rows become zeros), then deflated
+// with the fixed Huffman codes and byte runs only (distance 1), which is
+// fast and shrinks the mostly flat chart images well.
+class PngWriter {
+public:
+    // Encode 3 bytes per pixel, rows top down, into out (replaced)
+    static void encode(const unsigned char* rgb, int width, int height, vector<unsigned char>& out) {
+        if (width <= 0 || height <= 0) throw ERROR("Invalid PNG image size");
+        out.clear();
+        static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        out.insert(out.end(), signature, signature + 8);
+
+        unsigned char header[13];
+        putBigEndian(header, (uint32_t)width);
+        putBigEndian(header + 4, (uint32_t)height);
+        header[8] = 8;  // bit depth
+        header[9] = 2;  // color type: RGB
+        header[10] = 0; // compression
+        header[11] = 0; // filter
+        header[12] = 0; // interlace
+        addChunk(out, "IHDR", header, sizeof(header));
+
+        // Filtered scanlines: filter type byte, then the row (Up: minus the row above).
+        // The buffers are kept per thread, a batch encodes many images of the same size.
+        const size_t rowBytes = (size_t)width * 3;
+        thread_local vector<unsigned char> filtered;
+        thread_local vector<unsigned char> compressed;
+        filtered.resize((rowBytes + 1) * height);
+        unsigned char* to = filtered.data();
+        for (int y = 0; y < height; y++) {
+            const unsigned char* row = rgb + (size_t)y * rowBytes;
+            *to++ = y ? 2 : 0;
+            if (!y) memcpy(to, row, rowBytes);
+            else for (size_t n = 0; n < rowBytes; n++) to[n] = (unsigned char)(row[n] - row[n - rowBytes]);
+            to += rowBytes;
+        }
+
+        deflate(filtered, compressed);
+        addChunk(out, "IDAT", compressed.data(), compressed.size());
+        addChunk(out, "IEND", nullptr, 0);
+    }
+
+    static void encode(const ImageCanvas& image, vector<unsigned char>& out) {
+        ImageCanvas& canvas = const_cast<ImageCanvas&>(image); // width()/height() of Canvas are not const
+        encode(image.getData(), canvas.width(), canvas.height(), out);
+    }
+
+    static void write(const string& filename, const vector<unsigned char>& png) {
+        FILE* file = fopen(filename.c_str(), "wb");
+        if (!file) throw ERROR("Unable to create file: " + filename);
+        const size_t written = fwrite(png.data(), 1, png.size(), file);
+        const bool closed = fclose(file) == 0;
+        if (written != png.size() || !closed) throw ERROR("Unable to write file: " + filename);
+    }
+
+    static void write(const string& filename, const ImageCanvas& image) {
+        vector<unsigned char> png;
+        encode(image, png);
+        write(filename, png);
+    }
+
+    static uint32_t getCrc32(const unsigned char* data, size_t size, uint32_t crc = 0) {
+        static uint32_t table[256];
+        static bool tableReady = [] {
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                table[n] = c;
+            }
+            return true;
+        }();
+        (void)tableReady;
+        crc = ~crc;
+        for (size_t n = 0; n < size; n++) crc = table[(crc ^ data[n]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    static uint32_t getAdler32(const unsigned char* data, size_t size) {
+        uint32_t a = 1, b = 0;
+        while (size > 0) {
+            const size_t block = min(size, (size_t)5552); // no 32 bit overflow before the modulo
+            for (size_t n = 0; n < block; n++) {
+                a += data[n];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+            data += block;
+            size -= block;
+        }
+        return (b << 16) | a;
+    }
+
+protected:
+    // Writes bits LSB first, as deflate wants them
+    struct BitWriter {
+        vector<unsigned char>& out;
+        uint32_t bits = 0;
+        int count = 0;
+
+        BitWriter(vector<unsigned char>& out): out(out) {}
+
+        void put(uint32_t value, int length) {
+            bits |= value << count;
+            count += length;
+            while (count >= 8) {
+                out.push_back(bits & 0xFF);
+                bits >>= 8;
+                count -= 8;
+            }
+        }
+
+        // Huffman codes go MSB first
+        void putCode(uint32_t code, int length) {
+            uint32_t reversed = 0;
+            for (int n = 0; n < length; n++) reversed |= ((code >> n) & 1) << (length - 1 - n);
+            put(reversed, length);
+        }
+
+        void flush() {
+            if (count > 0) out.push_back(bits & 0xFF);
+            bits = 0;
+            count = 0;
+        }
+    };
+
+    // Fixed Huffman code of a literal/length symbol, bit reversed once into a table
+    static void putLiteral(BitWriter& writer, int value) {
+        struct Code {
+            uint16_t bits;
+            uint8_t length;
+        };
+        static Code codes[288];
+        static bool codesReady = [] {
+            for (int symbol = 0; symbol < 288; symbol++) {
+                uint32_t code;
+                int length;
+                if (symbol < 144) { code = 0x30 + symbol; length = 8; }
+                else if (symbol < 256) { code = 0x190 + symbol - 144; length = 9; }
+                else if (symbol < 280) { code = symbol - 256; length = 7; }
+                else { code = 0xC0 + symbol - 280; length = 8; }
+                uint32_t reversed = 0;
+                for (int n = 0; n < length; n++) reversed |= ((code >> n) & 1) << (length - 1 - n);
+                codes[symbol] = { (uint16_t)reversed, (uint8_t)length };
+            }
+            return true;
+        }();
+        (void)codesReady;
+        writer.put(codes[value].bits, codes[value].length);
+    }
+
+    // Match of length 3..258 at distance 1
+    static void putRun(BitWriter& writer, int length) {
+        static const int bases[29] = {
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+        };
+        static const int extras[29] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+        };
+        int code = 28;
+        while (bases[code] > length) code--;
+        putLiteral(writer, 257 + code);
+        if (extras[code]) writer.put(length - bases[code], extras[code]);
+        writer.putCode(0, 5); // distance code 0: distance 1
+    }
+
+    // zlib stream: one final block with the fixed Huffman codes
+    static void deflate(const vector<unsigned char>& data, vector<unsigned char>& out) {
+        out.clear();
+        out.reserve(data.size() / 8);
+        out.push_back(0x78); // deflate, 32K window
+        out.push_back(0x01); // no preset dictionary, fastest
+        BitWriter writer(out);
+        writer.put(1, 1); // final block
+        writer.put(1, 2); // fixed Huffman
+        size_t n = 0;
+        while (n < data.size()) {
+            putLiteral(writer, data[n]);
+            const unsigned char value = data[n++];
+            size_t run = 0;
+            while (n + run < data.size() && run < 258 && data[n + run] == value) run++;
+            if (run >= 3) {
+                putRun(writer, (int)run);
+                n += run;
+            }
+        }
+        putLiteral(writer, 256); // end of block
+        writer.flush();
+        unsigned char adler[4];
+        putBigEndian(adler, getAdler32(data.data(), data.size()));
+        out.insert(out.end(), adler, adler + 4);
+    }
+
+    static void addChunk(vector<unsigned char>& out, const char* type, const unsigned char* data, size_t size) {
+        unsigned char length[4];
+        putBigEndian(length, (uint32_t)size);
+        out.insert(out.end(), length, length + 4);
+        const size_t typeAt = out.size();
+        out.insert(out.end(), type, type + 4);
+        if (size) out.insert(out.end(), data, data + size);
+        unsigned char crc[4];
+        putBigEndian(crc, getCrc32(out.data() + typeAt, 4 + size));
+        out.insert(out.end(), crc, crc + 4);
+    }
+
+    static void putBigEndian(unsigned char* to, uint32_t value) {
+        to[0] = value >> 24;
+        to[1] = (value >> 16) & 0xFF;
+        to[2] = (value >> 8) & 0xFF;
+        to[3] = value & 0xFF;
+    }
+};
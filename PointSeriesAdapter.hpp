@@ -0,0 +1,141 @@
+#pragma once
+
+#include "PointView.hpp"
+#include "Chart.hpp"
+#include <vector>
+#include <functional>
+#include <memory>
+#include <limits>
+
+using namespace std;
+
+// Point (line) or bar series drawn straight from data kept elsewhere, e.g. the
+// closes or the volumes of a candle series, through a PointView: nothing is
+// copied, a volume pane under a big candle chart costs no TimePoints at all.
+// Fl_ChartBox keeps them shared like the windowed serieses.
+class PointSeriesAdapter {
+public:
+    PointSeriesAdapter(unsigned int color = CHART_COLOR_PLOTTER, bool bars = false):
+        color(color),
+        bars(bars)
+    {}
+
+    virtual ~PointSeriesAdapter() {}
+
+    unsigned int getColor() const { return color; }
+    bool isBars() const { return bars; }
+
+    virtual size_t size() const = 0;
+
+    // Time of the first and the last point, false if there is none
+    virtual bool getTimeRange(time_sec& first, time_sec& last) const = 0;
+
+    // Fit the chart to all the points (see Chart::fitToPoints)
+    virtual void fit(Chart& chart) const = 0;
+
+    // Index range [from, to) of the points in the view (see Chart::getVisibleRange)
+    virtual void getVisibleRange(const Chart& chart, size_t& from, size_t& to) const = 0;
+
+    // Lowest and highest value in the view, false if there is none
+    virtual bool getVisibleValueRange(const Chart& chart, float& lower, float& upper) const = 0;
+
+    // Time of the point a tail redraw from the given time starts at: the last vertex
+    // of the full draw before it (see Chart::getPointsTailFrom), or the time itself
+    virtual time_sec getTailTime(const Chart& chart, time_sec time) const = 0;
+
+    // Draw the points from the given time to the end of the view
+    virtual void show(Chart& chart, time_sec from) const = 0;
+
+protected:
+    unsigned int color;
+    bool bars;
+};
+
+// The series of a PointView over a source, the source is fetched through a getter
+// at each call so it may grow or move (e.g. a candle series held by a chart box)
+template<typename T, typename TimeOf, typename ValueOf>
+class PointViewSeries: public PointSeriesAdapter {
+public:
+    typedef function<const vector<T>&()> Source;
+    typedef PointView<T, TimeOf, ValueOf> View;
+
+    PointViewSeries(
+        Source source,
+        TimeOf timeOf = TimeOf(),
+        ValueOf valueOf = ValueOf(),
+        unsigned int color = CHART_COLOR_PLOTTER,
+        bool bars = false
+    ):
+        PointSeriesAdapter(color, bars),
+        source(source),
+        timeOf(timeOf),
+        valueOf(valueOf)
+    {}
+
+    virtual ~PointViewSeries() {}
+
+    View getView() const { return View(source(), timeOf, valueOf); }
+
+    size_t size() const override { return source().size(); }
+
+    bool getTimeRange(time_sec& first, time_sec& last) const override {
+        const View view = getView();
+        if (view.empty()) return false;
+        first = view[0].getTime();
+        last = view[view.size() - 1].getTime();
+        return true;
+    }
+
+    void fit(Chart& chart) const override { chart.fitToPoints(getView()); }
+
+    void getVisibleRange(const Chart& chart, size_t& from, size_t& to) const override {
+        chart.getVisibleRange(getView(), from, to);
+    }
+
+    bool getVisibleValueRange(const Chart& chart, float& lower, float& upper) const override {
+        const View view = getView();
+        size_t from, to;
+        chart.getVisibleRange(view, from, to);
+        lower = numeric_limits<float>::infinity();
+        upper = -numeric_limits<float>::infinity();
+        for (size_t n = from; n < to; n++) {
+            const float value = view[n].getValue();
+            if (isnan(value)) continue;
+            if (value < lower) lower = value;
+            if (value > upper) upper = value;
+        }
+        return lower <= upper;
+    }
+
+    time_sec getTailTime(const Chart& chart, time_sec time) const override {
+        const View view = getView();
+        const size_t n = chart.getPointsTailFrom(view, chart.findTimeIndex(view, chart.getViewFirst()), chart.findTimeIndex(view, time));
+        return n < view.size() ? min(view[n].getTime(), time) : time;
+    }
+
+    void show(Chart& chart, time_sec from) const override {
+        const View view = getView();
+        const size_t first = chart.findTimeIndex(view, max(from, chart.getViewFirst()));
+        const size_t last = chart.findTimeIndex(view, chart.getViewLast() + 1);
+        if (first >= last) return;
+        if (bars) chart.showBarsRange(view, first, last, color);
+        else chart.showPointsRange(view, first, last, color);
+    }
+
+protected:
+    Source source;
+    TimeOf timeOf;
+    ValueOf valueOf;
+};
+
+typedef PointViewSeries<Candle, CandleTimeOf, CandleFieldOf> CandleFieldSeries;
+
+// One field of candles as a line or as bars (e.g. the volumes under the candles)
+inline shared_ptr<CandleFieldSeries> makeCandleFieldSeries(
+    CandleFieldSeries::Source source,
+    CandleField field,
+    unsigned int color = CHART_COLOR_PLOTTER,
+    bool bars = false
+) {
+    return make_shared<CandleFieldSeries>(source, CandleTimeOf(), CandleFieldOf(field), color, bars);
+}
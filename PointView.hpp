@@ -0,0 +1,79 @@
+#pragma once
+
+#include "TimePoint.hpp"
+#include "../trading/Candle.hpp"
+#include <vector>
+
+using namespace std;
+
+// Time sorted items of any type seen as TimePoints, without copying them: the
+// n-th point is made from items[n] by the time and value accessors when asked.
+// The Chart point functions (fitToPoints, showPointsRange, showBarsRange, ...)
+// take it in place of a vector<TimePoint>. Only the reference of the vector is
+// kept, so the view follows the items as they grow (but must not outlive them).
+template<typename T, typename TimeOf, typename ValueOf>
+class PointView {
+public:
+    PointView(const vector<T>& items, TimeOf timeOf = TimeOf(), ValueOf valueOf = ValueOf()):
+        items(items),
+        timeOf(timeOf),
+        valueOf(valueOf)
+    {}
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+
+    TimePoint operator[](size_t n) const {
+        const T& item = items[n];
+        return TimePoint(timeOf(item), valueOf(item));
+    }
+
+    const vector<T>& getItems() const { return items; }
+
+protected:
+    const vector<T>& items;
+    TimeOf timeOf;
+    ValueOf valueOf;
+};
+
+// View of user data with accessor functions (or lambdas), e.g.
+// makePointView(trades, [](const Trade& t) { return t.time; }, [](const Trade& t) { return t.price; })
+template<typename T, typename TimeOf, typename ValueOf>
+PointView<T, TimeOf, ValueOf> makePointView(const vector<T>& items, TimeOf timeOf, ValueOf valueOf) {
+    return PointView<T, TimeOf, ValueOf>(items, timeOf, valueOf);
+}
+
+enum CandleField {
+    CANDLE_FIELD_OPEN,
+    CANDLE_FIELD_HIGH,
+    CANDLE_FIELD_LOW,
+    CANDLE_FIELD_CLOSE,
+    CANDLE_FIELD_VOLUME
+};
+
+struct CandleTimeOf {
+    time_sec operator()(const Candle& candle) const { return candle.getTime(); }
+};
+
+struct CandleFieldOf {
+    CandleField field = CANDLE_FIELD_CLOSE;
+
+    CandleFieldOf(CandleField field = CANDLE_FIELD_CLOSE): field(field) {}
+
+    float operator()(const Candle& candle) const {
+        switch (field) {
+            case CANDLE_FIELD_OPEN: return candle.getOpen();
+            case CANDLE_FIELD_HIGH: return candle.getHigh();
+            case CANDLE_FIELD_LOW: return candle.getLow();
+            case CANDLE_FIELD_VOLUME: return candle.getVolume();
+            default: return candle.getClose();
+        }
+    }
+};
+
+// One field of candles as points, e.g. the closes as a line or the volumes as bars
+typedef PointView<Candle, CandleTimeOf, CandleFieldOf> CandleFieldView;
+
+inline CandleFieldView viewCandleField(const vector<Candle>& candles, CandleField field) {
+    return CandleFieldView(candles, CandleTimeOf(), CandleFieldOf(field));
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "../misc/Canvas.hpp"
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <cstddef>
+
+using namespace std;
+
+enum CanvasPrimitive {
+    CANVAS_LINE,
+    CANVAS_CIRCLE,
+    CANVAS_CIRCLEF,
+    CANVAS_RECT,
+    CANVAS_RECTF,
+    CANVAS_TEXT,
+    CANVAS_CLEAR,
+    CANVAS_PRIMITIVE_COUNT
+};
+
+inline const char* getCanvasPrimitiveName(CanvasPrimitive primitive) {
+    static const char* names[CANVAS_PRIMITIVE_COUNT] = {
+        "line", "circle", "circlef", "rect", "rectf", "text", "clear"
+    };
+    return primitive < CANVAS_PRIMITIVE_COUNT ? names[primitive] : "unknown";
+}
+
+// One recorded drawing call, the coordinates are the arguments of the call:
+// line: left, top -> left2, top2; rect(f) and text: left, top, width, height
+// (text size measured by the target); circle(f): center left, top and radius
+struct CanvasCommand {
+    CanvasPrimitive primitive;
+    int left = 0;
+    int top = 0;
+    int left2 = 0;
+    int top2 = 0;
+    int width = 0;
+    int height = 0;
+    int radius = 0;
+    unsigned int color = 0;
+    int style = 0;
+    string text;
+};
+
+// Canvas decorator: forwards every call to the target canvas and counts the
+// calls by primitive and color. Optionally records the command stream and
+// rasterizes the primitives (no antialiasing, clipped to the canvas) to
+// estimate the overdraw: pixels touched / distinct pixels covered.
+// Meant for draw call regression tests, e.g. an upper bound of the lines
+// showPoints() may emit per pixel of width.
+class RecordingCanvas: public Canvas {
+public:
+    RecordingCanvas(Canvas& target, bool recording = false, bool overdrawTracking = false):
+        target(target),
+        recording(recording),
+        overdrawTracking(overdrawTracking)
+    {}
+
+    virtual ~RecordingCanvas() {}
+
+    // Wrapping another RecordingCanvas needs a Canvas& (static_cast), not a copy
+    RecordingCanvas(const RecordingCanvas&) = delete;
+    RecordingCanvas& operator=(const RecordingCanvas&) = delete;
+
+    void line(int left1, int top1, int left2, int top2, unsigned int color, int style = 0) override {
+        CanvasCommand command = makeCommand(CANVAS_LINE, left1, top1, color);
+        command.left2 = left2;
+        command.top2 = top2;
+        command.style = style;
+        add(command);
+        if (overdrawTracking) plotLine(left1, top1, left2, top2);
+        target.line(left1, top1, left2, top2, color, style);
+    }
+
+    void circle(int left, int top, int radius, unsigned int color) override {
+        CanvasCommand command = makeCommand(CANVAS_CIRCLE, left, top, color);
+        command.radius = radius;
+        add(command);
+        if (overdrawTracking) plotCircle(left, top, radius, false);
+        target.circle(left, top, radius, color);
+    }
+
+    void circlef(int left, int top, int radius, unsigned int color) override {
+        CanvasCommand command = makeCommand(CANVAS_CIRCLEF, left, top, color);
+        command.radius = radius;
+        add(command);
+        if (overdrawTracking) plotCircle(left, top, radius, true);
+        target.circlef(left, top, radius, color);
+    }
+
+    void rect(int left, int top, int width, int height, unsigned int color) override {
+        CanvasCommand command = makeCommand(CANVAS_RECT, left, top, color);
+        command.width = width;
+        command.height = height;
+        add(command);
+        if (overdrawTracking) plotRect(left, top, width, height, false);
+        target.rect(left, top, width, height, color);
+    }
+
+    void rectf(int left, int top, int width, int height, unsigned int color) override {
+        CanvasCommand command = makeCommand(CANVAS_RECTF, left, top, color);
+        command.width = width;
+        command.height = height;
+        add(command);
+        if (overdrawTracking) plotRect(left, top, width, height, true);
+        target.rectf(left, top, width, height, color);
+    }
+
+    void text(int left, int top, const string& txt, unsigned int color, int font = 0, int size = 14) override {
+        CanvasCommand command = makeCommand(CANVAS_TEXT, left, top, color);
+        int descent;
+        target.measure(txt, command.width, command.height, descent, font, size);
+        command.text = txt;
+        add(command);
+        if (overdrawTracking) plotRect(left, top, command.width, command.height, true);
+        target.text(left, top, txt, color, font, size);
+    }
+
+    void measure(const string& text, int& width, int& height, int& descent, int font = 0, int size = 14) override {
+        target.measure(text, width, height, descent, font, size);
+    }
+
+    int width() override { return target.width(); }
+    int height() override { return target.height(); }
+
+    void clear() override {
+        add(makeCommand(CANVAS_CLEAR, 0, 0, 0));
+        target.clear();
+    }
+
+    void setRecording(bool recording) { this->recording = recording; }
+    bool isRecording() const { return recording; }
+
+    void setOverdrawTracking(bool overdrawTracking) { this->overdrawTracking = overdrawTracking; }
+    bool isOverdrawTracking() const { return overdrawTracking; }
+
+    size_t getCount(CanvasPrimitive primitive) const { return counts[primitive]; }
+
+    size_t getCount(CanvasPrimitive primitive, unsigned int color) const {
+        map<pair<CanvasPrimitive, unsigned int>, size_t>::const_iterator found = colorCounts.find({ primitive, color });
+        return found == colorCounts.end() ? 0 : found->second;
+    }
+
+    // Calls of any primitive in the given color
+    size_t getColorCount(unsigned int color) const {
+        size_t count = 0;
+        for (int primitive = 0; primitive < CANVAS_CLEAR; primitive++)
+            count += getCount((CanvasPrimitive)primitive, color);
+        return count;
+    }
+
+    // Drawing calls (clear() not included)
+    size_t getPrimitives() const {
+        size_t count = 0;
+        for (int primitive = 0; primitive < CANVAS_CLEAR; primitive++) count += counts[primitive];
+        return count;
+    }
+
+    // Drawing calls per pixel of the canvas width
+    double getPrimitivesPerPixel() {
+        const int canvasWidth = width();
+        return canvasWidth > 0 ? (double)getPrimitives() / canvasWidth : 0;
+    }
+
+    const vector<CanvasCommand>& getCommands() const { return commands; }
+
+    size_t getPixelsTouched() const { return pixelsTouched; }
+    size_t getPixelsCovered() const { return pixelsCovered; }
+
+    // Average number of times a covered pixel was painted (1 = no overdraw)
+    double getOverdraw() const {
+        return pixelsCovered ? (double)pixelsTouched / pixelsCovered : 0;
+    }
+
+    void reset() {
+        for (size_t& count: counts) count = 0;
+        colorCounts.clear();
+        commands.clear();
+        pixelsTouched = 0;
+        pixelsCovered = 0;
+        coverage.clear();
+    }
+
+protected:
+    CanvasCommand makeCommand(CanvasPrimitive primitive, int left, int top, unsigned int color) const {
+        CanvasCommand command;
+        command.primitive = primitive;
+        command.left = left;
+        command.top = top;
+        command.color = color;
+        return command;
+    }
+
+    void add(const CanvasCommand& command) {
+        counts[command.primitive]++;
+        if (command.primitive != CANVAS_CLEAR) colorCounts[{ command.primitive, command.color }]++;
+        if (recording) commands.push_back(command);
+    }
+
+    void plot(int x, int y) {
+        const int canvasWidth = target.width();
+        const int canvasHeight = target.height();
+        if (x < 0 || y < 0 || x >= canvasWidth || y >= canvasHeight) return;
+        if (coverage.size() != (size_t)canvasWidth * canvasHeight) {
+            coverage.assign((size_t)canvasWidth * canvasHeight, false);
+            pixelsCovered = 0;
+        }
+        pixelsTouched++;
+        vector<bool>::reference covered = coverage[(size_t)y * canvasWidth + x];
+        if (!covered) {
+            covered = true;
+            pixelsCovered++;
+        }
+    }
+
+    // Bresenham
+    void plotLine(int x1, int y1, int x2, int y2) {
+        const int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+        const int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+        int error = dx + dy;
+        while (true) {
+            plot(x1, y1);
+            if (x1 == x2 && y1 == y2) break;
+            const int e2 = 2 * error;
+            if (e2 >= dy) { error += dy; x1 += sx; }
+            if (e2 <= dx) { error += dx; y1 += sy; }
+        }
+    }
+
+    void plotRect(int left, int top, int width, int height, bool filled) {
+        if (width <= 0 || height <= 0) return;
+        for (int y = top; y < top + height; y++) {
+            const bool edge = y == top || y == top + height - 1;
+            for (int x = left; x < left + width; x++)
+                if (filled || edge || x == left || x == left + width - 1) plot(x, y);
+        }
+    }
+
+    void plotCircle(int left, int top, int radius, bool filled) {
+        if (radius < 0) return;
+        const int outer = radius * radius + radius; // (r + 0.5)^2 rounded down
+        const int inner = radius * radius - radius; // (r - 0.5)^2 rounded up
+        for (int y = -radius; y <= radius; y++)
+            for (int x = -radius; x <= radius; x++) {
+                const int d = x * x + y * y;
+                if (d <= outer && (filled || d >= inner)) plot(left + x, top + y);
+            }
+    }
+
+    Canvas& target;
+    bool recording;
+    bool overdrawTracking;
+    size_t counts[CANVAS_PRIMITIVE_COUNT] = {};
+    map<pair<CanvasPrimitive, unsigned int>, size_t> colorCounts;
+    vector<CanvasCommand> commands;
+    size_t pixelsTouched = 0;
+    size_t pixelsCovered = 0;
+    vector<bool> coverage;
+};
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>
+
+using namespace std;
+
+// Lower value runs first
+enum RenderPriority {
+    RENDER_PRIORITY_FOCUSED,    // the chart the user interacts with
+    RENDER_PRIORITY_VISIBLE,    // charts in the viewport
+    RENDER_PRIORITY_BACKGROUND, // charts around the viewport (prefetch)
+    RENDER_PRIORITY_COUNT
+};
+
+// A job submitted to a RenderPool, shared by the pool and the submitter.
+// Cancelled before it started, it is skipped; a running job sees the
+// cancellation through isCancelled() and may stop early.
+class RenderJob {
+public:
+    typedef function<void(const RenderJob& job)> Work;
+
+    RenderJob(Work work, RenderPriority priority): work(work), priority(priority) {}
+
+    virtual ~RenderJob() {}
+
+    void cancel() { cancelled = true; }
+    bool isCancelled() const { return cancelled; }
+    bool isStarted() const { return claimed; }
+    bool isDone() const { return done; }
+    RenderPriority getPriority() const { return priority; }
+
+    // Runs the work once (whoever claims it first: a worker or a waiting thread)
+    // returns false if it was claimed already
+    bool run() {
+        bool expected = false;
+        if (!claimed.compare_exchange_strong(expected, true)) return false;
+        if (!cancelled) {
+            try {
+                work(*this);
+            } catch (...) {
+                error = current_exception();
+            }
+        }
+        work = nullptr; // release what the work holds
+        lock_guard<mutex> lock(doneMutex);
+        done = true;
+        doneCondition.notify_all();
+        return true;
+    }
+
+    // Block until done, rethrow the exception of the work if any
+    void waitDone() {
+        unique_lock<mutex> lock(doneMutex);
+        doneCondition.wait(lock, [this]() { return done.load(); });
+        if (error) rethrow_exception(error);
+    }
+
+    // Block until done or timeout, returns isDone()
+    bool waitDoneFor(chrono::microseconds timeout) {
+        unique_lock<mutex> lock(doneMutex);
+        return doneCondition.wait_for(lock, timeout, [this]() { return done.load(); });
+    }
+
+    void rethrowError() const {
+        if (error) rethrow_exception(error);
+    }
+
+protected:
+    Work work;
+    RenderPriority priority;
+    atomic<bool> cancelled{false};
+    atomic<bool> claimed{false};
+    atomic<bool> done{false};
+    exception_ptr error = nullptr;
+    mutex doneMutex;
+    condition_variable doneCondition;
+};
+
+// Work stealing thread pool for the chart preparation jobs (fit, cull, decimate).
+// Each worker has its own queue per priority, submit() deals the jobs round robin.
+// A worker takes the highest priority job of its own queue first (newest first),
+// then steals the highest priority one of the others (oldest first).
+// wait() doesn't just block: the waiting thread (usually the UI thread) runs the
+// awaited job itself if no worker started it yet, and other queued jobs meanwhile.
+class RenderPool {
+public:
+    // threads = 0: one per core, the waiting thread being one of the cores
+    RenderPool(size_t threads = 0) {
+        if (!threads) {
+            const size_t cores = thread::hardware_concurrency();
+            threads = cores > 1 ? cores - 1 : 1;
+        }
+        for (size_t n = 0; n < threads; n++) queues.push_back(make_unique<Queue>());
+        for (size_t n = 0; n < threads; n++) workers.push_back(thread([this, n]() { work(n); }));
+    }
+
+    virtual ~RenderPool() {
+        {
+            lock_guard<mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCondition.notify_all();
+        for (thread& worker: workers) worker.join();
+    }
+
+    RenderPool(const RenderPool&) = delete;
+    RenderPool& operator=(const RenderPool&) = delete;
+
+    // The pool the charts of the process share
+    static RenderPool& getInstance() {
+        static RenderPool pool;
+        return pool;
+    }
+
+    size_t getThreadCount() const { return workers.size(); }
+    size_t getStealCount() const { return steals; }
+    size_t getPendingCount() {
+        lock_guard<mutex> lock(sleepMutex);
+        return pending;
+    }
+
+    shared_ptr<RenderJob> submit(RenderJob::Work work, RenderPriority priority = RENDER_PRIORITY_VISIBLE) {
+        shared_ptr<RenderJob> job = make_shared<RenderJob>(work, priority);
+        Queue& queue = *queues[next++ % queues.size()];
+        {
+            lock_guard<mutex> lock(queue.jobsMutex);
+            queue.jobs[priority].push_back(job);
+        }
+        {
+            lock_guard<mutex> lock(sleepMutex);
+            pending++;
+        }
+        sleepCondition.notify_one();
+        return job;
+    }
+
+    // Wait for a job, helping with the queued ones meanwhile; rethrows the error of the job
+    void wait(const shared_ptr<RenderJob>& job) {
+        if (!job) return;
+        while (!job->isDone()) {
+            if (job->run()) break; // nobody started it, run it here
+            shared_ptr<RenderJob> other = take(0, false);
+            if (other) {
+                other->run();
+                continue;
+            }
+            job->waitDoneFor(chrono::microseconds(200)); // running on a worker
+        }
+        job->waitDone();
+    }
+
+    void waitAll(const vector<shared_ptr<RenderJob>>& jobs) {
+        // Highest priority first, so the focused chart is ready the soonest
+        for (int priority = 0; priority < RENDER_PRIORITY_COUNT; priority++)
+            for (const shared_ptr<RenderJob>& job: jobs)
+                if (job && job->getPriority() == priority) wait(job);
+    }
+
+protected:
+    struct Queue {
+        mutex jobsMutex;
+        deque<shared_ptr<RenderJob>> jobs[RENDER_PRIORITY_COUNT];
+    };
+
+    // Highest priority job: of the own queue (newest) or stolen from the others (oldest)
+    shared_ptr<RenderJob> take(size_t own, bool hasOwn) {
+        for (int priority = 0; priority < RENDER_PRIORITY_COUNT; priority++) {
+            if (hasOwn) {
+                shared_ptr<RenderJob> job = pop(*queues[own], priority, true);
+                if (job) return job;
+            }
+            for (size_t n = hasOwn ? 1 : 0; n < queues.size(); n++) {
+                shared_ptr<RenderJob> job = pop(*queues[(own + n) % queues.size()], priority, false);
+                if (!job) continue;
+                if (hasOwn) steals++;
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    shared_ptr<RenderJob> pop(Queue& queue, int priority, bool newest) {
+        shared_ptr<RenderJob> job;
+        {
+            lock_guard<mutex> lock(queue.jobsMutex);
+            deque<shared_ptr<RenderJob>>& jobs = queue.jobs[priority];
+            if (jobs.empty()) return nullptr;
+            if (newest) {
+                job = jobs.back();
+                jobs.pop_back();
+            } else {
+                job = jobs.front();
+                jobs.pop_front();
+            }
+        }
+        lock_guard<mutex> lock(sleepMutex);
+        pending--;
+        return job;
+    }
+
+    void work(size_t own) {
+        while (true) {
+            shared_ptr<RenderJob> job = take(own, true);
+            if (job) {
+                job->run();
+                continue;
+            }
+            unique_lock<mutex> lock(sleepMutex);
+            sleepCondition.wait(lock, [this]() { return stopping || pending > 0; });
+            if (stopping) return;
+        }
+    }
+
+    vector<unique_ptr<Queue>> queues;
+    vector<thread> workers;
+    atomic<size_t> next{0};
+    atomic<size_t> steals{0};
+    mutex sleepMutex;
+    condition_variable sleepCondition;
+    size_t pending = 0;
+    bool stopping = false;
+};
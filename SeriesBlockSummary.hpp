@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../misc/datetime_defs.hpp"
+#include <cstddef>
+
+// Summary of a block of consecutive points, enough to draw a zoomed out view
+// without touching the points themselves
+struct SeriesBlockSummary {
+    time_sec first;     // time of the first point
+    time_sec last;      // time of the last point
+    float firstValue;
+    float lastValue;
+    float minValue;     // NaN values are ignored, infinity if there is no valid value
+    float maxValue;
+    size_t count;
+};
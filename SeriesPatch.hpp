@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "TimePoint.hpp"
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// In place change of a time sorted series (candles or points), instead of a
+// full copy: drop samples at the head (a rolling history), replace samples at
+// the tail (e.g. the live candle) and append new ones. The tail is replaced by
+// dropping replaceTail samples and appending, so replacing the last candle is
+// { 0, 1, { candle } }. Fl_ChartBox::patch*Series apply it to an attached
+// series and update only what depends on the changed range.
+template<typename T>
+struct SeriesPatch {
+    size_t truncateHead = 0; // samples dropped at the start
+    size_t replaceTail = 0;  // samples dropped at the end, before the append
+    vector<T> append;        // samples added at the end, time sorted, not before the kept ones
+
+    bool empty() const { return !truncateHead && !replaceTail && append.empty(); }
+
+    // Check the patch against the series it is about to change, throws if it doesn't fit
+    void validate(const vector<T>& items) const {
+        if (truncateHead + replaceTail > items.size()) throw ERROR("Series patch drops more samples than the series has");
+        for (size_t n = 1; n < append.size(); n++)
+            if (append[n].getTime() < append[n - 1].getTime()) throw ERROR("Series patch appends unsorted samples");
+        const size_t kept = items.size() - replaceTail;
+        if (!append.empty() && kept > truncateHead && append.front().getTime() < items[kept - 1].getTime())
+            throw ERROR("Series patch appends samples before the end of the series");
+    }
+
+    // Change the series, returns the index (in the patched series) of the first changed
+    // sample, the new size if only the head was dropped
+    size_t apply(vector<T>& items) const {
+        validate(items);
+        if (truncateHead) items.erase(items.begin(), items.begin() + truncateHead);
+        items.erase(items.end() - replaceTail, items.end());
+        items.insert(items.end(), append.begin(), append.end());
+        return items.size() - append.size();
+    }
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../misc/Canvas.hpp"
+#include <string>
+
+using namespace std;
+
+// A rectangle of another canvas, seen as a canvas of its own: the coordinates
+// are shifted by left/top and the size is the one of the rectangle, so a Chart
+// drawn on it lands in that rectangle (e.g. one of the charts of an image).
+// Nothing is clipped, the chart keeps inside its canvas by itself.
+class SubCanvas: public Canvas {
+public:
+    SubCanvas(Canvas& target, int left, int top, int width, int height):
+        target(target), left(left), top(top), subWidth(width), subHeight(height)
+    {}
+
+    virtual ~SubCanvas() {}
+
+    void setRect(int left, int top, int width, int height) {
+        this->left = left;
+        this->top = top;
+        subWidth = width;
+        subHeight = height;
+    }
+
+    int getLeft() const { return left; }
+    int getTop() const { return top; }
+
+    void line(int left1, int top1, int left2, int top2, unsigned int color, int style = 0) override {
+        target.line(left + left1, top + top1, left + left2, top + top2, color, style);
+    }
+
+    void circle(int left, int top, int radius, unsigned int color) override {
+        target.circle(this->left + left, this->top + top, radius, color);
+    }
+
+    void circlef(int left, int top, int radius, unsigned int color) override {
+        target.circlef(this->left + left, this->top + top, radius, color);
+    }
+
+    void rect(int left, int top, int width, int height, unsigned int color) override {
+        target.rect(this->left + left, this->top + top, width, height, color);
+    }
+
+    void rectf(int left, int top, int width, int height, unsigned int color) override {
+        target.rectf(this->left + left, this->top + top, width, height, color);
+    }
+
+    void text(int left, int top, const string& txt, unsigned int color, int font = 0, int size = 14) override {
+        target.text(this->left + left, this->top + top, txt, color, font, size);
+    }
+
+    void measure(const string& text, int& width, int& height, int& descent, int font = 0, int size = 14) override {
+        target.measure(text, width, height, descent, font, size);
+    }
+
+    int width() override { return subWidth; }
+    int height() override { return subHeight; }
+
+    // Does nothing, the clear() of the target would wipe the whole canvas
+    void clear() override {}
+
+protected:
+    Canvas& target;
+    int left;
+    int top;
+    int subWidth;
+    int subHeight;
+};
@@ -2,9 +2,16 @@
 
 #include "TimePoint.hpp"
 #include "Chart.hpp"
+#include <atomic>
+#include <utility>
 
 using namespace std;
 
+// The id identifies the points for the DecimationCache: copies of a series (e.g.
+// the same price line added to the chart boxes of a group) share it until one of
+// them is written, the written one gets a new id then. Taking the points by
+// getPointsRef() counts as a write, call changed() when changing them in place
+// through a reference kept from before.
 class TimePointSeries {
 public:
     TimePointSeries(
@@ -12,16 +19,57 @@ public:
         unsigned int color = CHART_COLOR_PLOTTER
     ):
         points(points),
-        color(color)
+        color(color),
+        id(getNextId())
     {}
 
+    TimePointSeries(const TimePointSeries&) = default;
+    TimePointSeries& operator=(const TimePointSeries&) = default;
+
+    // The moved-from series is left with other points, so with another id
+    TimePointSeries(TimePointSeries&& other) noexcept:
+        points(move(other.points)),
+        color(other.color),
+        id(other.id),
+        version(other.version)
+    {
+        other.id = getNextId();
+    }
+
+    TimePointSeries& operator=(TimePointSeries&& other) noexcept {
+        if (this == &other) return *this;
+        points = move(other.points);
+        color = other.color;
+        id = other.id;
+        version = other.version;
+        other.id = getNextId();
+        return *this;
+    }
+
     virtual ~TimePointSeries() {}
 
-    vector<TimePoint>& getPointsRef() { return points; }
+    vector<TimePoint>& getPointsRef() {
+        changed();
+        return points;
+    }
     const vector<TimePoint>& getPointsCRef() const { return points; }
     unsigned int getColor() const { return color; }
 
+    size_t getId() const { return id; }
+    size_t getVersion() const { return version; }
+    void changed() {
+        id = getNextId(); // apart from the copies now
+        version++;
+    }
+
 protected:
+    static size_t getNextId() {
+        static atomic<size_t> nextId(1);
+        return nextId++;
+    }
+
     vector<TimePoint> points;
     unsigned int color = CHART_COLOR_PLOTTER;
+    size_t id;
+    size_t version = 0;
 };
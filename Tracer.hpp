@@ -0,0 +1,175 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <ostream>
+#include <cstdio>
+
+using namespace std;
+
+// One recorded event, names and categories are string literals (not copied)
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    char phase;         // 'X': complete span, 'i': instant
+    double startUs;     // since the tracer was created
+    double durationUs;
+    size_t thread;      // small id per thread, in the order of their first event
+};
+
+// Opt-in timeline of spans in the Chrome trace event format, loadable in
+// chrome://tracing or Perfetto from the written file. Disabled (the default)
+// a span costs one atomic load. Thread safe, worker threads (async loads)
+// get their own track. Recording stops at maxEvents, the rest is counted as dropped.
+class Tracer {
+public:
+    Tracer(size_t maxEvents = 1 << 20): maxEvents(maxEvents), epoch(chrono::steady_clock::now()) {}
+
+    virtual ~Tracer() {}
+
+    // The tracer the charts and the UI record into
+    static Tracer& getInstance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void setEnabled(bool enabled) { this->enabled = enabled; }
+    bool isEnabled() const { return enabled; }
+
+    void setMaxEvents(size_t maxEvents) {
+        lock_guard<mutex> lock(eventsMutex);
+        this->maxEvents = maxEvents;
+    }
+
+    double getNowUs() const {
+        return chrono::duration<double, micro>(chrono::steady_clock::now() - epoch).count();
+    }
+
+    void addSpan(const char* name, const char* category, double startUs, double durationUs) {
+        add({ name, category, 'X', startUs, durationUs, 0 });
+    }
+
+    void addInstant(const char* name, const char* category) {
+        if (!enabled) return;
+        add({ name, category, 'i', getNowUs(), 0, 0 });
+    }
+
+    vector<TraceEvent> getEvents() const {
+        lock_guard<mutex> lock(eventsMutex);
+        return events;
+    }
+
+    size_t getDroppedCount() const { return dropped; }
+
+    void clear() {
+        lock_guard<mutex> lock(eventsMutex);
+        events.clear();
+        dropped = 0;
+    }
+
+    // {"traceEvents":[...]} with microsecond timestamps, one event per line
+    void writeChromeTrace(ostream& out) const {
+        vector<TraceEvent> snapshot = getEvents();
+        out << "{\"traceEvents\":[";
+        for (size_t n = 0; n < snapshot.size(); n++) {
+            const TraceEvent& event = snapshot[n];
+            char timing[96];
+            if (event.phase == 'X')
+                snprintf(timing, sizeof(timing), "\"ts\":%.3f,\"dur\":%.3f", event.startUs, event.durationUs);
+            else
+                snprintf(timing, sizeof(timing), "\"ts\":%.3f,\"s\":\"t\"", event.startUs);
+            out << (n ? ",\n" : "\n")
+                << "{\"name\":\"" << escape(event.name) << "\""
+                << ",\"cat\":\"" << escape(event.category) << "\""
+                << ",\"ph\":\"" << event.phase << "\""
+                << "," << timing
+                << ",\"pid\":1,\"tid\":" << event.thread << "}";
+        }
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    void writeChromeTrace(const string& filename) const {
+        ofstream file(filename);
+        if (!file) throw ERROR("Unable to create trace file: " + filename);
+        writeChromeTrace(file);
+        if (!file) throw ERROR("Unable to write trace file: " + filename);
+    }
+
+protected:
+    void add(TraceEvent event) {
+        lock_guard<mutex> lock(eventsMutex);
+        if (events.size() >= maxEvents) {
+            dropped++;
+            return;
+        }
+        event.thread = getThreadId();
+        events.push_back(event);
+    }
+
+    // Called with the events locked
+    size_t getThreadId() {
+        const thread::id id = this_thread::get_id();
+        map<thread::id, size_t>::const_iterator found = threads.find(id);
+        if (found != threads.end()) return found->second;
+        const size_t next = threads.size() + 1;
+        threads[id] = next;
+        return next;
+    }
+
+    static string escape(const char* text) {
+        string escaped;
+        for (const char* c = text ? text : ""; *c; c++) {
+            if (*c == '"' || *c == '\\') escaped += '\\';
+            if ((unsigned char)*c < 0x20) {
+                char code[8];
+                snprintf(code, sizeof(code), "\\u%04x", (unsigned char)*c);
+                escaped += code;
+                continue;
+            }
+            escaped += *c;
+        }
+        return escaped;
+    }
+
+    atomic<bool> enabled{false};
+    size_t maxEvents;
+    chrono::steady_clock::time_point epoch;
+    mutable mutex eventsMutex;
+    vector<TraceEvent> events;
+    map<thread::id, size_t> threads;
+    atomic<size_t> dropped{0};
+};
+
+// Records its scope as a span into the tracer, if the tracer was enabled when it started
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category = "chart", Tracer& tracer = Tracer::getInstance()):
+        tracer(tracer),
+        name(name),
+        category(category),
+        active(tracer.isEnabled())
+    {
+        if (active) startUs = tracer.getNowUs();
+    }
+
+    virtual ~TraceSpan() {
+        if (active) tracer.addSpan(name, category, startUs, tracer.getNowUs() - startUs);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+protected:
+    Tracer& tracer;
+    const char* name;
+    const char* category;
+    bool active;
+    double startUs = 0;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "../misc/datetime_defs.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Gap-compressed (trading time) X-axis: bar times are mapped to their ordinal
+// index, so overnight sessions and weekends take no space on the screen.
+// Between two bars the time is interpolated over at most one interval, the rest
+// of a gap collapses to the next bar; before the first and after the last bar
+// the axis continues with the interval. Both directions are O(log n).
+// A Chart projects through the axis when it is set (see Chart::setTimeAxis),
+// ChartGroup shares one axis between its charts. The bars are the candle times
+// of the charts, bar and point serieses are projected onto them.
+class TradingTimeAxis {
+public:
+    TradingTimeAxis(time_sec interval): interval(interval) {
+        if (interval <= 0) throw ERROR("Trading time axis interval must be positive");
+    }
+
+    virtual ~TradingTimeAxis() {}
+
+    time_sec getInterval() const { return interval; }
+    size_t size() const { return times.size(); }
+    bool empty() const { return times.empty(); }
+    const vector<time_sec>& getTimes() const { return times; }
+
+    void clear() { times.clear(); }
+
+    // Add a bar time: appended when newer than the last one, merged in place when
+    // older (e.g. from another series of the group), ignored when already known
+    // (e.g. an updated last candle)
+    void addTime(time_sec time) {
+        if (times.empty() || time > times.back()) {
+            times.push_back(time);
+            return;
+        }
+        vector<time_sec>::iterator found = lower_bound(times.begin(), times.end(), time);
+        if (*found != time) times.insert(found, time);
+    }
+
+    // Add the bar times of time sorted items. The ones newer than the last time are
+    // appended walking back from the end, the older ones are merged if any is missing
+    // (checked in one pass, no allocation when all are known), so it stays cheap to
+    // call on every draw of a growing series.
+    template<typename T>
+    void addTimes(const vector<T>& items) {
+        size_t from = items.size();
+        while (from > 0 && (times.empty() || items[from - 1].getTime() > times.back())) from--;
+        if (from > 0 && !containsTimes(items, from)) mergeTimes(items, from);
+        for (size_t n = from; n < items.size(); n++) addTime(items[n].getTime());
+    }
+
+    double timeToOrdinal(time_sec time) const {
+        if (times.empty()) return (double)time / interval;
+        if (time < times.front()) return (double)(time - times.front()) / interval;
+        const size_t n = upper_bound(times.begin(), times.end(), time) - times.begin() - 1;
+        if (n + 1 == times.size()) return n + (double)(time - times[n]) / interval;
+        const time_sec span = min(times[n + 1] - times[n], interval);
+        return n + min(1.0, (double)(time - times[n]) / span);
+    }
+
+    time_sec ordinalToTime(double ordinal) const {
+        if (times.empty()) return (time_sec)llround(ordinal * interval);
+        if (ordinal < 0) return times.front() + (time_sec)llround(ordinal * interval);
+        const double last = (double)(times.size() - 1);
+        if (ordinal >= last) return times.back() + (time_sec)llround((ordinal - last) * interval);
+        const size_t n = (size_t)ordinal;
+        const time_sec span = min(times[n + 1] - times[n], interval);
+        return times[n] + (time_sec)llround((ordinal - n) * span);
+    }
+
+protected:
+    // All times of items[0..count) are on the axis (both sides sorted, one pass)
+    template<typename T>
+    bool containsTimes(const vector<T>& items, size_t count) const {
+        size_t known = lower_bound(times.begin(), times.end(), items[0].getTime()) - times.begin();
+        for (size_t n = 0; n < count; n++) {
+            const time_sec time = items[n].getTime();
+            while (known < times.size() && times[known] < time) known++;
+            if (known == times.size() || times[known] != time) return false;
+        }
+        return true;
+    }
+
+    // Merge the times of items[0..count) into the axis, keeping it sorted and unique
+    template<typename T>
+    void mergeTimes(const vector<T>& items, size_t count) {
+        vector<time_sec> merged;
+        merged.reserve(times.size() + count);
+        size_t known = 0;
+        for (size_t n = 0; n < count; n++) {
+            const time_sec time = items[n].getTime();
+            while (known < times.size() && times[known] < time) merged.push_back(times[known++]);
+            if (known < times.size() && times[known] == time) known++;
+            if (merged.empty() || merged.back() != time) merged.push_back(time);
+        }
+        merged.insert(merged.end(), times.begin() + known, times.end());
+        times.swap(merged);
+    }
+
+    time_sec interval;
+    vector<time_sec> times;
+};
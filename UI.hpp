@@ -63,7 +63,13 @@ feel free to contribute with an issue or pull request to this repository!
 #include <FL/Fl.H>
 #include "TimePointSeries.hpp"
 #include "Fl_ChartBox.hpp"
+#include "Tracer.hpp"
+#include "ChartVirtualizer.hpp"
 #include "../misc/safe.hpp"
+#include <map>
+#include <memory>
+#include <atomic>
+#include <functional>
 
 using namespace std;
 
@@ -164,16 +170,15 @@ protected:
 
 
 
+// The window runs the FLTK event loop, which sleeps until an event, a timer
+// or a wake up comes: schedule one-shot tasks with post() or after(), periodic
+// ones with every(), and let worker threads wake the UI with wake() when their
+// data is ready, nothing polls in between.
 class UI_Window: public UI_Element {
 public:
-
-    struct IdleData {
-        void (*func)(void*);
-        void* data;
-        bool once;
-        void (*wrap)(void*);
-        bool first = true;
-    };
+    typedef function<void()> Task;
+    typedef size_t TimerId;
+    typedef size_t WakeId;
 
     UI_Window(int left, int top, int width, int height, string title = ""):
         UI_Element(top, left, width, height), title(title) {}
@@ -184,13 +189,31 @@ public:
     UI_Window(int width, int height, const char* title = nullptr):
         UI_Window(0, 0, width, height, string(title ? title : "")) {}
 
-    virtual ~UI_Window() {}
+    virtual ~UI_Window() {
+        // LCOV_EXCL_START
+        // Coverage excluded - the timers are only armed by a running window
+        for (auto& timer: timers) Fl::remove_timeout(onTimeout, timer.second.get());
+        timers.clear();
+        // LCOV_EXCL_STOP
+    }
 
     void setFlArgs(int argc, char **argv) {
         this->argc = argc;
         this->argv = argv;
     }
 
+    // Enable the tracer for run() and write its Chrome trace to the file when run() returns
+    void setTraceFile(const string& traceFile) {
+        this->traceFile = traceFile;
+        Tracer::getInstance().setEnabled(!traceFile.empty());
+    }
+
+    // Period of the idle function of run() when it is not called once (60 per second by default)
+    void setIdleInterval(double idleInterval) {
+        if (!(idleInterval > 0)) throw ERROR("Invalid idle interval");
+        this->idleInterval = idleInterval;
+    }
+
     Fl_Widget* build() override {
         checkBuilt(window);
         window = createFl<Fl_Window>(getAbsoluteLeft(), getAbsoluteTop(), width, height, title.c_str());
@@ -206,27 +229,79 @@ public:
         return window;
     }
 
+    // LCOV_EXCL_START
+    // Coverage excluded - the timers and the wake ups need a running FLTK event loop
+
+    // Run the task once on the UI thread, after the events already waiting (UI thread only)
+    TimerId post(Task task) {
+        return after(0, task);
+    }
+
+    // Run the task once on the UI thread in the given seconds (UI thread only)
+    TimerId after(double seconds, Task task) {
+        return addTimer(seconds, task, false);
+    }
+
+    // Run the task on the UI thread every given seconds until cancelled (UI thread only),
+    // the period is kept from the scheduled times, a slow task doesn't make it drift
+    TimerId every(double seconds, Task task) {
+        if (!(seconds > 0)) throw ERROR("Invalid timer interval");
+        return addTimer(seconds, task, true);
+    }
+
+    // Stop a timer, false if it has already run (one-shot) or was cancelled (UI thread only).
+    // A periodic task may cancel itself.
+    bool cancel(TimerId id) {
+        auto found = timers.find(id);
+        if (found == timers.end()) return false;
+        Fl::remove_timeout(onTimeout, found->second.get());
+        timers.erase(found);
+        return true;
+    }
+
+    bool isScheduled(TimerId id) const {
+        return timers.find(id) != timers.end();
+    }
+
+    // Register a task that worker threads trigger with wake() when they have data for the UI
+    // (UI thread only, before the workers use it). It stays registered while the window lives.
+    WakeId onWake(Task task) {
+        wakes.push_back(make_unique<Wake>(task));
+        return wakes.size() - 1;
+    }
+
+    // From any thread: run the task of onWake() on the UI thread. The wake ups coming
+    // before the task runs are coalesced into one run, so a fast producer can't flood
+    // the FLTK awake queue. Needs the lock taken by run().
+    void wake(WakeId id) {
+        Wake& wake = *wakes.at(id);
+        if (wake.pending.exchange(true)) return;
+        Fl::awake(onAwake, &wake);
+    }
+
+    // The idle function is posted once when the loop starts, or called every idle interval
+    // (see setIdleInterval) if it isn't once, the loop sleeps in between
     int run(void idle(void*) = nullptr, void* data = nullptr, bool once = false) {
         SAFE(window);
+        lockFl();
         if (argc && argv) window->show(argc, argv);
         else window->show();
         
+        TimerId idleTimer = 0;
         if (idle) {
-            idle_data.func = idle;
-            idle_data.data = data;
-            idle_data.once = once;
-            idle_data.wrap = [](void* idle_data_void) {
-                IdleData* idle_data = (IdleData*)idle_data_void;
-                if (idle_data->first) { // this is a hack since remove_idle doesn't really seems to be working
-                    idle_data->func(idle_data->data);
-                    if (idle_data->once) idle_data->first = false;
-                }
+            const Task task = [idle, data]() {
+                TraceSpan span("UI_Window::idle", "ui");
+                idle(data);
             };
-            Fl::add_idle(idle_data.wrap, (void*)&idle_data);
+            idleTimer = once ? post(task) : every(idleInterval, task);
         }
 
-        return Fl::run();
+        int result = Fl::run();
+        cancel(idleTimer);
+        if (!traceFile.empty()) Tracer::getInstance().writeChromeTrace(traceFile);
+        return result;
     }
+    // LCOV_EXCL_STOP
 
     int run(
         int argc, char **argv, 
@@ -252,19 +327,74 @@ public:
     // =========================================================
 
 protected:
+    struct Timer {
+        UI_Window* window;
+        TimerId id;
+        Task task;
+        double interval;
+        bool repeat;
+    };
+
+    struct Wake {
+        Task task;
+        atomic<bool> pending{false};
+
+        Wake(Task task): task(task) {}
+    };
+
+    // LCOV_EXCL_START
+    // Coverage excluded - the timers and the wake ups need a running FLTK event loop
+    TimerId addTimer(double seconds, Task task, bool repeat) {
+        const TimerId id = nextTimerId++;
+        unique_ptr<Timer>& timer = timers[id];
+        timer.reset(new Timer{ this, id, task, seconds, repeat });
+        Fl::add_timeout(seconds, onTimeout, timer.get());
+        return id;
+    }
+
+    static void onTimeout(void* data) {
+        Timer* timer = (Timer*)data;
+        UI_Window* window = timer->window;
+        if (timer->repeat) {
+            Fl::repeat_timeout(timer->interval, onTimeout, timer);
+            const Task task = timer->task; // the task may cancel its timer
+            task();
+            return;
+        }
+        const Task task = move(timer->task);
+        window->timers.erase(timer->id);
+        task();
+    }
+
+    // Fl::awake() needs the lock, so worker threads (e.g. async series loads) can post to the UI.
+    // Taken once for the process, a second run() (or a second window) must not take it again.
+    static void lockFl() {
+        static bool locked = false;
+        if (locked) return;
+        Fl::lock();
+        locked = true;
+    }
+
+    static void onAwake(void* data) {
+        Wake* wake = (Wake*)data;
+        wake->pending = false; // the wake ups from now on need another run
+        wake->task();
+    }
+    // LCOV_EXCL_STOP
+
     string title;
     int argc = 0;
     char **argv = nullptr;
+    string traceFile;
+    double idleInterval = 1.0 / 60;
 
     Fl_Window* window = nullptr;
     Fl_Scroll* scroll = nullptr;
-    
-private:
-
-    static IdleData idle_data;
 
+    TimerId nextTimerId = 1;
+    map<TimerId, unique_ptr<Timer>> timers;
+    vector<unique_ptr<Wake>> wakes;
 };
-inline UI_Window::IdleData UI_Window::idle_data;
 
 class UI_ScrollBox: public UI_Element {
 public:
@@ -323,6 +453,74 @@ public:
         flchart()->addPointSeries(pointSeries, pane);
     }
 
+    shared_ptr<AsyncSeriesLoad<Candle>> loadCandleSeriesAsync(
+        const CandleSeries candleSeries, AsyncSeriesLoad<Candle>::Loader loader, int pane = 0
+    ) {
+        return flchart()->loadCandleSeriesAsync(candleSeries, loader, pane);
+    }
+
+    shared_ptr<AsyncSeriesLoad<TimePoint>> loadBarSeriesAsync(
+        AsyncSeriesLoad<TimePoint>::Loader loader, unsigned int color = CHART_COLOR_PLOTTER, int pane = 0
+    ) {
+        return flchart()->loadBarSeriesAsync(loader, color, pane);
+    }
+
+    shared_ptr<AsyncSeriesLoad<TimePoint>> loadPointSeriesAsync(
+        AsyncSeriesLoad<TimePoint>::Loader loader, unsigned int color = CHART_COLOR_PLOTTER, int pane = 0
+    ) {
+        return flchart()->loadPointSeriesAsync(loader, color, pane);
+    }
+
+    void addWindowedSeries(shared_ptr<WindowedPointSeries> windowedSeries, int pane = 0) {
+        flchart()->addWindowedSeries(windowedSeries, pane);
+    }
+
+    void addCandleIndicator(shared_ptr<Indicator> indicator, int pane = 0, int sourcePane = 0, int sourceIndex = 0) {
+        flchart()->addCandleIndicator(indicator, pane, sourcePane, sourceIndex);
+    }
+
+    void addPointIndicator(shared_ptr<Indicator> indicator, int pane = 0, int sourcePane = 0, int sourceIndex = 0) {
+        flchart()->addPointIndicator(indicator, pane, sourcePane, sourceIndex);
+    }
+
+    shared_ptr<LazyIndicatorSeries<Candle>> addLazyCandleIndicator(
+        LazyIndicatorSeries<Candle>::Factory factory, size_t warmup, int output = 0, 
+        int pane = 0, int sourcePane = 0, int sourceIndex = 0
+    ) {
+        return flchart()->addLazyCandleIndicator(factory, warmup, output, pane, sourcePane, sourceIndex);
+    }
+
+    shared_ptr<LazyIndicatorSeries<TimePoint>> addLazyPointIndicator(
+        LazyIndicatorSeries<TimePoint>::Factory factory, size_t warmup, int output = 0, 
+        int pane = 0, int sourcePane = 0, int sourceIndex = 0
+    ) {
+        return flchart()->addLazyPointIndicator(factory, warmup, output, pane, sourcePane, sourceIndex);
+    }
+
+    void patchCandleSeries(int pane, int index, const SeriesPatch<Candle>& patch) {
+        flchart()->patchCandleSeries(pane, index, patch);
+    }
+
+    void patchBarSeries(int pane, int index, const SeriesPatch<TimePoint>& patch) {
+        flchart()->patchBarSeries(pane, index, patch);
+    }
+
+    void patchPointSeries(int pane, int index, const SeriesPatch<TimePoint>& patch) {
+        flchart()->patchPointSeries(pane, index, patch);
+    }
+
+    void setTimeAxis(shared_ptr<TradingTimeAxis> timeAxis) {
+        flchart()->setTimeAxis(timeAxis);
+    }
+
+    void setStatsEnabled(bool statsEnabled) {
+        flchart()->setStatsEnabled(statsEnabled);
+    }
+
+    const ChartFrameStats& getLastFrameStats() const {
+        return flchart()->getLastFrameStats();
+    }
+
     void clearAllSerieses() {
         flchart()->clearAllSerieses();
     }
@@ -339,6 +537,14 @@ public:
         flchart()->clearPointsSerieses();
     }
 
+    void clearWindowedSerieses() {
+        flchart()->clearWindowedSerieses();
+    }
+
+    void clearIndicators() {
+        flchart()->clearIndicators();
+    }
+
     void refresh() override {
         Fl::check();
         flchart()->redraw();
@@ -350,6 +556,45 @@ protected:
     Fl_ChartBox* chart = nullptr;
 };
 
+// LCOV_EXCL_START
+// Coverage excluded - requires GUI display environment
+// Fl_Scroll that lets its owner place the children of the viewport at the current
+// scroll position each time it scrolled or was resized, not while it is drawn
+// (see UI_MultiChart::setVirtualized)
+class Fl_ViewportScroll: public Fl_Scroll {
+public:
+    Fl_ViewportScroll(int left, int top, int width, int height, const char* label = nullptr):
+        Fl_Scroll(left, top, width, height, label)
+    {
+        scrollbar.callback(onScrollbar, this);
+        hscrollbar.callback(onScrollbar, this);
+    }
+
+    // Returns true if it changed the children, the whole viewport is redrawn then
+    function<bool()> onViewport = nullptr;
+
+    void resize(int left, int top, int width, int height) override {
+        Fl_Scroll::resize(left, top, width, height);
+        updateViewport();
+    }
+
+    // Place the children for the current scroll position (e.g. after charts were added)
+    void updateViewport() {
+        if (onViewport && onViewport()) redraw();
+    }
+
+protected:
+    // Scroll as the default callbacks of Fl_Scroll do, then place the children
+    static void onScrollbar(Fl_Widget* widget, void* data) {
+        Fl_ViewportScroll* viewport = (Fl_ViewportScroll*)data;
+        const int position = (int)((Fl_Scrollbar*)widget)->value();
+        if (widget == &viewport->scrollbar) viewport->scroll_to(viewport->xposition(), position);
+        else viewport->scroll_to(position, viewport->yposition());
+        viewport->updateViewport();
+    }
+};
+// LCOV_EXCL_STOP
+
 class UI_MultiChart: public UI_ScrollBox {
 public:
     UI_MultiChart(
@@ -367,7 +612,64 @@ public:
 
     virtual ~UI_MultiChart() {}
 
+    // Fills a recycled, empty chart box with the serieses of the chartno-th chart
+    typedef function<void(Fl_ChartBox& chartBox, size_t chartno)> Populate;
+
+    // Virtualized mode (set before createChart and build): only the charts in the
+    // scroll viewport, plus bufferCharts above and below, get a chart box. The chart
+    // boxes are recycled from a pool as the charts scroll in and out, the offscreen
+    // charts keep their view only. populate() is called each time a chart scrolls
+    // into view; what it attaches (async loads, indicators) belongs to the chart box
+    // and is dropped when the chart scrolls out.
+    void setVirtualized(Populate populate, size_t bufferCharts = 2) {
+        if (scroll) throw ERROR("Multi chart already built");
+        this->populate = populate;
+        virtualizer.setBufferCharts(bufferCharts);
+    }
+
+    bool isVirtualized() const { return populate != nullptr; }
+
+    Fl_Widget* build() override {
+        if (!isVirtualized()) return UI_ScrollBox::build();
+        
+        // LCOV_EXCL_START
+        // Coverage excluded - requires GUI display environment
+        checkBuilt(scroll);
+        viewport = createFl<Fl_ViewportScroll>(getAbsoluteLeft(), getAbsoluteTop(), width, height);
+        scroll = viewport;
+        content = new Fl_Box(getAbsoluteLeft(), getAbsoluteTop(), width - scrollbarThickness, getContentHeight());
+        scroll->add(content);
+        scroll->box(FL_DOWN_BOX);
+        scroll->type(Fl_Scroll::BOTH_ALWAYS);
+        scroll->scrollbar_size(scrollbarThickness);
+        scroll->end();
+        viewport->onViewport = [this]() { return updateViewport(); };
+        viewport->updateViewport();
+        return scroll;
+        // LCOV_EXCL_STOP
+    }
+
+    // Chart box of a chart, nullptr if it is virtualized and out of the view
+    Fl_ChartBox* getChartBox(size_t chartno) const {
+        if (!isVirtualized()) return chartBoxes.at(chartno)->flchart();
+        return liveChartBoxes.at(chartno);
+    }
+
+    size_t getChartCount() const {
+        return isVirtualized() ? virtualizer.size() : chartBoxes.size();
+    }
+
     void createChart(UI_Manager& ui, int n, int chartHeight) {
+        if (isVirtualized()) {
+            for (int i = 0; i < n; i++) {
+                virtualizer.addSlot(nextChartTop, chartHeight);
+                liveChartBoxes.push_back(nullptr);
+                nextChartTop += chartHeight;
+            }
+            if (content) content->size(content->w(), getContentHeight()); // LCOV_EXCL_LINE
+            if (viewport) viewport->updateViewport(); // LCOV_EXCL_LINE
+            return;
+        }
         for (int i = 0; i < n; i++) {
             UI_ChartBox* chartBox = ui.create<UI_ChartBox>(
                 spacing, nextChartTop, chartWidth, chartHeight
@@ -386,19 +688,29 @@ public:
         for (UI_ChartBox* chartBox: chartBoxes)
             ui.remove(chartBox);
         chartBoxes.clear();
+        for (size_t n = 0; n < liveChartBoxes.size(); n++)
+            if (liveChartBoxes[n]) releaseChart(n); // LCOV_EXCL_LINE
+        liveChartBoxes.clear();
+        virtualizer.clear();
         nextChartTop = spacing;
+        if (content) content->size(content->w(), getContentHeight()); // LCOV_EXCL_LINE
+        if (viewport) viewport->updateViewport(); // LCOV_EXCL_LINE
     }
 
+    // In virtualized mode the serieses come from the populate callback
     void addCandleSeries(
         const size_t chartno,
         const CandleSeries& candleSeries
     ) {
+        if (isVirtualized()) throw ERROR("Virtualized multi chart is populated by its callback");
         chartBoxes.at(chartno)->addCandleSeries(candleSeries);
     }
 
     void clearChartsSeries() {
         for (UI_ChartBox* chartBox: chartBoxes)
             chartBox->clearAllSerieses();
+        for (Fl_ChartBox* chartBox: liveChartBoxes)
+            if (chartBox) chartBox->clearAllSerieses(); // LCOV_EXCL_LINE
     }
 
     void joinScroll(bool syncXAxis = true) {
@@ -406,11 +718,23 @@ public:
         group.setSyncXAxis(syncXAxis);
         
         // Set up callback to redraw all charts when sync happens
+        // (virtualized: only the live ones are in the group)
+        group.onBeforeSync = [this]() { cancelCharts(); };
         group.onSync = [this]() {
+            if (parallelPrepare) prepareCharts();
             for (UI_ChartBox* chartBox : chartBoxes) {
                 chartBox->flchart()->redraw();
             }
+            for (Fl_ChartBox* chartBox : liveChartBoxes) {
+                if (chartBox) chartBox->redraw();
+            }
         };
+        joined = true;
+        for (Fl_ChartBox* chartBox : liveChartBoxes) {
+            if (!chartBox) continue;
+            group.addChart(chartBox->getChart());
+            chartBox->setChartGroup(&group);
+        }
         
         // Add all charts to the group
         for (UI_ChartBox* chartBox : chartBoxes) {
@@ -425,9 +749,140 @@ public:
     }
     
     ChartGroup& getChartGroup() { return group; }
+
+    // Opt in to fit the charts in parallel on the render pool (RenderPool::getInstance()
+    // by default) on a synced scroll/zoom, before they are redrawn; the drawing itself
+    // stays on the UI thread, each chart box waits for its own fit (see prepareCharts).
+    // Only for charts that share nothing but the group: indicators, windowed, paged
+    // or lazy serieses attached to more than one chart would be updated by two
+    // workers at once (see Fl_ChartBox::prepareAsync).
+    void setParallelPrepare(bool parallelPrepare) { this->parallelPrepare = parallelPrepare; }
+    bool isParallelPrepare() const { return parallelPrepare; }
+    void setRenderPool(RenderPool* renderPool) { this->renderPool = renderPool; }
+
+    // Fit (and decimate) all the chart boxes on the render pool, the focused chart
+    // first, then the visible ones, then the buffered ones. Doesn't wait for them:
+    // each chart box waits for its own job in draw(), and a newer view cancels the
+    // jobs of the stale one (see cancelCharts) before they are submitted again.
+    void prepareCharts() {
+        cancelCharts();
+        RenderPool& pool = getRenderPool();
+        vector<Fl_ChartBox*> boxes;
+        for (UI_ChartBox* chartBox : chartBoxes) boxes.push_back(chartBox->flchart());
+        for (Fl_ChartBox* chartBox : liveChartBoxes) if (chartBox) boxes.push_back(chartBox);
+        
+        // The time axis may be shared, it doesn't change while the jobs run
+        for (Fl_ChartBox* chartBox : boxes) chartBox->updateTimeAxis();
+        
+        for (Fl_ChartBox* chartBox : boxes)
+            prepareJobs.push_back(chartBox->prepareAsync(pool, getRenderPriority(chartBox)));
+    }
+
+    // Cancel the fits of prepareCharts() and wait for the running ones to stop (a
+    // queued one is skipped), before the group changes the views they read
+    void cancelCharts() {
+        for (const shared_ptr<RenderJob>& job : prepareJobs) job->cancel();
+        getRenderPool().waitAll(prepareJobs);
+        prepareJobs.clear();
+    }
     
 protected:
+    RenderPool& getRenderPool() const { return renderPool ? *renderPool : RenderPool::getInstance(); }
+
+    RenderPriority getRenderPriority(Fl_ChartBox* chartBox) const {
+        if (Fl::focus() == chartBox) return RENDER_PRIORITY_FOCUSED;
+        if (!scroll) return RENDER_PRIORITY_VISIBLE;
+        const bool visible = 
+            chartBox->y() + chartBox->h() > scroll->y() && 
+            chartBox->y() < scroll->y() + scroll->h();
+        return visible ? RENDER_PRIORITY_VISIBLE : RENDER_PRIORITY_BACKGROUND;
+    }
+
+    int getContentHeight() const {
+        return max(height, virtualizer.getContentHeight() + spacing);
+    }
+
+    // LCOV_EXCL_START
+    // Coverage excluded - requires GUI display environment
+    // Recycle the chart boxes for the charts in the current viewport,
+    // returns true if any chart scrolled in or out
+    bool updateViewport() {
+        virtualizer.update(scroll->yposition(), scroll->h(), released, acquired);
+        for (size_t n: released) releaseChart(n);
+        for (size_t n: acquired) acquireChart(n);
+        return !released.empty() || !acquired.empty();
+    }
+
+    void acquireChart(size_t n) {
+        Fl_ChartBox* chartBox;
+        if (pool.empty()) {
+            Fl_Group* current = Fl_Group::current();
+            Fl_Group::current(nullptr); // don't let it join whatever group is being built
+            chartBox = new Fl_ChartBox(0, 0, chartWidth, virtualizer.getSlotHeight(n));
+            Fl_Group::current(current);
+            scroll->add(chartBox);
+        } else {
+            chartBox = pool.back();
+            pool.pop_back();
+        }
+        chartBox->resize(
+            scroll->x() + spacing - scroll->xposition(), 
+            scroll->y() + virtualizer.getSlotTop(n) - scroll->yposition(), 
+            chartWidth, virtualizer.getSlotHeight(n)
+        );
+        chartBox->show();
+
+        Chart& chart = chartBox->getChart();
+        virtualizer.getViewState(n).restore(chart);
+        populate(*chartBox, n);
+        if (joined) {
+            // Synced charts scroll in at the view of the others
+            if (group.getSyncXAxis()) {
+                for (Fl_ChartBox* other: liveChartBoxes) {
+                    if (!other || !other->getChart().isViewInitialized()) continue;
+                    chart.setViewFirst(other->getChart().getViewFirst());
+                    chart.setViewLast(other->getChart().getViewLast());
+                    break;
+                }
+            }
+            group.addChart(chart);
+            chartBox->setChartGroup(&group);
+        }
+        liveChartBoxes[n] = chartBox;
+        chartBox->redraw();
+    }
+
+    // Keep the view of the chart, drop its serieses and caches (and loads), its
+    // panes, time axis and recorder, the chart box goes back to the pool
+    void releaseChart(size_t n) {
+        Fl_ChartBox* chartBox = liveChartBoxes[n];
+        liveChartBoxes[n] = nullptr;
+        virtualizer.getViewState(n).save(chartBox->getChart());
+        if (joined) {
+            group.removeChart(chartBox->getChart());
+            chartBox->setChartGroup(nullptr);
+        }
+        chartBox->recycle();
+        chartBox->hide();
+        pool.push_back(chartBox);
+    }
+    // LCOV_EXCL_STOP
+
     int spacing, nextChartTop, /*chartHeight,*/ chartWidth;
     vector<UI_ChartBox*> chartBoxes;
     ChartGroup group;
+    bool joined = false;
+    bool parallelPrepare = false;
+    RenderPool* renderPool = nullptr;
+    vector<shared_ptr<RenderJob>> prepareJobs;
+
+    // Virtualized mode (see setVirtualized)
+    Populate populate = nullptr;
+    ChartVirtualizer virtualizer;
+    vector<Fl_ChartBox*> liveChartBoxes; // per chart, nullptr while out of view
+    vector<Fl_ChartBox*> pool;           // hidden, empty chart boxes to recycle
+    vector<size_t> released;
+    vector<size_t> acquired;
+    Fl_Box* content = nullptr;           // sized to all the charts, so the scrollbar spans them
+    Fl_ViewportScroll* viewport = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,402 @@
+#pragma once
+
+#include "../misc/ERROR.hpp"
+#include "../misc/Canvas.hpp"
+#include <vector>
+#include <map>
+#include <tuple>
+#include <string>
+#include <ostream>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+struct VectorPoint {
+    int x;
+    int y;
+
+    bool operator==(const VectorPoint& other) const { return x == other.x && y == other.y; }
+};
+
+// Keep the points of a polyline that matter at the given tolerance (in pixels):
+// first the runs in one pixel column are reduced to their first, lowest, highest
+// and last points (what the column shows anyway), then Douglas-Peucker drops the
+// points closer than tolerance to the simplified line. The ends are always kept.
+inline void simplifyPolyline(vector<VectorPoint>& points, double tolerance) {
+    if (points.size() < 3) return;
+
+    // Column runs, at most 4 points per x
+    size_t kept = 0;
+    for (size_t from = 0; from < points.size();) {
+        size_t to = from + 1;
+        size_t low = from, high = from;
+        while (to < points.size() && points[to].x == points[from].x) {
+            if (points[to].y < points[low].y) low = to;
+            if (points[to].y > points[high].y) high = to;
+            to++;
+        }
+        const size_t last = to - 1;
+        size_t picks[4] = { from, min(low, high), max(low, high), last };
+        for (size_t n = 0; n < 4; n++) {
+            if (n && picks[n] == picks[n - 1]) continue;
+            points[kept++] = points[picks[n]];
+        }
+        from = to;
+    }
+    points.resize(kept);
+    if (points.size() < 3) return;
+
+    // Douglas-Peucker, iterative
+    vector<bool> keep(points.size(), false);
+    keep.front() = keep.back() = true;
+    vector<pair<size_t, size_t>> stack = { { 0, points.size() - 1 } };
+    const double tolerance2 = tolerance * tolerance;
+    while (!stack.empty()) {
+        const size_t first = stack.back().first;
+        const size_t last = stack.back().second;
+        stack.pop_back();
+        if (last < first + 2) continue;
+        const double ax = points[first].x, ay = points[first].y;
+        const double dx = points[last].x - ax, dy = points[last].y - ay;
+        const double length2 = dx * dx + dy * dy;
+        double farthest = -1;
+        size_t index = first;
+        for (size_t n = first + 1; n < last; n++) {
+            const double px = points[n].x - ax, py = points[n].y - ay;
+            double distance2;
+            if (length2 == 0) distance2 = px * px + py * py;
+            else {
+                const double cross = px * dy - py * dx;
+                distance2 = cross * cross / length2;
+            }
+            if (distance2 > farthest) {
+                farthest = distance2;
+                index = n;
+            }
+        }
+        if (farthest <= tolerance2) continue;
+        keep[index] = true;
+        stack.push_back({ first, index });
+        stack.push_back({ index, last });
+    }
+    kept = 0;
+    for (size_t n = 0; n < points.size(); n++)
+        if (keep[n]) points[kept++] = points[n];
+    points.resize(kept);
+}
+
+// Canvas recording the drawing as vectors, written as SVG or PDF (one page).
+// Connected line() calls of one color make one polyline, simplified at a pixel
+// tolerance (see simplifyPolyline) while it grows and before it is written, so
+// the size of the output is bound by the resolution, not by the data drawn.
+// Everything of one color and kind is merged into one compound path (e.g. all
+// the bullish candle bodies), the paths come in the order their color was first
+// drawn. Coordinates are pixels, 1 pixel = 1 point in the PDF.
+class VectorCanvas: public Canvas {
+public:
+    VectorCanvas(int width, int height, unsigned int background = 0x000000, double tolerance = 0.5):
+        canvasWidth(width),
+        canvasHeight(height),
+        background(background),
+        tolerance(tolerance),
+        compactSize(max((size_t)1024, (size_t)max(0, width + height) * 4))
+    {
+        if (width <= 0 || height <= 0) throw ERROR("Invalid vector canvas size");
+    }
+
+    virtual ~VectorCanvas() {}
+
+    void line(int left1, int top1, int left2, int top2, unsigned int color, int style = 0) override {
+        segments++;
+        VectorGroup& group = getGroup(VECTOR_STROKE, color, style);
+        if (group.polylines.empty() || !(group.polylines.back().points.back() == VectorPoint{ left1, top1 }))
+            group.polylines.push_back({ { { left1, top1 } }, 0 });
+        VectorPolyline& polyline = group.polylines.back();
+        polyline.points.push_back({ left2, top2 });
+        if (polyline.points.size() >= max(compactSize, polyline.simplified * 2)) {
+            simplifyPolyline(polyline.points, tolerance);
+            polyline.simplified = polyline.points.size();
+        }
+    }
+
+    void circle(int left, int top, int radius, unsigned int color) override {
+        getGroup(VECTOR_STROKE, color, 0).circles.push_back({ left, top, radius });
+    }
+
+    void circlef(int left, int top, int radius, unsigned int color) override {
+        getGroup(VECTOR_FILL, color, 0).circles.push_back({ left, top, radius });
+    }
+
+    // An outline is a closed polyline through the centers of its border pixels
+    void rect(int left, int top, int width, int height, unsigned int color) override {
+        if (width <= 0 || height <= 0) return;
+        const int right = left + width - 1, bottom = top + height - 1;
+        getGroup(VECTOR_STROKE, color, 0).polylines.push_back({
+            { { left, top }, { right, top }, { right, bottom }, { left, bottom }, { left, top } }, 5
+        });
+    }
+
+    void rectf(int left, int top, int width, int height, unsigned int color) override {
+        if (width <= 0 || height <= 0) return;
+        getGroup(VECTOR_FILL, color, 0).rects.push_back({ left, top, width, height });
+    }
+
+    void text(int left, int top, const string& txt, unsigned int color, int font = 0, int size = 14) override {
+        (void)font;
+        getGroup(VECTOR_TEXT, color, 0).texts.push_back({ left, top, size, txt });
+    }
+
+    // No font metrics here, a monospace estimate
+    void measure(const string& text, int& width, int& height, int& descent, int font = 0, int size = 14) override {
+        (void)font;
+        width = (int)text.size() * size * 6 / 10;
+        height = size;
+        descent = size / 4;
+    }
+
+    int width() override { return canvasWidth; }
+    int height() override { return canvasHeight; }
+
+    // Forget everything drawn
+    void clear() override {
+        groups.clear();
+        groupIndex.clear();
+        segments = 0;
+    }
+
+    size_t getSegmentCount() const { return segments; }
+    size_t getPathCount() const { return groups.size(); }
+
+    // Points written for the polylines (after the simplification)
+    size_t getPointCount() {
+        simplify();
+        size_t count = 0;
+        for (const VectorGroup& group: groups)
+            for (const VectorPolyline& polyline: group.polylines) count += polyline.points.size();
+        return count;
+    }
+
+    void writeSvg(ostream& out) {
+        simplify();
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << canvasWidth << "\" height=\"" << canvasHeight
+            << "\" viewBox=\"0 0 " << canvasWidth << " " << canvasHeight << "\">\n"
+            << "<rect width=\"100%\" height=\"100%\" fill=\"" << getSvgColor(background) << "\"/>\n";
+        for (const VectorGroup& group: groups) {
+            if (group.kind == VECTOR_TEXT) {
+                for (const VectorText& text: group.texts)
+                    out << "<text x=\"" << text.left << "\" y=\"" << text.top + text.size
+                        << "\" font-family=\"sans-serif\" font-size=\"" << text.size
+                        << "\" fill=\"" << getSvgColor(group.color) << "\">" << escapeXml(text.text) << "</text>\n";
+                continue;
+            }
+            const bool fill = group.kind == VECTOR_FILL;
+            string d;
+            char buffer[96];
+            for (const VectorPolyline& polyline: group.polylines)
+                for (size_t n = 0; n < polyline.points.size(); n++) {
+                    snprintf(buffer, sizeof(buffer), "%c%.1f %.1f", n ? 'L' : 'M', polyline.points[n].x + 0.5, polyline.points[n].y + 0.5);
+                    d += buffer;
+                }
+            for (const VectorRect& rect: group.rects) {
+                snprintf(buffer, sizeof(buffer), "M%d %dh%dv%dh%dz", rect.left, rect.top, rect.width, rect.height, -rect.width);
+                d += buffer;
+            }
+            for (const VectorCircle& circle: group.circles) {
+                // Two half arcs
+                snprintf(buffer, sizeof(buffer), "M%.1f %.1fa%d %d 0 1 0 %d 0a%d %d 0 1 0 %d 0",
+                    circle.left - circle.radius + 0.5, circle.top + 0.5, circle.radius, circle.radius, circle.radius * 2,
+                    circle.radius, circle.radius, -circle.radius * 2);
+                d += buffer;
+            }
+            if (d.empty()) continue;
+            out << "<path d=\"" << d << "\" ";
+            if (fill) out << "fill=\"" << getSvgColor(group.color) << "\"";
+            else {
+                out << "fill=\"none\" stroke=\"" << getSvgColor(group.color) << "\" stroke-width=\"1\" stroke-linecap=\"square\"";
+                if (group.style) out << " stroke-dasharray=\"4 2\"";
+            }
+            out << "/>\n";
+        }
+        out << "</svg>\n";
+    }
+
+    void writePdf(ostream& out) {
+        simplify();
+        ostringstream content;
+        char buffer[128];
+        content << getPdfColor(background) << " rg 0 0 " << canvasWidth << " " << canvasHeight << " re f\n"
+                << "1 w 2 J\n";
+        for (const VectorGroup& group: groups) {
+            const string color = getPdfColor(group.color);
+            if (group.kind == VECTOR_TEXT) {
+                for (const VectorText& text: group.texts)
+                    content << "BT /F1 " << text.size << " Tf " << color << " rg "
+                            << text.left << " " << canvasHeight - text.top - text.size << " Td ("
+                            << escapePdf(text.text) << ") Tj ET\n";
+                continue;
+            }
+            const bool fill = group.kind == VECTOR_FILL;
+            content << color << (fill ? " rg\n" : " RG\n");
+            content << (group.style && !fill ? "[4 2] 0 d\n" : "[] 0 d\n");
+            for (const VectorPolyline& polyline: group.polylines)
+                for (size_t n = 0; n < polyline.points.size(); n++) {
+                    snprintf(buffer, sizeof(buffer), "%.1f %.1f %c\n",
+                        polyline.points[n].x + 0.5, canvasHeight - polyline.points[n].y - 0.5, n ? 'l' : 'm');
+                    content << buffer;
+                }
+            for (const VectorRect& rect: group.rects) {
+                snprintf(buffer, sizeof(buffer), "%d %d %d %d re\n",
+                    rect.left, canvasHeight - rect.top - rect.height, rect.width, rect.height);
+                content << buffer;
+            }
+            for (const VectorCircle& circle: group.circles) {
+                // Four Bezier quarters
+                const double x = circle.left + 0.5, y = canvasHeight - circle.top - 0.5;
+                const double r = circle.radius, k = 0.5523 * circle.radius;
+                snprintf(buffer, sizeof(buffer), "%.2f %.2f m\n", x + r, y);
+                content << buffer;
+                const double quarters[4][6] = {
+                    { x + r, y + k, x + k, y + r, x, y + r },
+                    { x - k, y + r, x - r, y + k, x - r, y },
+                    { x - r, y - k, x - k, y - r, x, y - r },
+                    { x + k, y - r, x + r, y - k, x + r, y },
+                };
+                for (const double* q: quarters) {
+                    snprintf(buffer, sizeof(buffer), "%.2f %.2f %.2f %.2f %.2f %.2f c\n", q[0], q[1], q[2], q[3], q[4], q[5]);
+                    content << buffer;
+                }
+            }
+            content << (fill ? "f\n" : "S\n");
+        }
+        const string stream = content.str();
+
+        // Objects with their offsets for the cross-reference table
+        vector<size_t> offsets;
+        string pdf = "%PDF-1.4\n";
+        const auto addObject = [&](const string& body) {
+            offsets.push_back(pdf.size());
+            pdf += to_string(offsets.size()) + " 0 obj\n" + body + "\nendobj\n";
+        };
+        addObject("<< /Type /Catalog /Pages 2 0 R >>");
+        addObject("<< /Type /Pages /Kids [3 0 R] /Count 1 >>");
+        addObject(
+            "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 " + to_string(canvasWidth) + " " + to_string(canvasHeight) + "]"
+            " /Contents 4 0 R /Resources << /Font << /F1 5 0 R >> >> >>"
+        );
+        addObject("<< /Length " + to_string(stream.size()) + " >>\nstream\n" + stream + "endstream");
+        addObject("<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>");
+        const size_t xref = pdf.size();
+        pdf += "xref\n0 " + to_string(offsets.size() + 1) + "\n0000000000 65535 f \n";
+        for (size_t offset: offsets) {
+            snprintf(buffer, sizeof(buffer), "%010zu 00000 n \n", offset);
+            pdf += buffer;
+        }
+        pdf += "trailer\n<< /Size " + to_string(offsets.size() + 1) + " /Root 1 0 R >>\nstartxref\n" + to_string(xref) + "\n%%EOF\n";
+        out << pdf;
+    }
+
+    // .svg or .pdf, by the extension
+    void save(const string& filename) {
+        const size_t dot = filename.find_last_of('.');
+        const string extension = dot == string::npos ? "" : filename.substr(dot + 1);
+        if (extension != "svg" && extension != "pdf") throw ERROR("Unsupported vector format: " + filename);
+        ofstream file(filename, ios::binary);
+        if (!file) throw ERROR("Unable to create file: " + filename);
+        if (extension == "svg") writeSvg(file);
+        else writePdf(file);
+        if (!file) throw ERROR("Unable to write file: " + filename);
+    }
+
+protected:
+    enum VectorKind { VECTOR_STROKE, VECTOR_FILL, VECTOR_TEXT };
+
+    struct VectorPolyline {
+        vector<VectorPoint> points;
+        size_t simplified;      // size after the last simplification
+    };
+
+    struct VectorRect { int left, top, width, height; };
+    struct VectorCircle { int left, top, radius; };
+
+    struct VectorText {
+        int left, top, size;
+        string text;
+    };
+
+    struct VectorGroup {
+        VectorKind kind;
+        unsigned int color;
+        int style;
+        vector<VectorPolyline> polylines;
+        vector<VectorRect> rects;
+        vector<VectorCircle> circles;
+        vector<VectorText> texts;
+    };
+
+    VectorGroup& getGroup(VectorKind kind, unsigned int color, int style) {
+        const tuple<int, unsigned int, int> key(kind, color, style);
+        map<tuple<int, unsigned int, int>, size_t>::const_iterator found = groupIndex.find(key);
+        if (found != groupIndex.end()) return groups[found->second];
+        groupIndex[key] = groups.size();
+        groups.push_back({ kind, color, style, {}, {}, {}, {} });
+        return groups.back();
+    }
+
+    void simplify() {
+        for (VectorGroup& group: groups)
+            for (VectorPolyline& polyline: group.polylines)
+                if (polyline.simplified != polyline.points.size()) {
+                    simplifyPolyline(polyline.points, tolerance);
+                    polyline.simplified = polyline.points.size();
+                }
+    }
+
+    static string getSvgColor(unsigned int color) {
+        char buffer[8];
+        snprintf(buffer, sizeof(buffer), "#%06x", color & 0xFFFFFF);
+        return buffer;
+    }
+
+    static string getPdfColor(unsigned int color) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.3f %.3f %.3f",
+            ((color >> 16) & 0xFF) / 255.0, ((color >> 8) & 0xFF) / 255.0, (color & 0xFF) / 255.0);
+        return buffer;
+    }
+
+    static string escapeXml(const string& text) {
+        string escaped;
+        for (char c: text) {
+            if (c == '<') escaped += "&lt;";
+            else if (c == '>') escaped += "&gt;";
+            else if (c == '&') escaped += "&amp;";
+            else if (c == '"') escaped += "&quot;";
+            else escaped += c;
+        }
+        return escaped;
+    }
+
+    static string escapePdf(const string& text) {
+        string escaped;
+        for (char c: text) {
+            if (c == '(' || c == ')' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    int canvasWidth;
+    int canvasHeight;
+    unsigned int background;
+    double tolerance;
+    size_t compactSize;     // a growing polyline is simplified at this size (then at each doubling)
+    vector<VectorGroup> groups;
+    map<tuple<int, unsigned int, int>, size_t> groupIndex;
+    size_t segments = 0;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "TimePoint.hpp"
+#include "SeriesBlockSummary.hpp"
+#include "Chart.hpp"
+#include <vector>
+
+using namespace std;
+
+// Point series that is not (necessarily) resident as a vector<TimePoint>,
+// it gives out the points or the block summaries of a time window on demand.
+// Fl_ChartBox asks for the summaries of the view first and only fetches the
+// points when the blocks are wide enough on the screen (see Chart::isSummaryLevel)
+class WindowedPointSeries {
+public:
+    WindowedPointSeries(unsigned int color = CHART_COLOR_PLOTTER): color(color) {}
+    virtual ~WindowedPointSeries() {}
+
+    unsigned int getColor() const { return color; }
+
+    virtual bool empty() const = 0;
+    virtual time_sec getFirstTime() const = 0;
+    virtual time_sec getLastTime() const = 0;
+
+    // Number of points and a version bumped when points change other than by appending,
+    // Fl_ChartBox keys the cached fits of a pane on both
+    virtual size_t size() const = 0;
+    size_t getVersion() const { return version; }
+    void changed() { version++; }
+
+    // Summaries of the blocks overlapping [first, last], in time order
+    virtual void getSummaries(time_sec first, time_sec last, vector<SeriesBlockSummary>& summaries) = 0;
+
+    // Points of the blocks overlapping [first, last], in time order
+    // (whole blocks, so the caller still has to cut to the view)
+    virtual void getPoints(time_sec first, time_sec last, vector<TimePoint>& points) = 0;
+
+    // Blocks found in / missing from the cache of the series so far (for the draw stats)
+    virtual size_t getCacheHits() const { return 0; }
+    virtual size_t getCacheMisses() const { return 0; }
+
+protected:
+    // Index of the first block that ends at or after the given time
+    static size_t findSummaryIndex(const vector<SeriesBlockSummary>& summaries, time_sec time) {
+        return lower_bound(
+            summaries.begin(), summaries.end(), time,
+            [](const SeriesBlockSummary& summary, time_sec t) { return summary.last < t; }
+        ) - summaries.begin();
+    }
+
+    unsigned int color;
+    size_t version = 0;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+// Allocation counters, incremented by the replaced operator new in benchmarks.cpp
+inline atomic<size_t> benchAllocations{0};
+inline atomic<size_t> benchAllocatedBytes{0};
+
+// Keeps the result of a benchmarked call alive so the optimizer can't drop the call
+template<typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct BenchResult {
+    string name;
+    size_t size;            // size of the generated dataset
+    size_t iterations;
+    double nsPerOp;
+    double pointsPerSec;    // points processed by an op / time of an op
+    double allocsPerOp;
+    double bytesPerOp;
+
+    // One JSON object per line (JSON lines), easy to diff and to load elsewhere
+    string toJson() const {
+        stringstream ss;
+        ss << "{\"name\":\"" << name << "\""
+           << ",\"size\":" << size
+           << ",\"iterations\":" << iterations
+           << ",\"ns_per_op\":" << nsPerOp
+           << ",\"points_per_sec\":" << pointsPerSec
+           << ",\"allocs_per_op\":" << allocsPerOp
+           << ",\"bytes_per_op\":" << bytesPerOp
+           << "}";
+        return ss.str();
+    }
+};
+
+// Runs each op once to warm up, then in growing batches until minSeconds passed
+// (at least minIterations, about maxIterations at most) and prints the result as a JSON line.
+class Bench {
+public:
+    typedef function<void()> Op;
+
+    Bench(
+        const vector<string>& filter = {},
+        double minSeconds = 0.2,
+        size_t minIterations = 3,
+        size_t maxIterations = 1000000,
+        ostream& out = cout
+    ):
+        filter(filter),
+        minSeconds(minSeconds),
+        minIterations(minIterations),
+        maxIterations(maxIterations),
+        out(out)
+    {}
+
+    virtual ~Bench() {}
+
+    // Benchmark names are filtered by substring, like the tests
+    bool matches(const string& name) const {
+        if (filter.empty()) return true;
+        for (const string& f: filter)
+            if (!f.empty() && name.find(f) != string::npos) return true;
+        return false;
+    }
+
+    // Points is the number of points (candles, ticks) one op processes
+    void run(const string& name, size_t size, size_t points, Op op) {
+        if (!matches(name)) return;
+        op(); // warm up
+
+        const size_t allocationsBefore = benchAllocations;
+        const size_t bytesBefore = benchAllocatedBytes;
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        size_t iterations = 0;
+        size_t batch = 1; // doubled, so reading the clock doesn't weigh on the fast ops
+        double seconds = 0;
+        while (iterations < maxIterations && (iterations < minIterations || seconds < minSeconds)) {
+            for (size_t n = 0; n < batch; n++) op();
+            iterations += batch;
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (iterations < maxIterations) batch = min(batch * 2, maxIterations - iterations);
+        }
+
+        BenchResult result;
+        result.name = name;
+        result.size = size;
+        result.iterations = iterations;
+        result.nsPerOp = seconds * 1e9 / iterations;
+        result.pointsPerSec = seconds > 0 ? points * iterations / seconds : 0;
+        result.allocsPerOp = (double)(benchAllocations - allocationsBefore) / iterations;
+        result.bytesPerOp = (double)(benchAllocatedBytes - bytesBefore) / iterations;
+        results.push_back(result);
+        out << result.toJson() << endl;
+    }
+
+    const vector<BenchResult>& getResults() const { return results; }
+
+protected:
+    vector<string> filter;
+    double minSeconds;
+    size_t minIterations;
+    size_t maxIterations;
+    ostream& out;
+    vector<BenchResult> results;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../../trading/Candle.hpp"
+#include "../TimePoint.hpp"
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+const time_sec BENCH_DATA_START = 1600000000;
+
+// Small deterministic generator (xorshift64*), same data on every machine and run
+class BenchRandom {
+public:
+    BenchRandom(uint64_t seed = 1): state(seed ? seed : 1) {}
+
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ull;
+    }
+
+    // Uniform in [-1, 1)
+    double symmetric() {
+        return (double)(next() >> 11) / (double)(1ull << 52) - 1.0;
+    }
+
+protected:
+    uint64_t state;
+};
+
+// Random walk ticks, 1-3 seconds apart
+inline vector<TimePoint> benchTicks(size_t count, uint64_t seed = 1) {
+    BenchRandom random(seed);
+    vector<TimePoint> ticks;
+    ticks.reserve(count);
+    time_sec time = BENCH_DATA_START;
+    double price = 100.0;
+    for (size_t n = 0; n < count; n++) {
+        time += 1 + (time_sec)(random.next() % 3);
+        price += random.symmetric() * 0.05;
+        if (price < 1) price = 1;
+        ticks.push_back(TimePoint(time, (float)price));
+    }
+    return ticks;
+}
+
+// Random walk candles of the given interval
+inline vector<Candle> benchCandles(size_t count, time_sec interval = 60, uint64_t seed = 1) {
+    BenchRandom random(seed);
+    vector<Candle> candles;
+    candles.reserve(count);
+    double close = 100.0;
+    for (size_t n = 0; n < count; n++) {
+        const double open = close;
+        close = open + random.symmetric() * 0.5;
+        if (close < 1) close = 1;
+        const double high = max(open, close) + (random.next() % 100) * 0.002;
+        const double low = min(open, close) - (random.next() % 100) * 0.002;
+        candles.push_back(Candle(
+            BENCH_DATA_START + (time_sec)n * interval,
+            (float)open, (float)high, (float)low, (float)close,
+            (float)(random.next() % 1000)
+        ));
+    }
+    return candles;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../../misc/Canvas.hpp"
+#include <string>
+
+using namespace std;
+
+// Canvas that draws nothing, the benchmarks wrap it in a RecordingCanvas to
+// count the primitives (so the drawing calls can't be optimized away)
+class NullCanvas: public Canvas {
+public:
+    NullCanvas(int canvasWidth = 1920, int canvasHeight = 1080):
+        canvasWidth(canvasWidth),
+        canvasHeight(canvasHeight)
+    {}
+
+    virtual ~NullCanvas() {}
+
+    void line(int, int, int, int, unsigned int, int = 0) override {}
+    void circle(int, int, int, unsigned int) override {}
+    void circlef(int, int, int, unsigned int) override {}
+    void rect(int, int, int, int, unsigned int) override {}
+    void rectf(int, int, int, int, unsigned int) override {}
+    void text(int, int, const string&, unsigned int, int = 0, int = 14) override {}
+    void measure(const string& text, int& width, int& height, int& descent, int = 0, int size = 14) override {
+        width = (int)text.size() * size / 2;
+        height = size;
+        descent = size / 4;
+    }
+    int width() override { return canvasWidth; }
+    int height() override { return canvasHeight; }
+    void clear() override {}
+
+protected:
+    int canvasWidth;
+    int canvasHeight;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../Chart.hpp"
+#include "Bench.hpp"
+#include "BenchData.hpp"
+#include "../RecordingCanvas.hpp"
+#include "NullCanvas.hpp"
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// View the middle part of the data (fraction of the time range)
+inline void bench_Chart_viewMiddle(Chart& chart, double fraction) {
+    const time_sec first = chart.getValueFirst();
+    const time_sec duration = chart.getValueLast() - first;
+    const time_sec visible = (time_sec)(duration * fraction);
+    chart.setViewFirst(first + (duration - visible) / 2);
+    chart.setViewLast(first + (duration + visible) / 2);
+}
+
+inline void bench_Chart(Bench& bench, size_t size) {
+    const vector<TimePoint> ticks = benchTicks(size);
+    const vector<Candle> candles = benchCandles(size);
+    NullCanvas target;
+    RecordingCanvas canvas(target);
+
+    bench.run("Chart::fitToPoints", size, size, [&]() {
+        Chart chart(canvas);
+        chart.fitToPoints(ticks);
+        benchKeep(chart.getValueUpper());
+    });
+
+    bench.run("Chart::fitToCandles", size, size, [&]() {
+        Chart chart(canvas);
+        chart.fitToCandles(candles);
+        benchKeep(chart.getValueUpper());
+    });
+
+    Chart pointsChart(canvas);
+    pointsChart.fitToPoints(ticks);
+    bench_Chart_viewMiddle(pointsChart, 0.1);
+
+    Chart candlesChart(canvas);
+    candlesChart.fitToCandles(candles);
+    bench_Chart_viewMiddle(candlesChart, 0.1);
+
+    bench.run("Chart::getVisiblePoints", size, size, [&]() {
+        vector<TimePoint> visible = pointsChart.getVisiblePoints(ticks);
+        benchKeep(visible.size());
+    });
+
+    bench.run("Chart::getVisibleCandles", size, size, [&]() {
+        vector<Candle> visible = candlesChart.getVisibleCandles(candles);
+        benchKeep(visible.size());
+    });
+
+    bench.run("Chart::fitToVisiblePoints", size, size, [&]() {
+        pointsChart.fitToVisiblePoints(ticks);
+        benchKeep(pointsChart.getValueUpper());
+    });
+
+    bench.run("Chart::fitToVisibleCandles", size, size, [&]() {
+        candlesChart.fitToVisibleCandles(candles);
+        benchKeep(candlesChart.getValueUpper());
+    });
+
+    const vector<TimePoint> visibleTicks = pointsChart.getVisiblePoints(ticks);
+    const vector<Candle> visibleCandles = candlesChart.getVisibleCandles(candles);
+
+    bench.run("Chart::showPoints", size, visibleTicks.size(), [&]() {
+        pointsChart.showPoints(visibleTicks);
+        benchKeep(canvas.getPrimitives());
+    });
+
+    bench.run("Chart::showBars", size, visibleTicks.size(), [&]() {
+        pointsChart.showBars(visibleTicks);
+        benchKeep(canvas.getPrimitives());
+    });
+
+    bench.run("Chart::showCandles", size, visibleCandles.size(), [&]() {
+        candlesChart.showCandles(visibleCandles, 60);
+        benchKeep(canvas.getPrimitives());
+    });
+
+    // Zoomed in far enough to draw every candle with its body
+    Chart zoomedChart(canvas);
+    zoomedChart.fitToCandles(candles);
+    bench_Chart_viewMiddle(zoomedChart, min(1.0, 200.0 / size));
+    const vector<Candle> zoomedCandles = zoomedChart.getVisibleCandles(candles);
+    bench.run("Chart::showCandles/bodies", size, zoomedCandles.size(), [&]() {
+        zoomedChart.showCandles(zoomedCandles, 60);
+        benchKeep(canvas.getPrimitives());
+    });
+
+    // An op is a zoom in and a zoom out (or a scroll there and back), so the view stays put
+    bench.run("Chart::zoomAt", size, 2, [&]() {
+        pointsChart.zoomAt(pointsChart.getZoomInFactor(), canvas.width() / 2);
+        pointsChart.zoomAt(pointsChart.getZoomOutFactor(), canvas.width() / 2);
+        benchKeep(pointsChart.getViewFirst());
+    });
+
+    bench.run("Chart::scrollBy", size, 2, [&]() {
+        pointsChart.scrollBy(10);
+        pointsChart.scrollBy(-10);
+        benchKeep(pointsChart.getViewFirst());
+    });
+
+    // The steps of Fl_ChartBox::draw() for a candle and a point series in one pane,
+    // on the recording canvas instead of the screen
+    bench.run("Chart::fullDraw", size, size * 2, [&]() {
+        Chart chart(canvas);
+        chart.fitToCandles(candles);
+        chart.fitToPoints(ticks);
+        bench_Chart_viewMiddle(chart, 0.1);
+        vector<Candle> visibleC = chart.getVisibleCandles(candles);
+        chart.fitToVisibleCandles(visibleC);
+        vector<TimePoint> visibleP = chart.getVisiblePoints(ticks);
+        chart.fitToVisiblePoints(visibleP);
+        chart.showCandles(visibleC, 60);
+        chart.showPoints(visibleP);
+        benchKeep(canvas.getPrimitives());
+    });
+}
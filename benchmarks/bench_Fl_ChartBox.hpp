@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../Fl_ChartBox.hpp"
+#include "Bench.hpp"
+#include "BenchData.hpp"
+#include "bench_Chart.hpp"
+
+using namespace std;
+
+// Exposes the per pane steps of draw(), the drawing itself needs a display
+class BenchFl_ChartBox: public Fl_ChartBox {
+public:
+    using Fl_ChartBox::Fl_ChartBox;
+    using Fl_ChartBox::fitPane;
+};
+
+inline void bench_Fl_ChartBox(Bench& bench, size_t size) {
+    vector<Candle> candles = benchCandles(size);
+    const time_sec first = candles.front().getTime();
+    const time_sec last = candles.back().getTime();
+    BenchFl_ChartBox chartBox(0, 0, 1920, 1080);
+    chartBox.addCandleSeries(CandleSeries(candles, SymbolInterval("BENCH", 60), first, last));
+    vector<Candle>().swap(candles); // the chart box has its own copy
+    chartBox.addPointSeries(TimePointSeries(benchTicks(size)));
+
+    chartBox.fitPane(0);
+    bench_Chart_viewMiddle(chartBox.getChart(), 0.1);
+
+    bench.run("Fl_ChartBox::fitPane", size, size * 2, [&]() {
+        chartBox.fitPane(0);
+        benchKeep(chartBox.getChart().getValueUpper());
+    });
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../InteractionReplayer.hpp"
+#include "BenchData.hpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <ostream>
+
+using namespace std;
+
+// Replays a recorded session (see InteractionRecorder) headless, against one
+// synchronized 1920x540 chart box per recorded chart showing the generated
+// candles (the first one) or ticks, and prints the latency report as a JSON line.
+inline void bench_InteractionReplayer(ostream& out, const string& filename, size_t size, bool realtime) {
+    const vector<InteractionEvent> events = InteractionRecorder::load(filename);
+    size_t charts = 1;
+    for (const InteractionEvent& event: events) charts = max(charts, event.chart + 1);
+
+    const vector<Candle> candles = benchCandles(size);
+    const vector<TimePoint> ticks = benchTicks(size);
+    ChartGroup group;
+    vector<unique_ptr<Fl_ImageChartBox>> owned;
+    vector<Fl_ChartBox*> chartBoxes;
+    vector<Fl_ImageChartBox*> imageChartBoxes;
+    for (size_t n = 0; n < charts; n++) {
+        owned.push_back(make_unique<Fl_ImageChartBox>(1920, 540));
+        Fl_ImageChartBox& chartBox = *owned.back();
+        if (n == 0) chartBox.addCandleSeries(CandleSeries(candles, SymbolInterval("BENCH", 60), candles.front().getTime(), candles.back().getTime()));
+        else chartBox.addPointSeries(TimePointSeries(ticks));
+        group.addChart(chartBox.getChart());
+        chartBox.setChartGroup(&group);
+        chartBox.render();
+        chartBoxes.push_back(&chartBox);
+        imageChartBoxes.push_back(&chartBox);
+    }
+
+    InteractionReplayer replayer(InteractionReplayer::applyTo(chartBoxes), InteractionReplayer::renderImages(imageChartBoxes), realtime);
+    out << replayer.replay(events, "InteractionReplayer::replay/" + to_string(size)).toJson() << endl;
+}
@@ -0,0 +1,56 @@
+// Benchmarks of the chart hot paths on generated random walk data.
+// Built like tests/tests.cpp (without -DTEST, with optimizations), e.g.
+//   ./benchmarks --sizes=1e4,1e6 --filter=Chart::show > results.jsonl
+// Each result is a JSON line: name, size, iterations, ns_per_op, points_per_sec,
+// allocs_per_op and bytes_per_op.
+// With --replay=session.csv (see InteractionRecorder) the recorded session is
+// replayed on each size instead, the result is its input latency report.
+
+#include "../../misc/ConsoleLogger.hpp"
+#include "../../misc/Arguments.hpp"
+#include "../../misc/explode.hpp"
+#include "Bench.hpp"
+#include "bench_Chart.hpp"
+#include "bench_Fl_ChartBox.hpp"
+#include "bench_InteractionReplayer.hpp"
+#include <new>
+#include <cstdlib>
+
+// Count every allocation (see Bench::run)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // malloc/free pairs, the replacement is global
+void* operator new(size_t size) {
+    benchAllocations++;
+    benchAllocatedBytes += size;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) throw bad_alloc();
+    return ptr;
+}
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+
+int main(int argc, char** argv) {
+    createLogger<ConsoleLogger>();
+    Arguments args(argc, argv);
+    args.addHelper("filter", "Filter benchmarks by name - optional, comma separated.");
+    args.addHelper("sizes", "Dataset sizes - optional, comma separated (1e4 .. 1e8), default: 1e4,1e5,1e6");
+    args.addHelper("min-time", "Minimum seconds per benchmark - optional, default: 0.2");
+    args.addHelper("replay", "Recorded interaction session to replay - optional.");
+    args.addHelper("realtime", "Replay the session at its recorded pace - optional, default: 0");
+    const vector<string> filter = trim(explode(",", args.getopt<string>("filter", "")));
+    const vector<string> sizes = trim(explode(",", args.getopt<string>("sizes", "1e4,1e5,1e6")));
+    const double minSeconds = stod(args.getopt<string>("min-time", "0.2"));
+    const string replay = args.getopt<string>("replay", "");
+    const bool realtime = args.getopt<string>("realtime", "0") != "0";
+
+    // Results go to stdout as JSON lines
+    Bench bench(filter, minSeconds);
+    for (const string& size: sizes) {
+        const size_t count = (size_t)stod(size);
+        if (!replay.empty()) {
+            bench_InteractionReplayer(cout, replay, count, realtime);
+            continue;
+        }
+        bench_Chart(bench, count);
+        bench_Fl_ChartBox(bench, count);
+    }
+}
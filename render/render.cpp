@@ -0,0 +1,69 @@
+// Headless batch renderer: series files to PNG chart images on all cores.
+// Needs no FLTK and no display. Build it like tests/tests.cpp, without -DTEST,
+// with optimizations and -pthread, e.g.
+//   ./render --list=charts.txt --out=png --width=800 --chart-height=200
+// Each line of the list is one image: comma separated series files, one chart each,
+// stacked like UI_MultiChart does. The image is <out>/<name of the first file>.png.
+// The result goes to stdout as a JSON line (images, charts, failed, seconds,
+// charts_per_sec), the errors go to stderr.
+
+#include "../../misc/ConsoleLogger.hpp"
+#include "../../misc/Arguments.hpp"
+#include "../../misc/explode.hpp"
+#include "../ChartBatchRenderer.hpp"
+#include <iostream>
+#include <fstream>
+
+int main(int argc, char** argv) {
+    createLogger<ConsoleLogger>();
+    Arguments args(argc, argv);
+    args.addHelper("list", "File listing the images, one line each: comma separated series files.");
+    args.addHelper("out", "Output folder - optional, default: .");
+    args.addHelper("width", "Image width - optional, default: 800");
+    args.addHelper("chart-height", "Height of each chart - optional, default: 200");
+    args.addHelper("spacing", "Spacing around the charts - optional, default: 10");
+    args.addHelper("candles", "The files have time, open, high, low, close columns - optional, default: 0");
+    args.addHelper("threads", "Render threads - optional, default: one per core");
+    const string list = args.getopt<string>("list", "");
+    const string out = args.getopt<string>("out", ".");
+    if (list.empty()) {
+        cerr << "Missing --list" << endl;
+        return 1;
+    }
+
+    BatchChartLayout layout;
+    layout.width = args.getopt<int>("width", layout.width);
+    layout.chartHeight = args.getopt<int>("chart-height", layout.chartHeight);
+    layout.spacing = args.getopt<int>("spacing", layout.spacing);
+    layout.candles = args.getopt<int>("candles", 0) != 0;
+
+    vector<BatchChartJob> jobs;
+    ifstream listFile(list);
+    if (!listFile) {
+        cerr << "Unable to open file: " << list << endl;
+        return 1;
+    }
+    string line;
+    while (getline(listFile, line)) {
+        vector<string> files;
+        for (const string& file: trim(explode(",", line)))
+            if (!file.empty()) files.push_back(file);
+        if (files.empty()) continue;
+        const size_t slash = files[0].find_last_of('/');
+        string name = slash == string::npos ? files[0] : files[0].substr(slash + 1);
+        const size_t dot = name.find_last_of('.');
+        if (dot != string::npos && dot > 0) name = name.substr(0, dot);
+        jobs.push_back({ files, out + "/" + name + ".png" });
+    }
+
+    RenderPool pool(args.getopt<size_t>("threads", 0));
+    ChartBatchRenderer renderer(layout, pool);
+    BatchChartStats stats = renderer.run(jobs);
+    for (const string& error: stats.errors) cerr << error << endl;
+    cout << "{\"images\":" << stats.images
+        << ",\"charts\":" << stats.charts
+        << ",\"failed\":" << stats.failed
+        << ",\"seconds\":" << stats.seconds
+        << ",\"charts_per_sec\":" << stats.getChartsPerSecond() << "}" << endl;
+    return stats.failed ? 2 : 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+using namespace std;
+
+// Heap allocations, incremented by the replaced operator new in tests.cpp
+inline atomic<size_t> testAllocations{0};
+
+// Allocations made since it was constructed (or reset)
+class AllocationCounter {
+public:
+    AllocationCounter(): start(testAllocations) {}
+
+    size_t getCount() const { return testAllocations - start; }
+    void reset() { start = testAllocations; }
+
+protected:
+    size_t start;
+};
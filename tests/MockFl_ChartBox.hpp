@@ -11,10 +11,28 @@ public:
     using Fl_ChartBox::candlesSerieses;
     using Fl_ChartBox::barsSerieses;
     using Fl_ChartBox::pointsSerieses;
+    using Fl_ChartBox::windowedSerieses;
+    using Fl_ChartBox::windowedFrames;
+    using Fl_ChartBox::adaptedSerieses;
+    using Fl_ChartBox::indicators;
     using Fl_ChartBox::group;
     using Fl_ChartBox::lastDragX;
+    using Fl_ChartBox::tailPending;
+    using Fl_ChartBox::tailTime;
+    using Fl_ChartBox::tailLeft;
+    using Fl_ChartBox::tailWidth;
+    using Fl_ChartBox::preparedBounds;
+    using Fl_ChartBox::paneDirty;
     
     // Expose protected methods for testing
     using Fl_ChartBox::onMouseWheel;
     using Fl_ChartBox::onDrag;
+    using Fl_ChartBox::fitPane;
+    using Fl_ChartBox::drawPane;
+    using Fl_ChartBox::getPaneCount;
+    using Fl_ChartBox::fitPaneCached;
+    using Fl_ChartBox::rememberDrawnScale;
+    using Fl_ChartBox::beginFrameStats;
+    using Fl_ChartBox::endFrameStats;
+    using Fl_ChartBox::prepare;
 };
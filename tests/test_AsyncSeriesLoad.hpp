@@ -0,0 +1,135 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../AsyncSeriesLoad.hpp"
+#include "../TimePoint.hpp"
+#include <vector>
+#include <mutex>
+#include <stdexcept>
+
+using namespace std;
+
+// Collects the posted tasks, the test plays the UI thread by running them
+struct test_AsyncSeriesLoad_Queue {
+    mutex mtx;
+    vector<function<void()>> tasks;
+
+    AsyncSeriesLoad<TimePoint>::Poster poster() {
+        return [this](function<void()> task) {
+            lock_guard<mutex> lock(mtx);
+            tasks.push_back(task);
+        };
+    }
+
+    void runAll() {
+        vector<function<void()>> pending;
+        {
+            lock_guard<mutex> lock(mtx);
+            pending.swap(tasks);
+        }
+        for (function<void()>& task: pending) task();
+    }
+};
+
+// Loaded chunks should reach the consumer in order and the last call should be finished
+TEST(test_AsyncSeriesLoad_delivers_chunks_in_order) {
+    test_AsyncSeriesLoad_Queue queue;
+    vector<TimePoint> received;
+    bool finished = false;
+
+    shared_ptr<AsyncSeriesLoad<TimePoint>> load = AsyncSeriesLoad<TimePoint>::start(
+        [](AsyncSeriesLoad<TimePoint>& load) {
+            for (int chunk = 0; chunk < 10; chunk++) {
+                vector<TimePoint> points;
+                for (int i = 0; i < 100; i++)
+                    points.push_back(TimePoint(chunk * 100 + i, (float)i));
+                load.append(points);
+            }
+        },
+        [&](vector<TimePoint>& points, bool done) {
+            received.insert(received.end(), points.begin(), points.end());
+            if (done) finished = true;
+        },
+        queue.poster()
+    );
+    load->wait();
+    queue.runAll();
+    queue.runAll(); // the finishing flush may be posted after the first run
+
+    assert(load->isDone() && "Load should be done after wait");
+    assert(finished && "Consumer should get the finished flag");
+    assert(received.size() == 1000 && "Consumer should get every point");
+    for (size_t n = 0; n < received.size(); n++)
+        assert(received[n].getTime() == (time_sec)n && "Points should arrive in order");
+}
+
+// Flushes should be coalesced while one is pending
+TEST(test_AsyncSeriesLoad_coalesces_flushes) {
+    test_AsyncSeriesLoad_Queue queue;
+    size_t calls = 0;
+
+    shared_ptr<AsyncSeriesLoad<TimePoint>> load = AsyncSeriesLoad<TimePoint>::start(
+        [](AsyncSeriesLoad<TimePoint>& load) {
+            for (int i = 0; i < 50; i++) load.append({ TimePoint(i, 1.0f) });
+        },
+        [&](vector<TimePoint>&, bool) { calls++; },
+        queue.poster()
+    );
+    load->wait();
+
+    {
+        lock_guard<mutex> lock(queue.mtx);
+        assert(queue.tasks.size() == 1 && "Only one flush should be pending at a time");
+    }
+    queue.runAll();
+    queue.runAll();
+    assert(calls >= 1 && calls <= 2 && "Consumer should be called once for the data (and once more for finishing at most)");
+}
+
+// Cancelled loads should not reach the consumer
+TEST(test_AsyncSeriesLoad_cancel_stops_delivery) {
+    test_AsyncSeriesLoad_Queue queue;
+    size_t calls = 0;
+    atomic<bool> release{false};
+
+    shared_ptr<AsyncSeriesLoad<TimePoint>> load = AsyncSeriesLoad<TimePoint>::start(
+        [&](AsyncSeriesLoad<TimePoint>& load) {
+            load.append({ TimePoint(1, 1.0f) });
+            while (!release) this_thread::yield();
+            while (!load.isCancelled()) load.append({ TimePoint(2, 2.0f) });
+        },
+        [&](vector<TimePoint>&, bool) { calls++; },
+        queue.poster()
+    );
+    load->cancel();
+    release = true;
+    load->wait();
+    queue.runAll();
+    queue.runAll();
+
+    assert(load->isCancelled() && "Load should be cancelled");
+    assert(calls == 0 && "Consumer should not be called after cancel");
+}
+
+// Exceptions of the loader should be kept as error message
+TEST(test_AsyncSeriesLoad_loader_exception_sets_error) {
+    test_AsyncSeriesLoad_Queue queue;
+    bool finished = false;
+
+    shared_ptr<AsyncSeriesLoad<TimePoint>> load = AsyncSeriesLoad<TimePoint>::start(
+        [](AsyncSeriesLoad<TimePoint>&) {
+            throw runtime_error("file not found");
+        },
+        [&](vector<TimePoint>&, bool done) { finished = done; },
+        queue.poster()
+    );
+    load->wait();
+    queue.runAll();
+
+    assert(load->getError() == "file not found" && "Error message should be kept");
+    assert(finished && "Consumer should still get the finished flag");
+}
+
+#endif // TEST
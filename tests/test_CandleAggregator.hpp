@@ -0,0 +1,159 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../CandleAggregator.hpp"
+#include <vector>
+#include <cmath>
+#include <deque>
+
+using namespace std;
+
+// First tick should open a new candle aligned to the interval
+TEST(test_CandleAggregator_first_tick_opens_candle) {
+    CandleSeries series({}, SymbolInterval("BTCUSDT", 60), 0, 0);
+    CandleAggregator aggregator(series);
+
+    assert(aggregator.addTick(125, 10.0f, 2.0f) && "First tick should be accepted");
+
+    const vector<Candle>& candles = series.getCandlesCRef();
+    assert(candles.size() == 1 && "Should have 1 candle after first tick");
+    assert(candles[0].getTime() == 120 && "Candle time should be aligned to the interval");
+    assert(candles[0].getOpen() == 10.0f && "Open should be the first price");
+    assert(candles[0].getHigh() == 10.0f && "High should be the first price");
+    assert(candles[0].getLow() == 10.0f && "Low should be the first price");
+    assert(candles[0].getClose() == 10.0f && "Close should be the first price");
+    assert(candles[0].getVolume() == 2.0f && "Volume should be the first tick volume");
+}
+
+// Ticks inside the interval should update the last candle only
+TEST(test_CandleAggregator_updates_current_candle) {
+    CandleSeries series({}, SymbolInterval("BTCUSDT", 60), 0, 0);
+    CandleAggregator aggregator(series);
+
+    aggregator.addTick(120, 10.0f, 1.0f);
+    aggregator.addTick(130, 12.0f, 1.0f);
+    aggregator.addTick(140, 8.0f, 1.0f);
+    aggregator.addTick(179, 11.0f, 1.0f);
+
+    const vector<Candle>& candles = series.getCandlesCRef();
+    assert(candles.size() == 1 && "Ticks within the interval should not roll over");
+    assert(candles[0].getOpen() == 10.0f && "Open should be kept");
+    assert(candles[0].getHigh() == 12.0f && "High should be the max price");
+    assert(candles[0].getLow() == 8.0f && "Low should be the min price");
+    assert(candles[0].getClose() == 11.0f && "Close should be the last price");
+    assert(candles[0].getVolume() == 4.0f && "Volume should be accumulated");
+}
+
+// A tick past the interval boundary should roll over to a new candle
+TEST(test_CandleAggregator_rolls_over_at_boundary) {
+    CandleSeries series({}, SymbolInterval("BTCUSDT", 60), 0, 0);
+    CandleAggregator aggregator(series);
+
+    aggregator.addTick(120, 10.0f);
+    aggregator.addTick(180, 11.0f);
+    aggregator.addTick(400, 12.0f);
+
+    const vector<Candle>& candles = series.getCandlesCRef();
+    assert(candles.size() == 3 && "Each boundary crossing should open a new candle");
+    assert(candles[1].getTime() == 180 && "Second candle should start at 180");
+    assert(candles[2].getTime() == 360 && "Gaps should not be filled, third candle starts at 360");
+}
+
+// Late ticks for closed candles and NaN prices should be ignored
+TEST(test_CandleAggregator_ignores_late_and_nan_ticks) {
+    CandleSeries series({}, SymbolInterval("BTCUSDT", 60), 0, 0);
+    CandleAggregator aggregator(series);
+
+    aggregator.addTick(180, 10.0f);
+    assert(!aggregator.addTick(100, 99.0f) && "Late tick should be rejected");
+    assert(!aggregator.addTick(190, numeric_limits<float>::quiet_NaN()) && "NaN tick should be rejected");
+
+    const vector<Candle>& candles = series.getCandlesCRef();
+    assert(candles.size() == 1 && "Rejected ticks should not add candles");
+    assert(candles[0].getHigh() == 10.0f && "Rejected ticks should not change the candle");
+}
+
+// Negative times should still be floored to the interval start
+TEST(test_CandleAggregator_getCandleTime_negative) {
+    CandleSeries series({}, SymbolInterval("BTCUSDT", 60), 0, 0);
+    CandleAggregator aggregator(series);
+
+    assert(aggregator.getCandleTime(-1) == -60 && "Negative time should floor down");
+    assert(aggregator.getCandleTime(-60) == -60 && "Boundary time should map to itself");
+    assert(aggregator.getCandleTime(59) == 0 && "Positive time should floor down");
+}
+
+// Changed range should cover only the touched tail candles
+TEST(test_CandleAggregator_tracks_changed_range) {
+    vector<Candle> history = {
+        Candle(0, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f),
+        Candle(60, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f)
+    };
+    CandleSeries series(history, SymbolInterval("BTCUSDT", 60), 0, 60);
+    CandleAggregator aggregator(series);
+
+    assert(!aggregator.hasChanges() && "No changes before any tick");
+
+    aggregator.addTick(70, 2.0f);
+    assert(aggregator.hasChanges() && "Tick should mark a change");
+    assert(aggregator.getChangedFrom() == 1 && "Only the last candle should be changed");
+    assert(aggregator.getChangedTo() == 2 && "Changed range end should be exclusive");
+
+    aggregator.addTick(130, 3.0f);
+    assert(aggregator.getChangedFrom() == 1 && "Changed range should keep its start");
+    assert(aggregator.getChangedTo() == 3 && "Changed range should grow with the rolled over candle");
+
+    aggregator.clearChanges();
+    assert(!aggregator.hasChanges() && "clearChanges should reset the changed range");
+}
+
+// Invalid interval should throw
+TEST(test_CandleAggregator_invalid_interval_throws) {
+    CandleSeries series({}, SymbolInterval("BTCUSDT", 0), 0, 0);
+    bool thrown = false;
+    try {
+        CandleAggregator aggregator(series);
+    } catch (...) {
+        thrown = true;
+    }
+    assert(thrown && "Zero interval should throw");
+}
+
+// One tick stream should feed multiple intervals
+TEST(test_MultiCandleAggregator_multiple_intervals) {
+    CandleSeries series1m({}, SymbolInterval("BTCUSDT", 60), 0, 0);
+    CandleSeries series5m({}, SymbolInterval("BTCUSDT", 300), 0, 0);
+    MultiCandleAggregator aggregator;
+    aggregator.addCandleSeries(series1m);
+    aggregator.addCandleSeries(series5m);
+
+    for (time_sec t = 0; t < 600; t += 30)
+        assert(aggregator.addTick(t, (float)t) == 2 && "Both series should accept the tick");
+
+    assert(series1m.getCandlesCRef().size() == 10 && "1m series should have 10 candles");
+    assert(series5m.getCandlesCRef().size() == 2 && "5m series should have 2 candles");
+    assert(series5m.getCandlesCRef()[1].getOpen() == 300.0f && "5m candle should open at the first tick of its interval");
+    assert(series5m.getCandlesCRef()[1].getClose() == 570.0f && "5m candle should close at the last tick of its interval");
+    assert(aggregator.hasChanges() && "Multi aggregator should report changes");
+
+    aggregator.clearChanges();
+    assert(!aggregator.hasChanges() && "clearChanges should reset all aggregators");
+}
+
+// Aggregators returned by addCandleSeries should stay valid as more series are added
+TEST(test_MultiCandleAggregator_returned_aggregator_stays_valid) {
+    deque<CandleSeries> serieses;
+    MultiCandleAggregator aggregator;
+    serieses.push_back(CandleSeries({}, SymbolInterval("BTCUSDT", 60), 0, 0));
+    CandleAggregator& first = aggregator.addCandleSeries(serieses.back());
+    for (int n = 0; n < 100; n++) {
+        serieses.push_back(CandleSeries({}, SymbolInterval("BTCUSDT", 60 * (n + 2)), 0, 0));
+        aggregator.addCandleSeries(serieses.back());
+    }
+    assert(&first == &aggregator.getAggregator(0) && "The first aggregator should not move");
+    assert(first.addTick(125, 10.0f) && serieses.front().getCandlesCRef().size() == 1 && "The first aggregator should still feed its series");
+}
+
+#endif // TEST
@@ -7,6 +7,7 @@
 #include "MockCanvas.hpp"
 #include "TestChart.hpp"
 #include "MockShowLineChart.hpp"
+#include "../RecordingCanvas.hpp"
 #include <vector>
 #include <limits>
 #include <cmath>
@@ -1119,4 +1120,83 @@ TEST(test_Chart_zoomAt_at_max_zoom) {
     assert(chart.viewLast <= 1000 && "zoomAt should not exceed data last");
 }
 
+// showCandlesRange should draw the candles of its range only (e.g. the tail changed by a CandleAggregator)
+TEST(test_Chart_showCandlesRange_tail_only) {
+    vector<Candle> candles = {
+        Candle(100, 3.0f, 9.0f, 2.0f, 7.0f, 0.0f),
+        Candle(200, 4.0f, 10.0f, 3.0f, 8.0f, 0.0f),
+        Candle(300, 5.0f, 11.0f, 4.0f, 9.0f, 0.0f)
+    };
+    MockCanvas mock(800, 600);
+    RecordingCanvas canvas(mock);
+    TestChart chart(canvas);
+    chart.fitToCandles(candles);
+    chart.resetView();
+
+    chart.showCandlesRange(candles, 0, 3, 60);
+    const size_t perCandle = canvas.getColorCount(CHART_COLOR_BULLISH) / 3;
+    assert(perCandle > 0 && canvas.getColorCount(CHART_COLOR_BULLISH) == perCandle * 3 && "Each candle should draw the same calls");
+
+    canvas.reset();
+    chart.showCandlesRange(candles, 2, 3, 60);
+    assert(canvas.getColorCount(CHART_COLOR_BULLISH) == perCandle && "Tail range should draw the last candle only");
+
+    canvas.reset();
+    chart.showCandlesRange(candles, 3, 3, 60);
+    assert(canvas.getPrimitives() == 0 && "Empty range should draw nothing");
+
+    canvas.reset();
+    chart.showCandlesRange(candles, 1, 100, 60);
+    assert(canvas.getColorCount(CHART_COLOR_BULLISH) == perCandle * 2 && "Range should be clamped to the candles");
+}
+
+inline bool test_Chart_same_commands(const CanvasCommand& a, const CanvasCommand& b) {
+    return
+        a.primitive == b.primitive && a.color == b.color &&
+        a.left == b.left && a.top == b.top && a.left2 == b.left2 && a.top2 == b.top2 &&
+        a.width == b.width && a.height == b.height;
+}
+
+// The commands of a tail draw should be the last ones of the full draw
+inline bool test_Chart_is_tail_of(const vector<CanvasCommand>& tail, const vector<CanvasCommand>& full) {
+    if (tail.size() > full.size()) return false;
+    for (size_t n = 0; n < tail.size(); n++)
+        if (!test_Chart_same_commands(tail[n], full[full.size() - tail.size() + n])) return false;
+    return true;
+}
+
+// A tail redraw should pick the merged candles and the decimated vertices of the full draw
+TEST(test_Chart_tail_from_lines_up_with_full_draw) {
+    vector<Candle> candles;
+    vector<TimePoint> points;
+    for (size_t n = 0; n < 2000; n++) {
+        const float close = 50.0f + (float)(n % 17) - (float)(n % 5);
+        candles.push_back(Candle(1000 + (time_sec)n * 60, close - 1, close + 2, close - 2, close, 1.0f));
+        points.push_back(TimePoint(1000 + (time_sec)n * 60, close));
+    }
+    MockCanvas mock(800, 600);
+    RecordingCanvas canvas(mock, true);
+    TestChart chart(canvas);
+    chart.fitToCandles(candles);
+    chart.resetView();
+
+    chart.showCandlesRange(candles, 0, candles.size(), 60);
+    const vector<CanvasCommand> fullCandles = canvas.getCommands();
+    for (size_t index: { (size_t)1000, (size_t)1501, (size_t)1999 }) {
+        canvas.reset();
+        chart.showCandlesRange(candles, chart.getCandlesTailFrom(0, index, 60), candles.size(), 60);
+        assert(!canvas.getCommands().empty() && test_Chart_is_tail_of(canvas.getCommands(), fullCandles) && "Tail candles should be merged as in the full draw");
+    }
+    assert(chart.getCandlesTailFrom(10, 5, 60) == 10 && "A tail before the start should start there");
+
+    canvas.reset();
+    chart.showPointsRange(points, 0, points.size());
+    const vector<CanvasCommand> fullPoints = canvas.getCommands();
+    for (size_t index: { (size_t)1000, (size_t)1501, (size_t)1999 }) { // the last point is not a vertex
+        canvas.reset();
+        chart.showPointsRange(points, chart.getPointsTailFrom(points, 0, index), points.size());
+        assert(test_Chart_is_tail_of(canvas.getCommands(), fullPoints) && "Tail lines should connect the vertices of the full draw");
+    }
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,202 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../ChartBatchRenderer.hpp"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+
+using namespace std;
+
+// Reads deflate bits LSB first (Huffman codes MSB first)
+struct test_ChartBatchRenderer_BitReader {
+    const vector<unsigned char>& data;
+    size_t bit = 0;
+
+    uint32_t get(int length) {
+        uint32_t value = 0;
+        for (int n = 0; n < length; n++, bit++)
+            value |= ((data.at(bit / 8) >> (bit % 8)) & 1) << n;
+        return value;
+    }
+
+    uint32_t getCode(int length) {
+        uint32_t code = 0;
+        for (int n = 0; n < length; n++) code = (code << 1) | get(1);
+        return code;
+    }
+};
+
+// Inflate the fixed Huffman blocks with short distances PngWriter emits
+inline vector<unsigned char> test_ChartBatchRenderer_inflate(const vector<unsigned char>& zlib) {
+    static const int bases[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    static const int extras[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    vector<unsigned char> data(zlib.begin() + 2, zlib.end() - 4);
+    test_ChartBatchRenderer_BitReader reader{ data };
+    vector<unsigned char> out;
+    bool final = false;
+    while (!final) {
+        final = reader.get(1);
+        assert(reader.get(2) == 1 && "Only fixed Huffman blocks expected");
+        while (true) {
+            uint32_t code = reader.getCode(7);
+            int symbol;
+            if (code <= 23) symbol = 256 + code;
+            else {
+                code = (code << 1) | reader.get(1);
+                if (code >= 0x30 && code <= 0xBF) symbol = code - 0x30;
+                else if (code >= 0xC0 && code <= 0xC7) symbol = 280 + code - 0xC0;
+                else symbol = 144 + ((code << 1) | reader.get(1)) - 0x190;
+            }
+            if (symbol < 256) {
+                out.push_back((unsigned char)symbol);
+                continue;
+            }
+            if (symbol == 256) break;
+            const int length = bases[symbol - 257] + reader.get(extras[symbol - 257]);
+            const uint32_t distanceCode = reader.getCode(5);
+            assert(distanceCode < 4 && "Only short distances expected");
+            const size_t distance = distanceCode + 1;
+            for (int n = 0; n < length; n++) out.push_back(out[out.size() - distance]);
+        }
+    }
+    assert(PngWriter::getAdler32(out.data(), out.size()) == 
+        ((uint32_t)zlib[zlib.size() - 4] << 24 | (uint32_t)zlib[zlib.size() - 3] << 16 | 
+         (uint32_t)zlib[zlib.size() - 2] << 8 | zlib[zlib.size() - 1]) && "Adler32 should match");
+    return out;
+}
+
+inline uint32_t test_ChartBatchRenderer_bigEndian(const vector<unsigned char>& data, size_t at) {
+    return (uint32_t)data[at] << 24 | (uint32_t)data[at + 1] << 16 | (uint32_t)data[at + 2] << 8 | data[at + 3];
+}
+
+// Decode a PNG of PngWriter back to RGB rows (checking the chunk CRCs on the way)
+inline vector<unsigned char> test_ChartBatchRenderer_decode(const vector<unsigned char>& png, int& width, int& height) {
+    assert(png.size() > 8 && png[0] == 0x89 && png[1] == 'P' && png[2] == 'N' && png[3] == 'G' && "PNG signature expected");
+    vector<unsigned char> idat;
+    size_t at = 8;
+    while (at < png.size()) {
+        const uint32_t length = test_ChartBatchRenderer_bigEndian(png, at);
+        const string type(png.begin() + at + 4, png.begin() + at + 8);
+        assert(PngWriter::getCrc32(png.data() + at + 4, 4 + length) == test_ChartBatchRenderer_bigEndian(png, at + 8 + length) && "Chunk CRC should match");
+        if (type == "IHDR") {
+            width = (int)test_ChartBatchRenderer_bigEndian(png, at + 8);
+            height = (int)test_ChartBatchRenderer_bigEndian(png, at + 12);
+        }
+        if (type == "IDAT") idat.insert(idat.end(), png.begin() + at + 8, png.begin() + at + 8 + length);
+        at += 12 + length;
+    }
+    const vector<unsigned char> filtered = test_ChartBatchRenderer_inflate(idat);
+    const size_t rowBytes = (size_t)width * 3;
+    assert(filtered.size() == (rowBytes + 1) * height && "Scanlines should cover the image");
+    vector<unsigned char> rgb(rowBytes * height);
+    for (int y = 0; y < height; y++) {
+        const unsigned char filter = filtered[y * (rowBytes + 1)];
+        for (size_t n = 0; n < rowBytes; n++) {
+            unsigned char value = filtered[y * (rowBytes + 1) + 1 + n];
+            if (filter == 2 && y > 0) value += rgb[(y - 1) * rowBytes + n];
+            rgb[y * rowBytes + n] = value;
+        }
+    }
+    return rgb;
+}
+
+inline vector<TimePoint> test_ChartBatchRenderer_points(size_t count) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++)
+        points.push_back(TimePoint(1000 + (time_sec)n * 60, (float)(n % 19) + 1.0f));
+    return points;
+}
+
+// Checksums should match the reference values
+TEST(test_PngWriter_checksums) {
+    const string text = "IEND";
+    assert(PngWriter::getCrc32((const unsigned char*)text.data(), text.size()) == 0xAE426082 && "CRC32 of IEND should match");
+    const string wiki = "Wikipedia";
+    assert(PngWriter::getAdler32((const unsigned char*)wiki.data(), wiki.size()) == 0x11E60398 && "Adler32 should match");
+}
+
+// An encoded image should decode to the same pixels
+TEST(test_PngWriter_round_trip) {
+    ImageCanvas image(37, 23, 0x102030);
+    image.rectf(3, 4, 10, 5, 0xFF8000);
+    image.line(0, 22, 36, 0, 0x00FF00);
+    vector<unsigned char> png;
+    PngWriter::encode(image, png);
+    assert(png.size() < image.getPixels().size() && "Flat image should compress");
+
+    int width = 0, height = 0;
+    vector<unsigned char> rgb = test_ChartBatchRenderer_decode(png, width, height);
+    assert(width == 37 && height == 23 && "Size should be kept");
+    assert(rgb == image.getPixels() && "Pixels should be kept");
+}
+
+// The charts should be stacked like UI_MultiChart does, each one in its own band
+TEST(test_ChartBatchRenderer_render_stacks_charts) {
+    BatchChartLayout layout;
+    layout.width = 300;
+    layout.chartHeight = 100;
+    layout.spacing = 10;
+    layout.color = 0x00FF00;
+    ChartBatchRenderer renderer(layout);
+    vector<BatchChartData> charts(2);
+    charts[0].points = test_ChartBatchRenderer_points(200);
+    charts[1].points = test_ChartBatchRenderer_points(50);
+
+    ImageCanvas image;
+    renderer.render(charts, image);
+    assert(image.width() == 300 && image.height() == 220 && "Image should fit the charts and the spacing");
+
+    size_t inFirst = 0, inSecond = 0, outside = 0;
+    for (int y = 0; y < image.height(); y++)
+        for (int x = 0; x < image.width(); x++) {
+            if (image.getPixel(x, y) != 0x00FF00) continue;
+            if (x < 10 || x >= 290) outside++;
+            else if (y >= 10 && y < 110) inFirst++;
+            else if (y >= 110 && y < 210) inSecond++;
+            else outside++;
+        }
+    assert(inFirst > 100 && inSecond > 100 && "Each chart should be drawn in its band");
+    assert(outside == 0 && "Nothing should be drawn into the spacing");
+}
+
+// A batch should write every image it can and report the ones it can't
+TEST(test_ChartBatchRenderer_run) {
+    BatchChartLayout layout;
+    layout.width = 200;
+    layout.chartHeight = 80;
+    RenderPool pool(2);
+    ChartBatchRenderer renderer(layout, pool);
+    renderer.setLoader([](const string& filename, const BatchChartLayout&, BatchChartData& data) {
+        if (filename == "broken") throw ERROR("Unable to open file: broken");
+        data.points = test_ChartBatchRenderer_points(100);
+    });
+
+    vector<BatchChartJob> jobs;
+    for (int n = 0; n < 8; n++)
+        jobs.push_back({ { "a", "b" }, "/tmp/test_ChartBatchRenderer_" + to_string(n) + ".png" });
+    jobs.push_back({ { "broken" }, "/tmp/test_ChartBatchRenderer_broken.png" });
+    BatchChartStats stats = renderer.run(jobs);
+
+    assert(stats.images == 8 && stats.charts == 16 && "Every good image should be written");
+    assert(stats.failed == 1 && stats.errors.size() == 1 && "Broken image should be reported");
+    assert(stats.getChartsPerSecond() > 0 && "Throughput should be reported");
+
+    ifstream file("/tmp/test_ChartBatchRenderer_3.png", ios::binary);
+    vector<unsigned char> png((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    int width = 0, height = 0;
+    test_ChartBatchRenderer_decode(png, width, height);
+    assert(width == 200 && height == layout.getImageHeight(2) && "Written image should decode");
+    for (int n = 0; n < 8; n++) remove(("/tmp/test_ChartBatchRenderer_" + to_string(n) + ".png").c_str());
+}
+
+#endif // TEST
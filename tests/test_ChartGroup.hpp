@@ -7,6 +7,7 @@
 #include "MockCanvas.hpp"
 #include "TestChart.hpp"
 #include <vector>
+#include <string>
 
 using namespace std;
 
@@ -279,5 +280,33 @@ TEST(test_ChartGroup_setSyncXAxis_toggle) {
     assert(chart2.valueLast == 1500 && "Chart2 should have shared valueLast after enabling sync");
 }
 
+// The group should call onBeforeSync before it changes the views (then onSync)
+TEST(test_ChartGroup_onBeforeSync_precedes_view_change) {
+    MockCanvas canvas1(800, 600);
+    MockCanvas canvas2(800, 600);
+    TestChart chart1(canvas1);
+    TestChart chart2(canvas2);
+    chart1.fitToPoints({{0, 0.0f}, {1000, 10.0f}});
+    chart2.fitToPoints({{500, 5.0f}, {1500, 15.0f}});
+    chart1.resetView();
+    chart2.resetView();
+
+    ChartGroup group;
+    group.addChart(chart1);
+    group.addChart(chart2);
+    vector<string> calls;
+    vector<time_sec> seenLast;
+    group.onBeforeSync = [&]() { calls.push_back("before"); seenLast.push_back(chart1.viewLast); };
+    group.onSync = [&]() { calls.push_back("sync"); };
+
+    group.synchronizeXAxis();
+    assert(seenLast.size() == 1 && seenLast[0] == 1000 && "onBeforeSync should see the view before the sync");
+    assert(chart1.viewLast == 1500 && "The view should be synced after onBeforeSync");
+
+    calls.clear();
+    group.scrollBy(100);
+    group.zoomAt(2.0, 400);
+    assert(calls == vector<string>({ "before", "sync", "before", "sync" }) && "onBeforeSync should precede each synced scroll and zoom");
+}
 
 #endif
@@ -0,0 +1,175 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../ChartStats.hpp"
+#include "../Chart.hpp"
+#include "MockCanvas.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+inline vector<TimePoint> test_ChartStats_points(size_t count) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++)
+        points.push_back(TimePoint(1000 + (time_sec)n * 10, (float)(n % 29)));
+    return points;
+}
+
+inline vector<Candle> test_ChartStats_candles(size_t count) {
+    vector<Candle> candles;
+    for (size_t n = 0; n < count; n++) {
+        float open = (float)(n % 13) + 10.0f;
+        float close = (float)(n % 7) + 10.0f;
+        candles.push_back(Candle(1000 + (time_sec)n * 60, open, max(open, close) + 1.0f, min(open, close) - 1.0f, close, 0.0f));
+    }
+    return candles;
+}
+
+// Lines drawn by showPoints should be counted, at most one per point
+TEST(test_ChartStats_counts_lines_of_points) {
+    MockCanvas canvas;
+    Chart chart(canvas);
+    vector<TimePoint> points = test_ChartStats_points(100);
+    chart.fitToPoints(points);
+    chart.resetView();
+
+    ChartCounters counters;
+    chart.setCounters(&counters);
+    chart.showPoints(points);
+    assert(counters.lines > 0 && "Lines should be counted");
+    assert(counters.lines <= points.size() && "At most one line per point");
+    assert(counters.rects == 0 && "Points should draw no rects");
+
+    chart.setCounters(nullptr);
+    const size_t lines = counters.lines;
+    chart.showPoints(points);
+    assert(counters.lines == lines && "Detached counters should not change");
+}
+
+// Candles should be counted by the level of details they were drawn at
+TEST(test_ChartStats_counts_candles_by_lod) {
+    MockCanvas canvas;
+    Chart chart(canvas);
+    ChartCounters counters;
+    chart.setCounters(&counters);
+
+    vector<Candle> few = test_ChartStats_candles(10);
+    chart.fitToCandles(few);
+    chart.resetView();
+    chart.showCandles(few, 60);
+    assert(counters.candlesFull == 10 && "Wide candles should be drawn with body");
+    assert(counters.rects > 0 && "Bodies should be counted as rects");
+
+    vector<Candle> many = test_ChartStats_candles(100000);
+    chart.resetBounds();
+    chart.fitToCandles(many);
+    chart.setViewFirst(many.front().getTime());
+    chart.setViewLast(many.back().getTime());
+    chart.showCandles(many, 60);
+    assert(counters.candlesMerged == 100000 && "Narrow candles should be merged");
+    assert(counters.lines < 100000 && "Merged candles should draw fewer lines than candles");
+}
+
+// Series timer should record scanned/culled points and the primitives of the series
+TEST(test_ChartStats_series_timer_records_series) {
+    ChartPaneStats paneStats;
+    ChartCounters counters;
+    {
+        ChartSeriesTimer timer(&paneStats, counters, "points", 2, 100, 30);
+        counters.lines += 29;
+    }
+    assert(paneStats.series.size() == 1 && "Series should be recorded");
+    assert(paneStats.series[0].kind == "points" && paneStats.series[0].index == 2 && "Series should be identified");
+    assert(paneStats.series[0].pointsCulled == 70 && "Points out of the view should be culled");
+    assert(paneStats.series[0].lines == 29 && paneStats.lines == 29 && "Lines should be the delta of the counters");
+    assert(paneStats.pointsScanned == 100 && "Pane should sum its series");
+
+    { ChartSeriesTimer timer(nullptr, counters, "points", 0, 100, 30); }
+    assert(paneStats.series.size() == 1 && "Nothing should be recorded without stats");
+}
+
+// Disabled stats should not be collected
+TEST(test_Fl_ChartBox_stats_disabled_by_default) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_ChartStats_points(1000)));
+    assert(!chartBox.isStatsEnabled() && "Stats should be off by default");
+
+    chartBox.beginFrameStats(false);
+    chartBox.fitPane(0);
+    chartBox.endFrameStats();
+    assert(chartBox.getLastFrameStats().frame == 0 && "No frame should be counted");
+    assert(chartBox.getLastFrameStats().panes.empty() && "No pane should be recorded");
+    assert(chartBox.chart.getCounters() == nullptr && "Chart should not count");
+}
+
+// Enabled stats should time the phases of each pane and report the frame
+TEST(test_Fl_ChartBox_stats_records_phases) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_ChartStats_points(10000)));
+    chartBox.addPointSeries(TimePointSeries(test_ChartStats_points(100)), 1);
+    chartBox.setStatsEnabled(true);
+    size_t reported = 0;
+    chartBox.onFrameStats = [&reported](const ChartFrameStats&) { reported++; };
+
+    chartBox.beginFrameStats(false);
+    assert(chartBox.chart.getCounters() != nullptr && "Chart should count during a frame");
+    chartBox.fitPane(0);
+    chartBox.fitPane(1);
+    chartBox.endFrameStats();
+    assert(chartBox.chart.getCounters() == nullptr && "Chart should stop counting after the frame");
+
+    const ChartFrameStats& stats = chartBox.getLastFrameStats();
+    assert(stats.frame == 1 && !stats.tail && reported == 1 && "Frame should be reported");
+    assert(stats.panes.size() == 2 && "Each pane should be recorded");
+    assert(stats.panes[0].phaseNs[CHART_PHASE_FIT] > 0 && "Fit phase should be timed");
+    assert(stats.panes[0].getTotalNs() <= stats.totalNs && "Phases should fit in the frame");
+
+    // Redraw outside of a frame (e.g. redrawTail) should not touch the stats
+    chartBox.fitPane(0);
+    assert(chartBox.getLastFrameStats().frame == 1 && "Fitting outside a frame should not count");
+}
+
+// A zoomed adapted series should report the points out of the view as culled
+TEST(test_Fl_ChartBox_stats_culls_adapted_series) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addCandleSeries(CandleSeries(test_ChartStats_candles(10000), SymbolInterval("TEST", 60), 0, 0));
+    chartBox.addCandleFieldSeries(CANDLE_FIELD_VOLUME, 1, 0, 0, 0x00FF00, true);
+    chartBox.setStatsEnabled(true);
+    chartBox.beginFrameStats(false);
+    chartBox.fitPane(1);
+    chartBox.chart.setViewFirst(1000 + 5000 * 60);
+    chartBox.chart.setViewLast(1000 + 5999 * 60);
+    chartBox.drawPane(1);
+    chartBox.endFrameStats();
+
+    const vector<ChartSeriesStats>& series = chartBox.getLastFrameStats().panes[1].series;
+    assert(!series.empty() && series.back().kind == string("adapted") && "The adapted series should be recorded");
+    assert(series.back().pointsScanned == 10000 && series.back().pointsCulled == 9000 && "Only the points in the view should be visible");
+}
+
+// Windowed series cache hits and misses should be counted per pane
+TEST(test_Fl_ChartBox_stats_counts_cache_hits) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_ChartStats_points(100000)));
+    chartBox.addLazyPointIndicator([]() { return make_shared<EmaIndicator>(50); }, 200);
+    chartBox.chart.setViewFirst(1000 + 50000 * 10);
+    chartBox.chart.setViewLast(1000 + 51000 * 10);
+    chartBox.setStatsEnabled(true);
+
+    chartBox.beginFrameStats(false);
+    chartBox.fitPane(0);
+    chartBox.endFrameStats();
+    assert(chartBox.getLastFrameStats().panes[0].cacheMisses > 0 && "First view should be computed");
+
+    chartBox.beginFrameStats(false);
+    chartBox.fitPane(0);
+    chartBox.endFrameStats();
+    assert(chartBox.getLastFrameStats().panes[0].cacheMisses == 0 && "Same view should not be computed again");
+    assert(chartBox.getLastFrameStats().panes[0].cacheHits > 0 && "Same view should be found in the cache");
+}
+
+#endif // TEST
@@ -0,0 +1,104 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../ChartVirtualizer.hpp"
+#include "MockCanvas.hpp"
+#include <vector>
+
+using namespace std;
+
+// 300 charts of 100px, 10px from the top
+inline void test_ChartVirtualizer_watchlist(ChartVirtualizer& virtualizer) {
+    for (int n = 0; n < 300; n++) virtualizer.addSlot(10 + n * 100, 100);
+}
+
+// Only the charts intersecting the viewport and the buffer should be live
+TEST(test_ChartVirtualizer_live_range_covers_viewport_and_buffer) {
+    ChartVirtualizer virtualizer(2);
+    test_ChartVirtualizer_watchlist(virtualizer);
+    assert(virtualizer.getContentHeight() == 10 + 300 * 100 && "Content should span all the charts");
+
+    size_t from, to;
+    virtualizer.getLiveRange(0, 500, from, to);
+    assert(from == 0 && to == 7 && "Top: 5 visible + 2 buffer below");
+
+    virtualizer.getLiveRange(10 + 100 * 100 + 50, 500, from, to);
+    assert(from == 98 && to == 108 && "Middle: 6 partly visible + 2 buffer on both sides");
+
+    virtualizer.getLiveRange(30000, 500, from, to);
+    assert(from == 297 && to == 300 && "Bottom: clamped to the last chart");
+
+    virtualizer.getLiveRange(100000, 500, from, to);
+    assert(from == to && "Past the charts nothing should be live");
+
+    virtualizer.getLiveRange(0, 0, from, to);
+    assert(from == to && "Empty viewport should have nothing live");
+}
+
+// Scrolling should release the charts that left and acquire the ones that entered
+TEST(test_ChartVirtualizer_update_reports_changes) {
+    ChartVirtualizer virtualizer(1);
+    test_ChartVirtualizer_watchlist(virtualizer);
+    vector<size_t> released, acquired;
+
+    virtualizer.update(0, 300, released, acquired);
+    assert(released.empty() && acquired.size() == 4 && "First update should acquire the view");
+    assert(virtualizer.isLive(3) && !virtualizer.isLive(4) && "Live range should be remembered");
+
+    virtualizer.update(0, 300, released, acquired);
+    assert(released.empty() && acquired.empty() && "Same view should change nothing");
+
+    virtualizer.update(300, 300, released, acquired);
+    assert(released.size() == 1 && released[0] == 0 && "Chart scrolled out should be released");
+    assert(acquired.size() == 3 && acquired[0] == 4 && acquired[2] == 6 && "Charts scrolled in should be acquired");
+
+    virtualizer.update(20000, 300, released, acquired);
+    assert(released.size() == 6 && acquired.size() == 6 && "Jump should swap the whole live range");
+}
+
+// The number of live charts should not depend on the number of charts
+TEST(test_ChartVirtualizer_live_count_independent_of_chart_count) {
+    ChartVirtualizer few(2), many(2);
+    for (int n = 0; n < 10; n++) few.addSlot(n * 100, 100);
+    test_ChartVirtualizer_watchlist(many);
+    vector<size_t> released, acquired;
+    few.update(0, 500, released, acquired);
+    many.update(0, 500, released, acquired);
+    assert(few.getLiveTo() - few.getLiveFrom() == many.getLiveTo() - many.getLiveFrom() && "Same viewport, same live charts");
+}
+
+// Slots have to be added top to bottom
+TEST(test_ChartVirtualizer_rejects_overlapping_slots) {
+    ChartVirtualizer virtualizer;
+    virtualizer.addSlot(0, 100);
+    bool thrown = false;
+    try {
+        virtualizer.addSlot(50, 100);
+    } catch (exception&) {
+        thrown = true;
+    }
+    assert(thrown && "Overlapping slot should throw");
+}
+
+// View state should survive a chart going offscreen and coming back
+TEST(test_ChartVirtualizer_view_state_round_trip) {
+    MockCanvas canvas;
+    Chart chart(canvas);
+    chart.setViewFirst(1000);
+    chart.setViewLast(2000);
+    ChartViewState state;
+    state.save(chart);
+
+    chart.clearView();
+    assert(!chart.isViewInitialized() && "Recycled chart should forget its view");
+    state.restore(chart);
+    assert(chart.isViewInitialized() && chart.getViewFirst() == 1000 && chart.getViewLast() == 2000 && "View should be restored");
+
+    ChartViewState empty;
+    empty.restore(chart);
+    assert(!chart.isViewInitialized() && "Never viewed chart should get the full range again");
+}
+
+#endif // TEST
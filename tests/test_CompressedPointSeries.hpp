@@ -0,0 +1,132 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../CompressedPointSeries.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <cstring>
+
+using namespace std;
+
+// Deterministic random walk with mostly regular ticks, some irregular gaps and jumps
+inline vector<TimePoint> test_CompressedPointSeries_walk(size_t count) {
+    vector<TimePoint> points;
+    unsigned long long seed = 12345;
+    time_sec time = 1700000000;
+    float value = 100.0f;
+    for (size_t n = 0; n < count; n++) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const unsigned r = (unsigned)(seed >> 33);
+        if (r % 97 == 0) time += 100000 + r % 5000; // session gap
+        else if (r % 13 == 0) time += r % 300;      // irregular tick
+        else time += 1;                             // regular tick
+        value += ((int)(r % 21) - 10) * 0.01f;
+        points.push_back(TimePoint(time, value));
+    }
+    return points;
+}
+
+// Decoded points should be bit exact
+TEST(test_CompressedPointSeries_roundtrip) {
+    vector<TimePoint> points = test_CompressedPointSeries_walk(5000);
+    points.push_back(TimePoint(points.back().getTime(), numeric_limits<float>::quiet_NaN()));
+    points.push_back(TimePoint(points.back().getTime() + (1ll << 40), -1e30f)); // huge delta of delta
+    points.push_back(TimePoint(points.back().getTime() + 1, 0.0f));
+    CompressedPointSeries series(points, CHART_COLOR_PLOTTER, 256);
+
+    assert(series.size() == points.size() && "Should hold every point");
+    assert(series.getBlockCount() == (points.size() + 255) / 256 && "Should split into blocks");
+
+    vector<TimePoint> decoded;
+    series.getPoints(series.getFirstTime(), series.getLastTime(), decoded);
+    assert(decoded.size() == points.size() && "Should decode every point");
+    for (size_t n = 0; n < points.size(); n++) {
+        float a = points[n].getValue();
+        float b = decoded[n].getValue();
+        assert(decoded[n].getTime() == points[n].getTime() && "Time should be exact");
+        assert(memcmp(&a, &b, sizeof(float)) == 0 && "Value should be bit exact");
+    }
+}
+
+// Block summaries should hold first/last/min/max and ignore NaN
+TEST(test_CompressedPointSeries_block_summaries) {
+    CompressedPointSeries series({
+        {10, 5.0f}, {20, numeric_limits<float>::quiet_NaN()}, {30, 1.0f},
+        {40, 9.0f}, {50, 2.0f}, {60, 3.0f}
+    }, CHART_COLOR_PLOTTER, 3);
+
+    const vector<SeriesBlockSummary>& summaries = series.getBlockSummaries();
+    assert(summaries.size() == 2 && "Should have 2 blocks");
+    assert(summaries[0].first == 10 && summaries[0].last == 30 && "First block time range");
+    assert(summaries[0].firstValue == 5.0f && summaries[0].lastValue == 1.0f && "First block first/last values");
+    assert(summaries[0].minValue == 1.0f && summaries[0].maxValue == 5.0f && "First block min/max should ignore NaN");
+    assert(summaries[1].minValue == 2.0f && summaries[1].maxValue == 9.0f && "Second block min/max");
+    assert(summaries[1].count == 3 && "Second block count");
+}
+
+// Only the blocks overlapping the window should be returned
+TEST(test_CompressedPointSeries_window_selects_blocks) {
+    vector<TimePoint> points;
+    for (int i = 0; i < 100; i++) points.push_back(TimePoint(i * 10, (float)i));
+    CompressedPointSeries series(points, CHART_COLOR_PLOTTER, 10);
+
+    vector<SeriesBlockSummary> summaries;
+    series.getSummaries(250, 420, summaries);
+    assert(summaries.size() == 3 && "Blocks 2, 3 and 4 overlap the window");
+    assert(summaries.front().first == 200 && "First overlapping block starts at 200");
+
+    vector<TimePoint> decoded;
+    series.getPoints(250, 420, decoded);
+    assert(decoded.size() == 30 && "Should decode only the overlapping blocks");
+    assert(decoded.front().getTime() == 200 && decoded.back().getTime() == 490 && "Decoded whole blocks");
+
+    series.getPoints(5000, 6000, decoded);
+    assert(decoded.empty() && "Window after the data should be empty");
+}
+
+// Regular ticks should compress well below the size of TimePoint vectors
+TEST(test_CompressedPointSeries_compression_ratio) {
+    vector<TimePoint> points = test_CompressedPointSeries_walk(100000);
+    CompressedPointSeries series(points);
+    size_t rawBytes = points.size() * sizeof(TimePoint);
+    assert(series.getCompressedBytes() * 5 < rawBytes && "Should be at least 5x smaller than raw points");
+}
+
+// Out of order append should throw
+TEST(test_CompressedPointSeries_out_of_order_throws) {
+    CompressedPointSeries series;
+    series.append(TimePoint(100, 1.0f));
+    bool thrown = false;
+    try {
+        series.append(TimePoint(50, 1.0f));
+    } catch (...) {
+        thrown = true;
+    }
+    assert(thrown && "Appending an older point should throw");
+}
+
+// Fl_ChartBox should draw zoomed out windowed series from summaries and zoomed in from points
+TEST(test_Fl_ChartBox_windowed_series_summary_level) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    vector<TimePoint> points;
+    for (int i = 0; i < 100000; i++) points.push_back(TimePoint(1000 + i, (float)(i % 100)));
+    chartBox.addWindowedSeries(make_shared<CompressedPointSeries>(points, CHART_COLOR_PLOTTER, 64));
+
+    chartBox.fitPane(0);
+    assert(chartBox.windowedFrames[0][0].summaryLevel && "Full view should use the summaries");
+    assert(chartBox.windowedFrames[0][0].points.empty() && "No points should be decoded at summary level");
+    assert(chartBox.chart.getValueLower() == 0.0f && chartBox.chart.getValueUpper() == 99.0f && "Y should fit to the summaries");
+
+    chartBox.chart.setViewFirst(50000);
+    chartBox.chart.setViewLast(50500);
+    chartBox.fitPane(0);
+    assert(!chartBox.windowedFrames[0][0].summaryLevel && "Zoomed in view should use the points");
+    assert(chartBox.windowedFrames[0][0].points.size() <= 640 && "Only the overlapping blocks should be decoded");
+    assert(chartBox.chart.getValueFirst() == 1000 && "Time range should cover the whole series");
+}
+
+#endif // TEST
@@ -0,0 +1,174 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../CsvImporter.hpp"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+
+using namespace std;
+
+// Writes the content to a temporary file and removes it when going out of scope
+struct test_CsvImporter_TempFile {
+    string filename;
+
+    test_CsvImporter_TempFile(const string& name, const string& content): filename("/tmp/" + name) {
+        ofstream file(filename, ios::binary);
+        file << content;
+    }
+
+    ~test_CsvImporter_TempFile() {
+        remove(filename.c_str());
+    }
+};
+
+// Points should be imported from the mapped columns, header skipped
+TEST(test_CsvImporter_importPoints_basic) {
+    test_CsvImporter_TempFile file("test_CsvImporter_points.csv",
+        "time,price,volume\n"
+        "100,1.5,10\n"
+        "200,2.5,20\n"
+        "300,3.5,30\n"
+    );
+    CsvImporter importer(file.filename);
+    vector<TimePoint> points;
+    importer.importPoints(points, 0, 2);
+
+    assert(points.size() == 3 && "Should import 3 points");
+    assert(points[0].getTime() == 100 && "First time should be 100");
+    assert(points[2].getValue() == 30.0f && "Value should come from the mapped column");
+    assert(importer.getSkippedLines() == 0 && "No line should be skipped");
+}
+
+// Broken and empty lines should be skipped and counted, CRLF should be handled
+TEST(test_CsvImporter_importPoints_skips_broken_lines) {
+    test_CsvImporter_TempFile file("test_CsvImporter_broken.csv",
+        "100;1.5\r\n"
+        "oops;2.5\r\n"
+        "\r\n"
+        "300\r\n"
+        "400; 4.5\r\n"
+    );
+    CsvImporter importer(file.filename, ';', false);
+    vector<TimePoint> points;
+    importer.importPoints(points);
+
+    assert(points.size() == 2 && "Should import the 2 valid lines");
+    assert(points[1].getTime() == 400 && "Second valid line should be imported");
+    assert(points[1].getValue() == 4.5f && "Leading spaces should be allowed");
+    assert(importer.getSkippedLines() == 2 && "Broken lines should be counted, empty lines ignored");
+}
+
+// Numbers followed by anything but spaces should not be taken, the first broken line should be told
+TEST(test_CsvImporter_partly_parsed_fields_are_broken) {
+    test_CsvImporter_TempFile file("test_CsvImporter_partial.csv",
+        "time,price\n"
+        "100,1.5\n"
+        "\n"
+        "200,2.5x\n"
+        "300x,3.5\n"
+        "400,4.5 \n"
+        "2023-11-14,5\n"
+    );
+    CsvImporter importer(file.filename);
+    vector<TimePoint> points;
+    importer.importPoints(points);
+    assert(points.size() == 2 && points[1].getTime() == 400 && "Partly parsed fields should skip their line, trailing spaces are fine");
+    assert(importer.getSkippedLines() == 3 && "Partly parsed lines should be counted");
+    assert(importer.getFirstSkippedLine() == 4 && "The first broken line should be told by its line number in the file");
+
+    test_CsvImporter_TempFile dtFile("test_CsvImporter_partial_dt.csv",
+        "2023-11-14 22:13:20Z,1\n"
+        "2023-11-14 22:13:20+02:00,2\n"
+    );
+    CsvImporter dtImporter(dtFile.filename, ',', false, CsvImporter::TIME_DATETIME);
+    vector<TimePoint> dtPoints;
+    dtImporter.importPoints(dtPoints);
+    assert(dtPoints.size() == 1 && dtPoints[0].getTime() == 1700000000 && "UTC date-times should be taken, offsets not");
+    assert(dtImporter.getFirstSkippedLine() == 2 && "The line of the offset should be told");
+
+    string content;
+    for (size_t n = 0; n < 200000; n++) // several chunks
+        content += n == 150000 ? "150000,1.0.0\n" : to_string(n) + "," + to_string(n % 100) + "\n";
+    test_CsvImporter_TempFile bigFile("test_CsvImporter_partial_big.csv", content);
+    CsvImporter bigImporter(bigFile.filename, ',', false, CsvImporter::TIME_SECONDS, 4);
+    vector<TimePoint> bigPoints;
+    bigImporter.importPoints(bigPoints);
+    assert(bigImporter.getSkippedLines() == 1 && bigImporter.getFirstSkippedLine() == 150001 && "Lines should be numbered across the parallel chunks");
+}
+
+// Epoch milliseconds and date-time strings should be converted to seconds
+TEST(test_CsvImporter_time_formats) {
+    test_CsvImporter_TempFile msFile("test_CsvImporter_ms.csv", "1700000000123,1\n");
+    CsvImporter msImporter(msFile.filename, ',', false, CsvImporter::TIME_MILLISECONDS);
+    vector<TimePoint> msPoints;
+    msImporter.importPoints(msPoints);
+    assert(msPoints.size() == 1 && msPoints[0].getTime() == 1700000000 && "Milliseconds should be converted to seconds");
+
+    test_CsvImporter_TempFile dtFile("test_CsvImporter_dt.csv",
+        "2023-11-14 22:13:20,1\n"
+        "1970-01-02T00:00:00.5,2\n"
+        "2000-03-01,3\n"
+    );
+    CsvImporter dtImporter(dtFile.filename, ',', false, CsvImporter::TIME_DATETIME);
+    vector<TimePoint> dtPoints;
+    dtImporter.importPoints(dtPoints);
+    assert(dtPoints.size() == 3 && "Should import date-time lines");
+    assert(dtPoints[0].getTime() == 1700000000 && "Date-time should be converted to epoch seconds");
+    assert(dtPoints[1].getTime() == 86400 && "T separator and fractions should be accepted");
+    assert(dtPoints[2].getTime() == 951868800 && "Date only should be midnight UTC");
+}
+
+// Candles should be imported with optional volume
+TEST(test_CsvImporter_importCandles) {
+    test_CsvImporter_TempFile file("test_CsvImporter_candles.csv",
+        "time,open,high,low,close\n"
+        "60,1,3,0.5,2\n"
+        "120,2,4,1.5,3\n"
+    );
+    CsvImporter importer(file.filename);
+    CandleSeries series({}, SymbolInterval("BTCUSDT", 60), 60, 120);
+    importer.importCandles(series, 0, 1, 2, 3, 4, CSV_NO_COLUMN);
+
+    const vector<Candle>& candles = series.getCandlesCRef();
+    assert(candles.size() == 2 && "Should import 2 candles");
+    assert(candles[1].getTime() == 120 && "Candle time should be parsed");
+    assert(candles[1].getHigh() == 4.0f && "High should be parsed");
+    assert(candles[1].getLow() == 1.5f && "Low should be parsed");
+    assert(candles[1].getVolume() == 0.0f && "Missing volume column should give 0");
+}
+
+// Parallel chunks should keep the file order
+TEST(test_CsvImporter_parallel_keeps_order) {
+    string content;
+    const size_t lines = 200000; // several chunks of minChunkSize
+    content.reserve(lines * 16);
+    for (size_t n = 0; n < lines; n++)
+        content += to_string(n) + "," + to_string(n % 100) + "\n";
+    test_CsvImporter_TempFile file("test_CsvImporter_parallel.csv", content);
+
+    CsvImporter importer(file.filename, ',', false, CsvImporter::TIME_SECONDS, 4);
+    TimePointSeries series({});
+    importer.importPoints(series);
+
+    const vector<TimePoint>& points = series.getPointsCRef();
+    assert(points.size() == lines && "Should import every line");
+    for (size_t n = 0; n < lines; n++)
+        assert(points[n].getTime() == (time_sec)n && "Points should be in file order");
+}
+
+// Missing file should throw
+TEST(test_CsvImporter_missing_file_throws) {
+    bool thrown = false;
+    try {
+        CsvImporter importer("/tmp/test_CsvImporter_does_not_exist.csv");
+    } catch (...) {
+        thrown = true;
+    }
+    assert(thrown && "Missing file should throw");
+}
+
+#endif // TEST
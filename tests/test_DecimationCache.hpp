@@ -0,0 +1,169 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../DecimationCache.hpp"
+#include "../ChartGroup.hpp"
+#include "../TimePointSeries.hpp"
+#include "../ImageCanvas.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+inline TimePointSeries test_DecimationCache_series(size_t count) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++) {
+        const float value = n % 97 == 50 ? NAN : (float)(n % 29) + (float)(n % 11);
+        points.push_back(TimePoint(1000 + (time_sec)n * 5, value));
+    }
+    return TimePointSeries(points, 0xFFFFFF);
+}
+
+inline void test_DecimationCache_fit(Chart& chart, const TimePointSeries& series) {
+    chart.fitToPoints(series.getPointsCRef());
+    chart.resetView();
+    chart.fitToVisiblePoints(series.getPointsCRef());
+}
+
+inline void test_DecimationCache_show(Chart& chart, const TimePointSeries& series, bool bars) {
+    const vector<TimePoint>& points = series.getPointsCRef();
+    if (bars) chart.showBarsRange(points, 0, points.size(), 0x00FF00, series.getId(), series.getVersion());
+    else chart.showPointsRange(points, 0, points.size(), 0xFFFFFF, series.getId(), series.getVersion());
+}
+
+// The cached vertices should draw exactly what the direct decimation draws
+TEST(test_DecimationCache_draws_like_direct) {
+    const TimePointSeries series = test_DecimationCache_series(20000);
+    for (bool bars: { false, true }) {
+        ImageCanvas direct(500, 300), cached(500, 300);
+        Chart directChart(direct), cachedChart(cached);
+        cachedChart.setDecimationCache(make_shared<DecimationCache>());
+        test_DecimationCache_fit(directChart, series);
+        test_DecimationCache_fit(cachedChart, series);
+        test_DecimationCache_show(directChart, series, bars);
+        test_DecimationCache_show(cachedChart, series, bars);
+        assert(direct.countPixels(bars ? 0x00FF00 : 0xFFFFFF) > 100 && "The series should be drawn");
+        assert(direct.getPixels() == cached.getPixels() && "Cached decimation should draw the same pixels");
+    }
+}
+
+// Charts of a group showing the same series in the same view should decimate it once,
+// a copy of the series written apart from it should not take its vertices
+TEST(test_DecimationCache_shared_by_group) {
+    const TimePointSeries series = test_DecimationCache_series(5000);
+    TimePointSeries copy = series; // e.g. added to each chart box
+    ImageCanvas canvas1(500, 300), canvas2(500, 200);
+    Chart chart1(canvas1), chart2(canvas2);
+    ChartGroup group;
+    group.addChart(chart1);
+    group.addChart(chart2);
+    shared_ptr<DecimationCache> cache = group.getDecimationCache();
+    assert(cache && chart1.getDecimationCache() == cache && chart2.getDecimationCache() == cache && "Charts should share the cache of the group");
+
+    test_DecimationCache_fit(chart1, series);
+    test_DecimationCache_fit(chart2, copy);
+    test_DecimationCache_show(chart1, series, false);
+    test_DecimationCache_show(chart2, copy, false);
+    assert(copy.getId() == series.getId() && "Copies should share the id");
+    assert(cache->getMisses() == 1 && cache->getHits() == 1 && "The second chart should reuse the vertices");
+    assert(canvas2.countPixels(0xFFFFFF) > 100 && "The second chart should draw the shared vertices");
+
+    for (size_t n = 0; n < 100; n++) copy.getPointsRef()[n].setValue(1000.0f);
+    assert(copy.getId() != series.getId() && "A written copy should get its own id");
+    test_DecimationCache_show(chart2, copy, false);
+    assert(cache->getMisses() == 2 && "A written copy should not take the vertices of the original");
+    test_DecimationCache_show(chart1, series, false);
+    assert(cache->getHits() == 2 && "The original should keep its vertices");
+    const size_t copyId = copy.getId();
+    const TimePointSeries moved = move(copy);
+    assert(moved.getId() == copyId && copy.getId() != copyId && "A moved series should keep its id");
+
+    group.removeChart(chart2);
+    assert(!chart2.getDecimationCache() && "A removed chart should leave the cache of the group");
+}
+
+// Chart boxes of a group showing copies of one series should decimate it once
+TEST(test_DecimationCache_shared_by_chart_boxes) {
+    const TimePointSeries series = test_DecimationCache_series(5000);
+    ChartGroup group;
+    MockFl_ChartBox chartBox1(0, 0, 500, 300), chartBox2(0, 300, 500, 300);
+    for (MockFl_ChartBox* chartBox: { &chartBox1, &chartBox2 }) {
+        chartBox->addPointSeries(series);
+        group.addChart(chartBox->getChart());
+        chartBox->setChartGroup(&group);
+    }
+    for (MockFl_ChartBox* chartBox: { &chartBox1, &chartBox2 }) {
+        chartBox->fitPane(0);
+        chartBox->drawPane(0);
+    }
+    shared_ptr<DecimationCache> cache = group.getDecimationCache();
+    assert(cache->getMisses() == 1 && cache->getHits() == 1 && "The second chart box should reuse the vertices");
+
+    chartBox2.patchPointSeries(0, 0, { 0, 1, { TimePoint(series.getPointsCRef().back().getTime(), 5.0f) } });
+    for (MockFl_ChartBox* chartBox: { &chartBox1, &chartBox2 }) {
+        chartBox->fitPane(0);
+        chartBox->drawPane(0);
+    }
+    assert(cache->getMisses() == 2 && cache->getHits() == 2 && "Only the patched copy should be decimated again");
+}
+
+// Changes of the series, the range or the resolution should miss the cache
+TEST(test_DecimationCache_key_changes) {
+    TimePointSeries series = test_DecimationCache_series(1000);
+    ImageCanvas canvas(400, 200);
+    Chart chart(canvas);
+    shared_ptr<DecimationCache> cache = make_shared<DecimationCache>();
+    chart.setDecimationCache(cache);
+    test_DecimationCache_fit(chart, series);
+
+    test_DecimationCache_show(chart, series, false);
+    test_DecimationCache_show(chart, series, false);
+    assert(cache->getMisses() == 1 && cache->getHits() == 1 && "Same draw should hit");
+
+    series.getPointsRef().back().setValue(99.0f);
+    test_DecimationCache_show(chart, series, false);
+    assert(cache->getMisses() == 2 && "A tick on the last point should miss");
+
+    series.getPointsRef()[10].setValue(99.0f);
+    test_DecimationCache_show(chart, series, false);
+    assert(cache->getMisses() == 3 && "An edit in place should miss");
+
+    vector<TimePoint>& kept = series.getPointsRef();
+    test_DecimationCache_show(chart, series, false);
+    kept[20].setValue(99.0f);
+    series.changed();
+    test_DecimationCache_show(chart, series, false);
+    assert(cache->getMisses() == 5 && "A new version should miss");
+
+    series.getPointsRef().push_back(TimePoint(1000 + 1000 * 5, 1.0f));
+    test_DecimationCache_show(chart, series, false);
+    assert(cache->getMisses() == 6 && "An append should miss");
+
+    test_DecimationCache_show(chart, series, true);
+    assert(cache->getMisses() == 7 && "Bars should not take the vertices of lines");
+
+    const vector<TimePoint>& points = series.getPointsCRef();
+    chart.showPointsRange(points, 0, points.size(), 0xFFFFFF);
+    assert(cache->getMisses() == 7 && cache->getHits() == 1 && "A series without id should not use the cache");
+}
+
+// The least recently used entries should be dropped
+TEST(test_DecimationCache_evicts_lru) {
+    DecimationCache cache(2);
+    const DecimationKey key1 = { 1, 0, 10, 0, 10, 100, 1.0f, 0, 1000, 400, false };
+    DecimationKey key2 = key1;
+    key2.seriesId = 2;
+    DecimationKey key3 = key1;
+    key3.seriesId = 3;
+    cache.store(key1, make_shared<vector<TimePoint>>());
+    cache.store(key2, make_shared<vector<TimePoint>>());
+    assert(cache.find(key1) && "Key 1 should be cached");
+    cache.store(key3, make_shared<vector<TimePoint>>());
+    assert(cache.size() == 2 && "Cache should stay bounded");
+    assert(cache.find(key1) && cache.find(key3) && !cache.find(key2) && "The least recently used key should be dropped");
+}
+
+#endif // TEST
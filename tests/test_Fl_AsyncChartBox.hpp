@@ -0,0 +1,259 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../Fl_AsyncChartBox.hpp"
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+// Tasks posted to the "UI thread", run by the test thread
+struct test_Fl_AsyncChartBox_Posted {
+    mutex tasksMutex;
+    vector<function<void()>> tasks;
+
+    Fl_AsyncChartBox::Post getPost() {
+        return [this](function<void()> task) {
+            lock_guard<mutex> lock(tasksMutex);
+            tasks.push_back(task);
+        };
+    }
+
+    // Run the posted tasks until the chart box has no frame in flight
+    bool pump(Fl_AsyncChartBox& chartBox) {
+        for (int n = 0; n < 5000 && chartBox.isRendering(); n++) {
+            vector<function<void()>> pending;
+            {
+                lock_guard<mutex> lock(tasksMutex);
+                pending.swap(tasks);
+            }
+            for (function<void()>& task: pending) task();
+            if (pending.empty()) this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        return !chartBox.isRendering();
+    }
+};
+
+inline vector<TimePoint> test_Fl_AsyncChartBox_points(size_t count) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++)
+        points.push_back(TimePoint(1000 + (time_sec)n * 60, (float)(n % 13) + 1.0f));
+    return points;
+}
+
+// Primitives should land on the right pixels, clipped to the image
+TEST(test_ImageCanvas_rasterizes) {
+    ImageCanvas image(20, 10, 0x000000);
+    image.rectf(2, 2, 4, 3, 0xFF0000);
+    assert(image.countPixels(0xFF0000) == 12 && "Filled rect should cover width x height pixels");
+    assert(image.getPixel(2, 2) == 0xFF0000 && image.getPixel(6, 2) == 0x000000 && "Filled rect should stop at its right edge");
+
+    image.line(0, 9, 19, 9, 0x00FF00);
+    assert(image.countPixels(0x00FF00) == 20 && "Horizontal line should cover its pixels including both ends");
+
+    image.rect(15, 0, 10, 3, 0x0000FF);
+    assert(image.getPixel(15, 1) == 0x0000FF && image.getPixel(16, 1) == 0x000000 && "Rect should be an outline");
+
+    image.rectf(-5, -5, 100, 100, 0xFFFFFF);
+    assert(image.countPixels(0xFFFFFF) == 200 && "Drawing should be clipped to the image");
+
+    image.clear();
+    assert(image.countPixels(0x000000) == 200 && "Clear should paint the background");
+}
+
+// The offscreen chart box should draw its series into its image, and stop when cancelled
+TEST(test_Fl_ImageChartBox_render) {
+    Fl_ImageChartBox chartBox(400, 200);
+    chartBox.addPointSeries(TimePointSeries(test_Fl_AsyncChartBox_points(500), 0x00FF00));
+    assert(chartBox.render() && "Render should complete");
+    assert(chartBox.getImage().countPixels(0x00FF00) > 100 && "Line series should be drawn into the image");
+    assert(chartBox.getChart().isViewInitialized() && "Render should fit the chart");
+
+    assert(!chartBox.render([]() { return true; }) && "Cancelled render should report it");
+}
+
+// Stacked panes should draw into their own rows of the image
+TEST(test_Fl_ImageChartBox_renders_stacked_panes) {
+    Fl_ImageChartBox chartBox(400, 300);
+    chartBox.addPointSeries(TimePointSeries(test_Fl_AsyncChartBox_points(500), 0xFF0000));
+    chartBox.addBarSeries(TimePointSeries(test_Fl_AsyncChartBox_points(500), 0x00FF00), 1);
+    int top, height;
+    chartBox.getPaneRegion(1, top, height);
+    assert(top == 150 && height == 150 && "Equal panes should split the inner height");
+    assert(chartBox.render() && "Render should complete");
+
+    const ImageCanvas& image = chartBox.getImage();
+    size_t red = 0, green = 0, misplaced = 0;
+    for (int y = 0; y < 300; y++) {
+        for (int x = 0; x < 400; x++) {
+            const unsigned int color = image.getPixel(x, y);
+            if (color == 0xFF0000) {
+                red++;
+                if (y >= top) misplaced++;
+            }
+            if (color == 0x00FF00) {
+                green++;
+                if (y < top) misplaced++;
+            }
+        }
+    }
+    assert(red > 100 && green > 100 && "Both panes should be drawn");
+    assert(misplaced == 0 && "Each pane should stay in its rows");
+}
+
+// A requested frame should render off thread and be shown, with the fitted view adopted
+TEST(test_Fl_AsyncChartBox_renders_frame) {
+    RenderPool pool(2);
+    test_Fl_AsyncChartBox_Posted posted;
+    Fl_AsyncChartBox chartBox(0, 0, 400, 200, CHART_SPACING_TOP, CHART_SPACING_BOTTOM, CHART_SPACING_LEFT, CHART_SPACING_RIGHT, pool);
+    chartBox.setPost(posted.getPost());
+    chartBox.addPointSeries(TimePointSeries(test_Fl_AsyncChartBox_points(500), 0x00FF00));
+
+    chartBox.requestFrame();
+    assert(chartBox.getGeneration() == 1 && chartBox.isRendering() && "Request should start generation 1");
+    assert(posted.pump(chartBox) && "Frame should finish");
+    assert(chartBox.getShownGeneration() == 1 && chartBox.getRenderedFrames() == 1 && "Finished frame should be shown");
+    assert(chartBox.getShownImage().countPixels(0x00FF00) > 100 && "Shown image should have the series");
+    assert(chartBox.getChart().isViewInitialized() && "View fitted by the renderer should be adopted");
+
+    chartBox.requestFrame();
+    assert(chartBox.getGeneration() == 1 && !chartBox.isRendering() && "Unchanged chart should not render again");
+
+    chartBox.addPointSeries(TimePointSeries(test_Fl_AsyncChartBox_points(10)), 1);
+    chartBox.requestFrame();
+    assert(chartBox.getGeneration() == 2 && "New series should start a new generation");
+    assert(posted.pump(chartBox) && chartBox.getShownGeneration() == 2 && "New generation should be shown");
+}
+
+// A frame superseded before it ran should be dropped, and the newest one rendered instead
+TEST(test_Fl_AsyncChartBox_drops_superseded_frame) {
+    RenderPool pool(1);
+    mutex gate;
+    gate.lock();
+    atomic<bool> blocked{false};
+    shared_ptr<RenderJob> blocker = pool.submit([&](const RenderJob&) {
+        blocked = true;
+        lock_guard<mutex> lock(gate);
+    });
+    while (!blocked) this_thread::yield();
+
+    test_Fl_AsyncChartBox_Posted posted;
+    Fl_AsyncChartBox chartBox(0, 0, 400, 200, CHART_SPACING_TOP, CHART_SPACING_BOTTOM, CHART_SPACING_LEFT, CHART_SPACING_RIGHT, pool);
+    chartBox.setPost(posted.getPost());
+    chartBox.addPointSeries(TimePointSeries(test_Fl_AsyncChartBox_points(500)));
+    chartBox.getChart().setViewFirst(1000);
+    chartBox.getChart().setViewLast(1000 + 100 * 60);
+    chartBox.requestFrame();
+    chartBox.getChart().setViewFirst(1000 + 10 * 60);
+    chartBox.requestFrame();
+    chartBox.getChart().setViewFirst(1000 + 20 * 60);
+    chartBox.requestFrame();
+    assert(chartBox.getGeneration() == 3 && "Each view change should be a generation");
+
+    gate.unlock();
+    pool.wait(blocker);
+    assert(posted.pump(chartBox) && "Frames should finish");
+    assert(chartBox.getShownGeneration() == 3 && "Newest generation should be shown");
+    assert(chartBox.getDroppedFrames() == 1 && chartBox.getRenderedFrames() == 1 && "Superseded frame should be dropped");
+    assert(chartBox.getChart().getViewFirst() == 1000 + 20 * 60 && "View of the UI thread should be kept");
+}
+
+// A patch of the same size should reach the renderer, and the indicators of the patched
+// series should only be told when the frame in flight is done with them
+TEST(test_Fl_AsyncChartBox_patch_waits_for_frame_in_flight) {
+    RenderPool pool(1);
+    mutex gate;
+    gate.lock();
+    atomic<bool> blocked{false};
+    shared_ptr<RenderJob> blocker = pool.submit([&](const RenderJob&) {
+        blocked = true;
+        lock_guard<mutex> lock(gate);
+    });
+    while (!blocked) this_thread::yield();
+
+    test_Fl_AsyncChartBox_Posted posted;
+    Fl_AsyncChartBox chartBox(0, 0, 400, 200, CHART_SPACING_TOP, CHART_SPACING_BOTTOM, CHART_SPACING_LEFT, CHART_SPACING_RIGHT, pool);
+    chartBox.setPost(posted.getPost());
+    vector<TimePoint> points = test_Fl_AsyncChartBox_points(500);
+    chartBox.addPointSeries(TimePointSeries(points, 0x00FF00));
+    shared_ptr<SmaIndicator> sma = make_shared<SmaIndicator>(5);
+    chartBox.addPointIndicator(sma, 0);
+    chartBox.requestFrame();
+    gate.unlock();
+    pool.wait(blocker);
+    assert(posted.pump(chartBox) && "First frame should finish");
+    const size_t outputs = sma->getOutput(0).getPointsCRef().size();
+    assert(outputs > 0 && "The renderer should update the indicator");
+
+    gate.lock();
+    blocked = false;
+    blocker = pool.submit([&](const RenderJob&) {
+        blocked = true;
+        lock_guard<mutex> lock(gate);
+    });
+    while (!blocked) this_thread::yield();
+    chartBox.getChart().setViewFirst(1000 + 10 * 60);
+    chartBox.requestFrame();
+    assert(chartBox.isRendering() && "A frame should be in flight");
+
+    vector<TimePoint> tail(points.end() - 3, points.end());
+    for (TimePoint& point: tail) point = TimePoint(point.getTime(), 100.0f);
+    copy(tail.begin(), tail.end(), points.end() - 3);
+    chartBox.patchPointSeries(0, 0, { 0, 3, tail });
+    assert(sma->getOutput(0).getPointsCRef().size() == outputs && "The indicator should not be touched while the frame is in flight");
+    chartBox.requestFrame();
+    gate.unlock();
+    pool.wait(blocker);
+    assert(posted.pump(chartBox) && chartBox.getShownGeneration() == chartBox.getGeneration() && "Patched frame should be shown");
+
+    SmaIndicator fresh(5);
+    fresh.update(points);
+    const vector<TimePoint>& patched = sma->getOutput(0).getPointsCRef();
+    const vector<TimePoint>& expected = fresh.getOutput(0).getPointsCRef();
+    assert(patched.size() == expected.size() && patched.back().getValue() == expected.back().getValue() && "The indicator should follow the patch");
+    assert(chartBox.getShownImage().countPixels(0x00FF00) > 100 && "The patched series should be drawn");
+    assert(chartBox.getSeriesCopies() == 1 && "The patch should be replayed on the renderer, not copied");
+}
+
+// Patches should be replayed on the copy of the renderer (the frame as if it was copied),
+// any other change should copy the serieses again
+TEST(test_Fl_AsyncChartBox_replays_patches) {
+    RenderPool pool(1);
+    test_Fl_AsyncChartBox_Posted posted;
+    Fl_AsyncChartBox chartBox(0, 0, 400, 200, CHART_SPACING_TOP, CHART_SPACING_BOTTOM, CHART_SPACING_LEFT, CHART_SPACING_RIGHT, pool);
+    chartBox.setPost(posted.getPost());
+    vector<TimePoint> points = test_Fl_AsyncChartBox_points(500);
+    chartBox.addPointSeries(TimePointSeries(points, 0x00FF00));
+    chartBox.requestFrame();
+    assert(posted.pump(chartBox) && chartBox.getSeriesCopies() == 1 && "First frame should copy the serieses");
+
+    for (int tick = 0; tick < 3; tick++) {
+        const TimePoint last = points.back();
+        points.back() = TimePoint(last.getTime(), 30.0f + tick);
+        chartBox.patchPointSeries(0, 0, { 0, 1, { points.back() } });
+    }
+    points.erase(points.begin(), points.begin() + 100);
+    chartBox.patchPointSeries(0, 0, { 100, 0, {} });
+    chartBox.requestFrame();
+    assert(posted.pump(chartBox) && chartBox.getShownGeneration() == chartBox.getGeneration() && "Patched frame should be shown");
+    assert(chartBox.getSeriesCopies() == 1 && "The patches should be replayed, not copied");
+
+    Fl_ImageChartBox expected(400, 200);
+    expected.addPointSeries(TimePointSeries(points, 0x00FF00));
+    expected.getChart().setBounds(chartBox.getChart().getBounds());
+    expected.render();
+    const size_t bytes = (size_t)expected.getImage().width() * expected.getImage().height() * 3;
+    assert(equal(expected.getImage().getData(), expected.getImage().getData() + bytes, chartBox.getShownImage().getData()) && "The renderer should draw the patched serieses");
+
+    chartBox.addPointSeries(TimePointSeries(test_Fl_AsyncChartBox_points(10)), 1);
+    chartBox.patchPointSeries(0, 0, { 1, 0, {} });
+    chartBox.requestFrame();
+    assert(posted.pump(chartBox) && chartBox.getSeriesCopies() == 2 && "A new series should copy the serieses again");
+}
+
+#endif // TEST
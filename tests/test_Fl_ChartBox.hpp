@@ -8,7 +8,11 @@
 #include "MockCanvas.hpp"
 #include "../../trading/CandleSeries.hpp"
 #include "../TimePointSeries.hpp"
+#include "../InteractionRecorder.hpp"
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 
@@ -601,4 +605,269 @@ TEST(test_Fl_ChartBox_TimePointSeries_getPointsCRef) {
     assert(retrievedPoints[2].getTime() == 300 && "Third point time should be 300");
 }
 
+// redrawTail should fall back to a full redraw before the first full draw
+TEST(test_Fl_ChartBox_redrawTail_full_redraw_without_drawn_scale) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries({{100, 5.0f}, {200, 3.0f}, {300, 7.0f}}));
+    chartBox.clear_damage();
+
+    chartBox.redrawTail(300);
+
+    assert(!chartBox.tailPending && "No tail should be pending without a previous full draw");
+    assert((chartBox.damage() & FL_DAMAGE_ALL) && "Should fall back to full redraw");
+}
+
+// redrawTail should damage only the tail column when the scale did not change
+TEST(test_Fl_ChartBox_redrawTail_damages_tail_only) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries({{100, 5.0f}, {200, 3.0f}, {300, 7.0f}, {400, 4.0f}}));
+    chartBox.fitPane(0);
+    chartBox.rememberDrawnScale(1);
+    chartBox.clear_damage();
+
+    // Last point changes within the current Y range
+    chartBox.pointsSerieses[0][0].getPointsRef().back().setValue(6.0f);
+    chartBox.redrawTail(400);
+
+    assert(chartBox.tailPending && "Tail should be pending");
+    assert(chartBox.tailTime == 300 && "Tail should start at the point before the changed one");
+    assert(chartBox.tailLeft > 0 && "Tail column should not start at the left edge");
+    assert(chartBox.tailLeft + chartBox.tailWidth == 800 && "Tail column should reach the right edge");
+    assert(chartBox.damage() == FL_DAMAGE_USER1 && "Only the tail damage should be set");
+}
+
+// redrawTail should fall back to a full redraw when the Y autoscale changes
+TEST(test_Fl_ChartBox_redrawTail_full_redraw_on_scale_change) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries({{100, 5.0f}, {200, 3.0f}, {300, 7.0f}, {400, 4.0f}}));
+    chartBox.fitPane(0);
+    chartBox.rememberDrawnScale(1);
+    chartBox.clear_damage();
+
+    // New high moves the Y autoscale
+    chartBox.pointsSerieses[0][0].getPointsRef().back().setValue(20.0f);
+    chartBox.redrawTail(400);
+
+    assert(!chartBox.tailPending && "No tail should be pending when the scale changed");
+    assert((chartBox.damage() & FL_DAMAGE_ALL) && "Should fall back to full redraw");
+}
+
+// redrawTail should merge pending tails
+TEST(test_Fl_ChartBox_redrawTail_merges_pending_tails) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries({{100, 5.0f}, {200, 3.0f}, {300, 7.0f}, {400, 4.0f}}));
+    chartBox.fitPane(0);
+    chartBox.rememberDrawnScale(1);
+
+    chartBox.redrawTail(400);
+    int firstLeft = chartBox.tailLeft;
+    chartBox.redrawTail(300);
+
+    assert(chartBox.tailTime == 200 && "Merged tail should start at the earliest time");
+    assert(chartBox.tailLeft < firstLeft && "Merged tail column should grow to the left");
+    assert(chartBox.tailLeft + chartBox.tailWidth == 800 && "Merged tail column should reach the right edge");
+}
+
+// With many points per pixel the tail column should start at the vertex drawTail starts
+// from, not at the point before the changed one (the old segment from there is repainted)
+TEST(test_Fl_ChartBox_redrawTail_starts_at_decimation_anchor) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    vector<TimePoint> points;
+    for (size_t n = 0; n < 100000; n++) points.push_back(TimePoint(1000 + (time_sec)n, (float)(n % 50)));
+    chartBox.addPointSeries(TimePointSeries(points));
+    chartBox.fitPane(0);
+    chartBox.rememberDrawnScale(1);
+
+    const time_sec changed = points.back().getTime();
+    chartBox.redrawTail(changed);
+    const size_t anchor = chartBox.chart.getPointsTailFrom(points, 0, points.size() - 1);
+    assert(anchor < points.size() - 2 && "The anchor should be further left than the preceding point");
+    assert(chartBox.tailPending && chartBox.tailTime == points[anchor].getTime() && "Tail should start at the anchor");
+    int left, top, width, height;
+    chartBox.chart.getTailRect(points[anchor].getTime(), 0, left, top, width, height);
+    assert(chartBox.tailLeft <= left && "Tail column should cover the anchor");
+}
+
+inline vector<TimePoint> test_Fl_ChartBox_pane_points(time_sec first, time_sec last, float value) {
+    vector<TimePoint> points;
+    for (time_sec time = first; time <= last; time += 100) points.push_back(TimePoint(time, value + (float)(time % 300)));
+    return points;
+}
+
+// Panes should be stacked by their ratios, the outer spacing going to the first and the last pane
+TEST(test_Fl_ChartBox_pane_regions) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    int top, height;
+    chartBox.getPaneRegion(0, top, height);
+    assert(top == 0 && height == 600 && "A single pane should take the whole box");
+
+    chartBox.addPointSeries(TimePointSeries(test_Fl_ChartBox_pane_points(100, 800, 5.0f)));
+    chartBox.addBarSeries(TimePointSeries(test_Fl_ChartBox_pane_points(500, 1000, 1000.0f)), 1);
+    chartBox.setPaneRatio(0, 3);
+    chartBox.getPaneRegion(0, top, height);
+    assert(top == 0 && height == 30 + 405 && "The first pane should take 3/4 of the inner height and the top spacing");
+    chartBox.getPaneRegion(1, top, height);
+    assert(top == 435 && height == 135 + 30 && "The last pane should take 1/4 of the inner height and the bottom spacing");
+
+    bool thrown = false;
+    try {
+        chartBox.setPaneRatio(1, 0);
+    } catch (exception&) {
+        thrown = true;
+    }
+    assert(thrown && "A pane ratio should be positive");
+}
+
+// Panes should share the time range (X projection) and scale their Y to their own data
+TEST(test_Fl_ChartBox_panes_share_x_not_y) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_Fl_ChartBox_pane_points(100, 800, 5.0f)));
+    chartBox.addBarSeries(TimePointSeries(test_Fl_ChartBox_pane_points(500, 1000, 1000.0f)), 1);
+
+    chartBox.fitPane(0);
+    const ChartBounds price = chartBox.chart.getBounds();
+    chartBox.fitPane(1);
+    const ChartBounds volume = chartBox.chart.getBounds();
+    assert(price.valueFirst == 100 && price.valueLast == 1000 && "The first pane should span the time of both panes");
+    assert(volume.valueFirst == 100 && volume.valueLast == 1000 && "The second pane should span the same time");
+    assert(price.viewFirst == volume.viewFirst && price.viewLast == volume.viewLast && "The panes should share the view");
+    assert(price.valueUpper < 1000.0f && volume.valueLower >= 1000.0f && "Each pane should fit its own values");
+}
+
+// A live update of one pane should damage that pane only
+TEST(test_Fl_ChartBox_redrawTail_repaints_affected_pane) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_Fl_ChartBox_pane_points(100, 800, 5.0f)));
+    chartBox.addBarSeries(TimePointSeries(test_Fl_ChartBox_pane_points(500, 1000, 1000.0f)), 1);
+    chartBox.fitPane(0);
+    chartBox.fitPane(1);
+    chartBox.rememberDrawnScale(2);
+    chartBox.clear_damage();
+
+    chartBox.barsSerieses[1][0].getPointsRef().back().setValue(1500.0f);
+    chartBox.redrawTail(1000);
+
+    assert(chartBox.damage() == FL_DAMAGE_USER2 && "Only pane damage should be set");
+    assert(!chartBox.paneDirty[0] && chartBox.paneDirty[1] && "Only the changed pane should be repainted");
+}
+
+// A pane should be fitted again only when something it shows changed
+TEST(test_Fl_ChartBox_pane_fit_cache) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_Fl_ChartBox_pane_points(100, 800, 5.0f)));
+    chartBox.addBarSeries(TimePointSeries(test_Fl_ChartBox_pane_points(500, 1000, 1000.0f)), 1);
+    assert(chartBox.fitPaneCached(0) && chartBox.fitPaneCached(1) && "The first fit should not be cached");
+    assert(!chartBox.fitPaneCached(0) && !chartBox.fitPaneCached(1) && "Unchanged panes should take their cached fit");
+
+    chartBox.barsSerieses[1][0].getPointsRef().push_back(TimePoint(1100, 2000.0f));
+    assert(!chartBox.fitPaneCached(0) && "The unchanged pane should stay cached");
+    assert(chartBox.chart.getValueLast() == 1100 && "The cached pane should follow the shared time range");
+    assert(chartBox.fitPaneCached(1) && "The changed pane should be fitted again");
+
+    chartBox.redrawPane(0);
+    assert(chartBox.fitPaneCached(0) && "A repainted pane should be fitted again");
+}
+
+// Collects the flushes of the loads, the test plays the UI thread by running them.
+// Declared before the chart box, the loaders may post until it is destroyed.
+struct test_Fl_ChartBox_Posted {
+    mutex postedMutex;
+    vector<function<void()>> posted;
+
+    Fl_ChartBox::Post getPost() {
+        return [this](function<void()> task) {
+            lock_guard<mutex> lock(postedMutex);
+            posted.push_back(task);
+        };
+    }
+
+    size_t runPosted() {
+        vector<function<void()>> pending;
+        {
+            lock_guard<mutex> lock(postedMutex);
+            pending.swap(posted);
+        }
+        for (function<void()>& task: pending) task();
+        return pending.size();
+    }
+};
+
+// A series loaded in chunks should end up in view as a whole, the draw of the empty
+// series and of each partial one should not keep the view of then
+TEST(test_Fl_ChartBox_loadPointSeriesAsync_view_covers_all_chunks) {
+    test_Fl_ChartBox_Posted posted;
+    MockFl_ChartBox chartBox(0, 0, 800, 600);
+    chartBox.setPost(posted.getPost());
+    atomic<int> step{0};
+    shared_ptr<AsyncSeriesLoad<TimePoint>> load = chartBox.loadPointSeriesAsync(
+        [&step](AsyncSeriesLoad<TimePoint>& load) {
+            for (int chunk = 0; chunk < 3; chunk++) {
+                while (step < chunk) this_thread::yield();
+                vector<TimePoint> points;
+                for (int n = 0; n < 100; n++) points.push_back(TimePoint(1000 + (chunk * 100 + n) * 60, (float)(n % 13)));
+                load.append(points);
+            }
+        }
+    );
+    chartBox.fitPane(0); // the first draw, nothing loaded yet
+
+    for (int chunk = 0; chunk < 3; chunk++) {
+        while (!posted.runPosted()) this_thread::yield();
+        chartBox.fitPane(0);
+        step = chunk + 1;
+    }
+    load->wait();
+    posted.runPosted();
+    chartBox.fitPane(0);
+
+    const vector<TimePoint>& points = chartBox.pointsSerieses[0][0].getPointsCRef();
+    assert(points.size() == 300 && "Every chunk should be loaded");
+    assert(chartBox.chart.getViewFirst() == points.front().getTime() && chartBox.chart.getViewLast() == points.back().getTime() && "The view should cover the whole loaded range");
+
+    // Once moved, the view is kept
+    const time_sec viewFirst = points[100].getTime();
+    const time_sec viewLast = points[200].getTime();
+    chartBox.chart.setViewFirst(viewFirst);
+    chartBox.chart.setViewLast(viewLast);
+    load = chartBox.loadPointSeriesAsync(
+        [](AsyncSeriesLoad<TimePoint>& load) { load.append({ TimePoint(1000, 1.0f), TimePoint(100000, 2.0f) }); }
+    );
+    load->wait();
+    posted.runPosted();
+    chartBox.fitPane(0);
+    assert(chartBox.chart.getViewFirst() == viewFirst && chartBox.chart.getViewLast() == viewLast && "A moved view should not follow the load");
+}
+
+// A recycled chart box should not pass the panes, the time axis or the recorder of its
+// previous chart to the next one, only the view is kept
+TEST(test_Fl_ChartBox_recycle_drops_panes_and_time_axis) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_Fl_ChartBox_pane_points(100, 800, 5.0f)));
+    chartBox.addBarSeries(TimePointSeries(test_Fl_ChartBox_pane_points(100, 800, 1000.0f)), 1);
+    chartBox.setPaneRatio(0, 3);
+    chartBox.setTimeAxis(make_shared<TradingTimeAxis>(100));
+    InteractionRecorder recorder;
+    chartBox.setInteractionRecorder(&recorder, 1);
+    chartBox.fitPane(0);
+    const time_sec viewFirst = chartBox.chart.getViewFirst();
+    const time_sec viewLast = chartBox.chart.getViewLast();
+
+    chartBox.recycle();
+    assert(chartBox.getPaneCount() == 0 && chartBox.pointsSerieses.empty() && chartBox.barsSerieses.empty() && "The serieses should be dropped");
+    assert(chartBox.getPaneRatio(0) == 1 && "The pane ratios should be dropped");
+    assert(!chartBox.chart.getTimeAxis() && "The time axis should be dropped");
+    assert(chartBox.getChart().getViewFirst() == viewFirst && chartBox.getChart().getViewLast() == viewLast && "The view should be kept");
+
+    chartBox.addPointSeries(TimePointSeries(test_Fl_ChartBox_pane_points(100, 800, 5.0f)));
+    chartBox.addBarSeries(TimePointSeries(test_Fl_ChartBox_pane_points(100, 800, 1000.0f)), 1);
+    int top, height;
+    chartBox.getPaneRegion(1, top, height);
+    assert(top == 300 && "The next chart should get equal panes");
+    recorder.start();
+    InteractionEvent push;
+    push.kind = INTERACTION_PUSH;
+    chartBox.handleInteraction(push);
+    assert(recorder.getEvents().empty() && "The next chart should not be recorded");
+}
+
 #endif // TEST
@@ -0,0 +1,152 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../Indicators.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+#include <memory>
+#include <cmath>
+
+using namespace std;
+
+// Deterministic random walk of minute candles
+inline vector<Candle> test_Indicators_candles(size_t count) {
+    vector<Candle> candles;
+    unsigned long long seed = 42;
+    float close = 100.0f;
+    for (size_t n = 0; n < count; n++) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const unsigned r = (unsigned)(seed >> 33);
+        const float open = close;
+        close = open + ((int)(r % 41) - 20) * 0.05f;
+        const float high = max(open, close) + (r % 7) * 0.01f;
+        const float low = min(open, close) - (r % 5) * 0.01f;
+        candles.push_back(Candle(1700000000 + (time_sec)n * 60, open, high, low, close, (float)(1 + r % 100)));
+    }
+    return candles;
+}
+
+// Feeding the candles one by one should give the same outputs as one bulk update
+inline bool test_Indicators_compare(shared_ptr<Indicator> bulk, shared_ptr<Indicator> incremental) {
+    const vector<Candle> candles = test_Indicators_candles(5000);
+    bulk->update(candles); // backlog over the default bulk threshold
+
+    incremental->setBulkThreshold(candles.size() + 1);
+    vector<Candle> growing;
+    for (const Candle& candle: candles) {
+        growing.push_back(candle);
+        incremental->update(growing);
+    }
+
+    for (size_t o = 0; o < bulk->getOutputCount(); o++) {
+        const vector<TimePoint>& a = bulk->getOutput(o).getPointsCRef();
+        const vector<TimePoint>& b = incremental->getOutput(o).getPointsCRef();
+        if (a.empty() || a.size() != b.size()) return false;
+        for (size_t n = 0; n < a.size(); n++) {
+            if (a[n].getTime() != b[n].getTime()) return false;
+            if (fabs(a[n].getValue() - b[n].getValue()) > 1e-3f) return false;
+        }
+    }
+    return true;
+}
+
+TEST(test_Indicators_sma_values) {
+    SmaIndicator sma(3);
+    sma.update(vector<TimePoint>({ {1, 1}, {2, 2}, {3, 3}, {4, 4}, {5, 8} }));
+    const vector<TimePoint>& out = sma.getOutput(0).getPointsCRef();
+    assert(out.size() == 3 && "Outputs start after the first period");
+    assert(out[0].getTime() == 3 && out[0].getValue() == 2.0f && "First average");
+    assert(out[2].getValue() == 5.0f && "Last average");
+}
+
+TEST(test_Indicators_bulk_matches_incremental) {
+    assert(test_Indicators_compare(make_shared<SmaIndicator>(20), make_shared<SmaIndicator>(20)) && "SMA");
+    assert(test_Indicators_compare(make_shared<EmaIndicator>(20), make_shared<EmaIndicator>(20)) && "EMA");
+    assert(test_Indicators_compare(make_shared<RsiIndicator>(14), make_shared<RsiIndicator>(14)) && "RSI");
+    assert(test_Indicators_compare(make_shared<BollingerIndicator>(20, 2), make_shared<BollingerIndicator>(20, 2)) && "Bollinger");
+    assert(test_Indicators_compare(make_shared<VwapIndicator>(3600), make_shared<VwapIndicator>(3600)) && "VWAP");
+}
+
+// Live update of the last candle should replace the last output, not append
+TEST(test_Indicators_last_sample_updates_in_place) {
+    vector<Candle> candles = test_Indicators_candles(50);
+    EmaIndicator ema(10);
+    ema.update(candles);
+    const size_t size = ema.getOutput(0).getPointsCRef().size();
+    const float before = ema.getOutput(0).getPointsCRef().back().getValue();
+
+    const Candle last = candles.back();
+    candles.back() = Candle(last.getTime(), last.getOpen(), last.getHigh() + 50, last.getLow(), last.getClose() + 50, last.getVolume());
+    ema.update(candles);
+    const vector<TimePoint>& out = ema.getOutput(0).getPointsCRef();
+    assert(out.size() == size && "Changed last candle should not add an output");
+    assert(fabs(out.back().getValue() - (before + 50 * 2.0f / 11)) < 1e-3f && "Last output should follow the new close");
+}
+
+// Replaced source history should be recomputed from scratch
+TEST(test_Indicators_source_replaced_recomputes) {
+    SmaIndicator sma(2);
+    sma.update(vector<TimePoint>({ {1, 1}, {2, 3}, {3, 5} }));
+    sma.update(vector<TimePoint>({ {10, 4}, {20, 6} }));
+    const vector<TimePoint>& out = sma.getOutput(0).getPointsCRef();
+    assert(out.size() == 1 && "Only the new source should be used");
+    assert(out[0].getTime() == 20 && out[0].getValue() == 5.0f && "Average of the new source");
+}
+
+// NaN samples (gaps) should be skipped, in bulk and one by one, not poison the windows
+TEST(test_Indicators_skip_nan_samples) {
+    const vector<TimePoint> gapped = { {1, 1}, {2, NAN}, {3, 2}, {4, 3}, {5, NAN}, {6, 4}, {7, 8} };
+    for (size_t bulkThreshold: { (size_t)1, (size_t)100 }) {
+        SmaIndicator sma(3);
+        sma.setBulkThreshold(bulkThreshold);
+        sma.update(gapped);
+        const vector<TimePoint>& out = sma.getOutput(0).getPointsCRef();
+        assert(out.size() == 3 && "Only the valid samples should fill the window");
+        assert(out[0].getTime() == 4 && out[0].getValue() == 2.0f && "First average over the valid samples");
+        assert(out[2].getTime() == 7 && out[2].getValue() == 5.0f && "Averages after a gap should not be NaN");
+
+        BollingerIndicator bollinger(3, 2);
+        bollinger.setBulkThreshold(bulkThreshold);
+        bollinger.update(gapped);
+        for (const TimePointSeries& output: bollinger.getOutputs())
+            assert(!output.getPointsCRef().empty() && !isnan(output.getPointsCRef().back().getValue()) && "Bands after a gap should not be NaN");
+    }
+
+    vector<Candle> candles = test_Indicators_candles(100);
+    const Candle gap = candles[50];
+    candles[50] = Candle(gap.getTime(), gap.getOpen(), gap.getHigh(), gap.getLow(), gap.getClose(), NAN);
+    VwapIndicator vwap(0);
+    vwap.update(candles);
+    const vector<TimePoint>& out = vwap.getOutput(0).getPointsCRef();
+    assert(out.size() == 99 && !isnan(out.back().getValue()) && "VWAP should skip the candle without volume");
+}
+
+TEST(test_Indicators_rsi_bounds) {
+    vector<TimePoint> rising;
+    for (int n = 0; n < 30; n++) rising.push_back(TimePoint(n, (float)n));
+    RsiIndicator rsi(14);
+    rsi.update(rising);
+    assert(!rsi.getOutput(0).getPointsCRef().empty() && "Should have outputs after the period");
+    assert(rsi.getOutput(0).getPointsCRef().back().getValue() == 100.0f && "Only gains should give 100");
+}
+
+// Indicator added to a pane should follow its source candles on each fit
+TEST(test_Fl_ChartBox_candle_indicator_follows_source) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    vector<Candle> candles = test_Indicators_candles(100);
+    chartBox.addCandleSeries(CandleSeries(candles, SymbolInterval("BTCUSDT", 60), candles.front().getTime(), candles.back().getTime()));
+    shared_ptr<SmaIndicator> sma = make_shared<SmaIndicator>(10);
+    chartBox.addCandleIndicator(sma, 1);
+
+    chartBox.fitPane(1);
+    assert(sma->getOutput(0).getPointsCRef().size() == 91 && "Indicator should be computed on fit");
+    assert(chartBox.chart.getValueLower() < chartBox.chart.getValueUpper() && "Pane should fit to the indicator");
+
+    chartBox.candlesSerieses[0][0].getCandlesRef().push_back(Candle(candles.back().getTime() + 60, 100, 101, 99, 100, 1));
+    chartBox.fitPane(1);
+    assert(sma->getOutput(0).getPointsCRef().size() == 92 && "New candle should add an output");
+}
+
+#endif // TEST
@@ -0,0 +1,158 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../InteractionRecorder.hpp"
+#include "../InteractionReplayer.hpp"
+#include <vector>
+#include <sstream>
+#include <cstdio>
+
+using namespace std;
+
+// Two synchronized headless chart boxes, e.g. the price and an indicator
+struct test_InteractionRecorder_Screen {
+    Fl_ImageChartBox price{400, 200};
+    Fl_ImageChartBox indicator{400, 100};
+    ChartGroup group;
+
+    test_InteractionRecorder_Screen() {
+        vector<TimePoint> points;
+        for (size_t n = 0; n < 2000; n++)
+            points.push_back(TimePoint(1000 + (time_sec)n * 60, (float)(n % 37) + (float)(n % 11)));
+        price.addPointSeries(TimePointSeries(points, 0x00FF00));
+        indicator.addBarSeries(TimePointSeries(points, 0xFF0000));
+        group.addChart(price.getChart());
+        group.addChart(indicator.getChart());
+        price.setChartGroup(&group);
+        indicator.setChartGroup(&group);
+        price.render();
+        indicator.render();
+    }
+
+    vector<Fl_ChartBox*> getChartBoxes() { return { &price, &indicator }; }
+    vector<Fl_ImageChartBox*> getImageChartBoxes() { return { &price, &indicator }; }
+
+    // Zoom on the price, drag the indicator, zoom out on the indicator
+    void interact() {
+        price.handleInteraction({ INTERACTION_WHEEL, 0, 0, 200, 50, 0, -1, 0 });
+        price.handleInteraction({ INTERACTION_WHEEL, 0, 0, 300, 50, 0, -1, 0 });
+        indicator.handleInteraction({ INTERACTION_PUSH, 0, 0, 250, 40, 0, 0, 1 });
+        for (int x = 240; x >= 150; x -= 10)
+            indicator.handleInteraction({ INTERACTION_DRAG, 0, 0, x, 40, 0, 0, 1 });
+        indicator.handleInteraction({ INTERACTION_WHEEL, 0, 0, 100, 40, 0, 1, 0 });
+    }
+};
+
+TEST(test_InteractionRecorder_records_and_round_trips) {
+    test_InteractionRecorder_Screen screen;
+    InteractionRecorder recorder;
+    screen.price.setInteractionRecorder(&recorder, 0);
+    screen.indicator.setInteractionRecorder(&recorder, 1);
+    screen.price.handleInteraction({ INTERACTION_WHEEL, 0, 0, 200, 50, 0, -1, 0 });
+    assert(recorder.getEvents().empty() && "Nothing should be recorded before start");
+
+    recorder.start();
+    screen.interact();
+    recorder.stop();
+    screen.price.handleInteraction({ INTERACTION_WHEEL, 0, 0, 200, 50, 0, -1, 0 });
+
+    const vector<InteractionEvent>& events = recorder.getEvents();
+    assert(events.size() == 14 && "Each event of the session should be recorded once");
+    assert(events[0].kind == INTERACTION_WHEEL && events[0].chart == 0 && events[0].dy == -1 && "Wheel events should keep their chart and delta");
+    assert(events[2].kind == INTERACTION_PUSH && events[2].chart == 1 && events[2].x == 250 && "Push events should keep their chart and position");
+    for (size_t n = 1; n < events.size(); n++)
+        assert(events[n].timeUs >= events[n - 1].timeUs && "Event times should not go back");
+
+    const string filename = "/tmp/test_InteractionRecorder_session.csv";
+    recorder.save(filename);
+    const vector<InteractionEvent> loaded = InteractionRecorder::load(filename);
+    remove(filename.c_str());
+    assert(loaded.size() == events.size() && "The session file should hold every event");
+    for (size_t n = 0; n < loaded.size(); n++) {
+        assert(loaded[n].kind == events[n].kind && loaded[n].chart == events[n].chart && "Loaded events should keep their kind and chart");
+        assert(loaded[n].x == events[n].x && loaded[n].y == events[n].y && loaded[n].dy == events[n].dy && loaded[n].button == events[n].button && "Loaded events should keep their coordinates");
+    }
+
+    stringstream invalid("kind,time_us,chart,x,y,dx,dy,button\nkey,1.0,0,1,2,0,0,0\n");
+    bool thrown = false;
+    try {
+        InteractionRecorder::read(invalid);
+    } catch (exception&) {
+        thrown = true;
+    }
+    assert(thrown && "Unknown events should be rejected");
+}
+
+// Replaying a session should end in the views of the original interaction
+TEST(test_InteractionReplayer_replays_deterministically) {
+    InteractionRecorder recorder;
+    time_sec first, last, indicatorFirst;
+    {
+        test_InteractionRecorder_Screen screen;
+        const time_sec initialFirst = screen.price.getChart().getViewFirst();
+        const time_sec initialLast = screen.price.getChart().getViewLast();
+        screen.price.setInteractionRecorder(&recorder, 0);
+        screen.indicator.setInteractionRecorder(&recorder, 1);
+        recorder.start();
+        screen.interact();
+        assert((screen.price.getChart().getViewFirst() != initialFirst || screen.price.getChart().getViewLast() != initialLast) && "The session should move the view");
+        first = screen.price.getChart().getViewFirst();
+        last = screen.price.getChart().getViewLast();
+        indicatorFirst = screen.indicator.getChart().getViewFirst();
+    }
+    stringstream session;
+    recorder.save(session);
+    const vector<InteractionEvent> events = InteractionRecorder::read(session);
+
+    for (int run = 0; run < 2; run++) {
+        test_InteractionRecorder_Screen screen;
+        InteractionReplayer replayer(
+            InteractionReplayer::applyTo(screen.getChartBoxes()),
+            InteractionReplayer::renderImages(screen.getImageChartBoxes())
+        );
+        const InteractionReport report = replayer.replay(events);
+        assert(screen.price.getChart().getViewFirst() == first && screen.price.getChart().getViewLast() == last && "Replay should end in the recorded view");
+        assert(screen.indicator.getChart().getViewFirst() == indicatorFirst && "Replay should move the synchronized charts too");
+        assert(report.events == events.size() && report.frames == events.size() && "Each event should get its frame");
+        assert(report.handling.count == events.size() && report.eventToFrame.count == events.size() && "Each event should be measured");
+        assert(report.eventToFrame.p50 >= report.handling.p50 && "A frame should not come before the handling of its event");
+    }
+
+    test_InteractionRecorder_Screen screen;
+    InteractionReplayer realtime(
+        InteractionReplayer::applyTo(screen.getChartBoxes()),
+        InteractionReplayer::renderImages(screen.getImageChartBoxes()),
+        true, 100
+    );
+    const InteractionReport report = realtime.replay(events);
+    assert(screen.price.getChart().getViewFirst() == first && "A real time replay should end in the recorded view");
+    assert(report.frames >= 1 && report.frames <= events.size() && "Events due together should share a frame");
+
+    vector<InteractionEvent> unknown = { { INTERACTION_WHEEL, 0, 2, 10, 10, 0, 1, 0 } };
+    bool thrown = false;
+    try {
+        InteractionReplayer(InteractionReplayer::applyTo(screen.getChartBoxes()), nullptr).replay(unknown);
+    } catch (exception&) {
+        thrown = true;
+    }
+    assert(thrown && "Events of a missing chart box should be rejected");
+}
+
+TEST(test_InteractionLatency_percentiles) {
+    vector<double> durations;
+    for (int n = 100; n >= 1; n--) durations.push_back(n);
+    const InteractionLatency latency = InteractionLatency::of(durations);
+    assert(latency.count == 100 && "Count should be the number of durations");
+    assert(latency.p50 == 50 && latency.p99 == 99 && latency.max == 100 && "Percentiles should be nearest ranks");
+    assert(latency.mean == 50.5 && "Mean should be the average");
+    assert(InteractionLatency::of({}).p99 == 0 && "No duration should give zeros");
+
+    InteractionReport report;
+    report.name = "session";
+    report.handling = latency;
+    assert(report.toJson().find("\"handling\":{\"count\":100,\"p50_us\":50,\"p99_us\":99") != string::npos && "Report should be a JSON line");
+}
+
+#endif // TEST
@@ -0,0 +1,106 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../LazyIndicatorSeries.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+#include <memory>
+#include <cmath>
+
+using namespace std;
+
+inline vector<TimePoint> test_LazyIndicatorSeries_points(size_t count) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++)
+        points.push_back(TimePoint(1000 + (time_sec)n * 10, (float)(n % 37) + (float)(n % 11) * 0.5f));
+    return points;
+}
+
+inline shared_ptr<LazyIndicatorSeries<TimePoint>> test_LazyIndicatorSeries_create(
+    const vector<TimePoint>& points, size_t cacheBytes = 16 << 20
+) {
+    return make_shared<LazyIndicatorSeries<TimePoint>>(
+        [&points]() -> const vector<TimePoint>& { return points; },
+        []() { return make_shared<SmaIndicator>(20); },
+        19, 0, 100, cacheBytes
+    );
+}
+
+// Nothing should be computed before the series is viewed
+TEST(test_LazyIndicatorSeries_nothing_computed_until_viewed) {
+    vector<TimePoint> points = test_LazyIndicatorSeries_points(100000);
+    shared_ptr<LazyIndicatorSeries<TimePoint>> series = test_LazyIndicatorSeries_create(points);
+    assert(!series->empty() && series->getLastTime() == points.back().getTime() && "Time range from the source");
+    assert(series->getComputedBlockCount() == 0 && "No block should be computed");
+}
+
+// Viewed blocks should match the full computation (warmup covers the SMA period)
+TEST(test_LazyIndicatorSeries_window_matches_full_computation) {
+    vector<TimePoint> points = test_LazyIndicatorSeries_points(10000);
+    shared_ptr<LazyIndicatorSeries<TimePoint>> series = test_LazyIndicatorSeries_create(points);
+    SmaIndicator full(20);
+    full.update(points);
+    const vector<TimePoint>& expected = full.getOutput(0).getPointsCRef();
+
+    vector<TimePoint> lazy;
+    series->getPoints(points[5050].getTime(), points[5199].getTime(), lazy);
+    assert(series->getComputedBlockCount() == 2 && "Only blocks 50 and 51 should be computed");
+    assert(lazy.size() == 200 && lazy.front().getTime() == points[5000].getTime() && "Whole blocks should be returned");
+    for (const TimePoint& point: lazy) {
+        const TimePoint& other = expected[point.getTime() / 10 - 100 - 19];
+        assert(other.getTime() == point.getTime() && fabs(other.getValue() - point.getValue()) < 1e-4f && "Same as the full SMA");
+    }
+
+    // Scroll a bit to the right: only the new block is computed
+    series->getPoints(points[5150].getTime(), points[5250].getTime(), lazy);
+    assert(series->getComputedBlockCount() == 3 && "Memoized blocks should be reused");
+}
+
+// Under the memory budget blocks are evicted but their summaries stay
+TEST(test_LazyIndicatorSeries_evicts_and_keeps_summaries) {
+    vector<TimePoint> points = test_LazyIndicatorSeries_points(10000);
+    shared_ptr<LazyIndicatorSeries<TimePoint>> series = test_LazyIndicatorSeries_create(points, 300 * sizeof(TimePoint));
+
+    vector<SeriesBlockSummary> summaries;
+    series->getSummaries(points.front().getTime(), points.back().getTime(), summaries);
+    assert(summaries.size() == 100 && "A summary per block");
+    assert(series->getComputedBlockCount() == 100 && "Every block computed once");
+    assert(series->getCachedBytes() <= 300 * sizeof(TimePoint) && "Cache should stay within the budget");
+
+    series->getSummaries(points.front().getTime(), points.back().getTime(), summaries);
+    assert(series->getComputedBlockCount() == 100 && "Summaries should not be computed again");
+}
+
+// The incomplete last block should be computed again when the source grows
+TEST(test_LazyIndicatorSeries_last_block_follows_source) {
+    vector<TimePoint> points = test_LazyIndicatorSeries_points(150);
+    shared_ptr<LazyIndicatorSeries<TimePoint>> series = test_LazyIndicatorSeries_create(points);
+    vector<TimePoint> lazy;
+    series->getPoints(points.front().getTime(), points.back().getTime(), lazy);
+    assert(lazy.size() == 131 && "Outputs after the first period");
+
+    points.push_back(TimePoint(points.back().getTime() + 10, 1.0f));
+    series->getPoints(points.front().getTime(), points.back().getTime(), lazy);
+    assert(lazy.size() == 132 && lazy.back().getTime() == points.back().getTime() && "New sample should be computed");
+    assert(series->getComputedBlockCount() == 3 && "Only the last block should be computed again");
+}
+
+// Lazy indicator in a chart box should compute only the blocks in the view
+TEST(test_Fl_ChartBox_lazy_indicator_computes_view_only) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_LazyIndicatorSeries_points(100000)));
+    shared_ptr<LazyIndicatorSeries<TimePoint>> series = chartBox.addLazyPointIndicator(
+        []() { return make_shared<EmaIndicator>(50); }, 200
+    );
+    assert(series->getComputedBlockCount() == 0 && "Attaching should cost nothing");
+
+    chartBox.chart.setViewFirst(1000 + 50000 * 10);
+    chartBox.chart.setViewLast(1000 + 51000 * 10);
+    chartBox.fitPane(0);
+    assert(series->getComputedBlockCount() == 1 && "Only the block of the view should be computed");
+    assert(!chartBox.windowedFrames[0][0].points.empty() && "View should be drawn from the points");
+}
+
+#endif // TEST
@@ -0,0 +1,140 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../PagedPointSeries.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+#include <string>
+#include <cstdio>
+
+using namespace std;
+
+// Writes hourly points over the given days to a temporary paged file (daily chunks)
+// and removes it when going out of scope
+struct test_PagedPointSeries_TempFile {
+    string filename;
+
+    test_PagedPointSeries_TempFile(const string& name, int days): filename("/tmp/" + name) {
+        PagedPointSeriesWriter writer(filename, 86400);
+        for (int hour = 0; hour < days * 24; hour++)
+            writer.append(TimePoint(hour * 3600, (float)(hour % 24)));
+        writer.finish();
+    }
+
+    ~test_PagedPointSeries_TempFile() {
+        remove(filename.c_str());
+    }
+};
+
+// Index should be read without loading any chunk
+TEST(test_PagedPointSeries_index_and_summaries) {
+    test_PagedPointSeries_TempFile file("test_PagedPointSeries_index.pps", 10);
+    PagedPointSeries series(file.filename);
+
+    assert(series.getChunkCount() == 10 && "Should have a chunk per day");
+    assert(series.getFirstTime() == 0 && series.getLastTime() == (10 * 24 - 1) * 3600 && "Time range from the index");
+
+    vector<SeriesBlockSummary> summaries;
+    series.getSummaries(86400 * 2, 86400 * 4 - 1, summaries);
+    assert(summaries.size() == 2 && "Days 2 and 3 overlap the window");
+    assert(summaries[0].count == 24 && summaries[0].minValue == 0.0f && summaries[0].maxValue == 23.0f && "Summary of a day");
+    assert(series.getChunkLoadCount() == 0 && series.getCachedBytes() == 0 && "Summaries should not load chunks");
+}
+
+// Points of the view should be loaded with the margin chunks prefetched
+TEST(test_PagedPointSeries_getPoints_loads_view_and_margin) {
+    test_PagedPointSeries_TempFile file("test_PagedPointSeries_points.pps", 10);
+    PagedPointSeries series(file.filename, CHART_COLOR_PLOTTER, 1 << 20, 1);
+
+    vector<TimePoint> points;
+    series.getPoints(86400 * 5, 86400 * 5 + 3600, points);
+    assert(points.size() == 24 && "Should return the whole overlapping chunk");
+    assert(points[0].getTime() == 86400 * 5 && points[23].getValue() == 23.0f && "Points should be read back");
+    assert(series.getCachedChunkCount() == 3 && series.getChunkLoadCount() == 3 && "View chunk plus a margin chunk on both sides");
+
+    series.getPoints(86400 * 4, 86400 * 4 + 3600, points);
+    assert(points.size() == 24 && points[0].getTime() == 86400 * 4 && "Scrolled view");
+    assert(series.getChunkLoadCount() == 4 && "Only the new margin chunk should be loaded");
+}
+
+// Cache should stay within the memory budget, least recently used chunks evicted
+TEST(test_PagedPointSeries_cache_budget_evicts_lru) {
+    test_PagedPointSeries_TempFile file("test_PagedPointSeries_lru.pps", 10);
+    const size_t chunkBytes = 24 * sizeof(PagedPointRecord);
+    PagedPointSeries series(file.filename, CHART_COLOR_PLOTTER, chunkBytes * 2, 0);
+
+    vector<TimePoint> points;
+    for (int day = 0; day < 10; day++) {
+        series.getPoints(86400 * day, 86400 * day, points);
+        assert(points.size() == 24 && "Each day should be loaded");
+        assert(series.getCachedBytes() <= series.getCacheBytes() && "Cache should stay within the budget");
+    }
+    assert(series.getCachedChunkCount() == 2 && "Two chunks fit into the budget");
+
+    const size_t loads = series.getChunkLoadCount();
+    series.getPoints(86400 * 9, 86400 * 9, points);
+    assert(series.getChunkLoadCount() == loads && "Recent chunk should come from the cache");
+    series.getPoints(0, 0, points);
+    assert(series.getChunkLoadCount() == loads + 1 && "Evicted chunk should be loaded again");
+}
+
+// Writer should reject out of order points and reader should reject foreign files
+TEST(test_PagedPointSeries_errors) {
+    const string filename = "/tmp/test_PagedPointSeries_errors.pps";
+    bool thrown = false;
+    {
+        PagedPointSeriesWriter writer(filename);
+        writer.append(TimePoint(100, 1.0f));
+        try {
+            writer.append(TimePoint(50, 1.0f));
+        } catch (...) {
+            thrown = true;
+        }
+    }
+    assert(thrown && "Appending an older point should throw");
+
+    thrown = false;
+    try {
+        PagedPointSeries series(filename); // unfinished, no footer
+    } catch (...) {
+        thrown = true;
+    }
+    assert(thrown && "File without index should throw");
+    remove(filename.c_str());
+}
+
+// A chunk that can not be read should not be cached, the next access should fail again
+TEST(test_PagedPointSeries_failed_read_is_not_cached) {
+    test_PagedPointSeries_TempFile file("test_PagedPointSeries_failed.pps", 10);
+    PagedPointSeries series(file.filename, CHART_COLOR_PLOTTER, 1 << 20, 0);
+    const int truncated = truncate(file.filename.c_str(), 0);
+    assert(truncated == 0 && "The file should be truncated under the series");
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool thrown = false;
+        vector<TimePoint> points;
+        try {
+            series.getPoints(86400 * 5, 86400 * 5, points);
+        } catch (...) {
+            thrown = true;
+        }
+        assert(thrown && "Reading a missing chunk should throw");
+        assert(series.getCachedChunkCount() == 0 && series.getCachedBytes() == 0 && "A failed read should leave nothing in the cache");
+    }
+}
+
+// Fl_ChartBox should draw a zoomed out paged series from the index alone
+TEST(test_Fl_ChartBox_paged_series_zoomed_out) {
+    test_PagedPointSeries_TempFile file("test_PagedPointSeries_chartbox.pps", 3000);
+    shared_ptr<PagedPointSeries> series = make_shared<PagedPointSeries>(file.filename);
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addWindowedSeries(series);
+
+    chartBox.fitPane(0);
+    assert(chartBox.windowedFrames[0][0].summaryLevel && "Full view should use the summaries");
+    assert(series->getChunkLoadCount() == 0 && "No chunk should be loaded when zoomed out");
+}
+
+#endif // TEST
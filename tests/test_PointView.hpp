@@ -0,0 +1,151 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../PointView.hpp"
+#include "../PointSeriesAdapter.hpp"
+#include "../ImageCanvas.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+
+using namespace std;
+
+struct test_PointView_Trade {
+    time_sec time;
+    float price;
+};
+
+inline vector<Candle> test_PointView_candles(size_t count) {
+    vector<Candle> candles;
+    for (size_t n = 0; n < count; n++) {
+        const float close = 100.0f + (float)(n % 17) - (float)(n % 5);
+        candles.push_back(Candle(1000 + (time_sec)n * 60, close - 1.0f, close + 2.0f, close - 3.0f, close, (float)(n % 9) * 10.0f));
+    }
+    return candles;
+}
+
+inline vector<TimePoint> test_PointView_closes(const vector<Candle>& candles) {
+    vector<TimePoint> points;
+    for (const Candle& candle: candles) points.push_back(TimePoint(candle.getTime(), candle.getClose()));
+    return points;
+}
+
+// A candle field view should give the time and the selected field of each candle
+TEST(test_PointView_candle_fields) {
+    vector<Candle> candles = { Candle(100, 1.0f, 4.0f, 0.5f, 2.0f, 50.0f), Candle(200, 2.0f, 3.0f, 1.0f, 2.5f, 70.0f) };
+    assert(viewCandleField(candles, CANDLE_FIELD_OPEN)[1].getValue() == 2.0f && "Open expected");
+    assert(viewCandleField(candles, CANDLE_FIELD_HIGH)[0].getValue() == 4.0f && "High expected");
+    assert(viewCandleField(candles, CANDLE_FIELD_LOW)[0].getValue() == 0.5f && "Low expected");
+    assert(viewCandleField(candles, CANDLE_FIELD_CLOSE)[1].getValue() == 2.5f && "Close expected");
+    assert(viewCandleField(candles, CANDLE_FIELD_VOLUME)[1].getValue() == 70.0f && "Volume expected");
+    assert(viewCandleField(candles, CANDLE_FIELD_CLOSE)[1].getTime() == 200 && "Candle time expected");
+
+    // The view follows the candles as they grow
+    CandleFieldView view = viewCandleField(candles, CANDLE_FIELD_CLOSE);
+    candles.push_back(Candle(300, 2.5f, 2.5f, 2.5f, 3.0f, 0.0f));
+    assert(view.size() == 3 && view[2].getValue() == 3.0f && "View should see the appended candle");
+}
+
+// A view of user structs should draw exactly like the copied points
+TEST(test_PointView_draws_like_points) {
+    vector<test_PointView_Trade> trades;
+    vector<TimePoint> points;
+    for (size_t n = 0; n < 5000; n++) {
+        trades.push_back({ 1000 + (time_sec)n * 3, (float)(n % 23) });
+        points.push_back(TimePoint(trades.back().time, trades.back().price));
+    }
+    auto view = makePointView(
+        trades,
+        [](const test_PointView_Trade& trade) { return trade.time; },
+        [](const test_PointView_Trade& trade) { return trade.price; }
+    );
+
+    ImageCanvas copied(400, 200), viewed(400, 200);
+    Chart copiedChart(copied), viewedChart(viewed);
+    copiedChart.fitToPoints(points);
+    viewedChart.fitToPoints(view);
+    copiedChart.resetView();
+    viewedChart.resetView();
+    copiedChart.zoomAt(3.0, 200);
+    viewedChart.zoomAt(3.0, 200);
+    copiedChart.fitToVisiblePoints(points);
+    viewedChart.fitToVisiblePoints(view);
+    assert(copiedChart.getBounds().valueLower == viewedChart.getBounds().valueLower && "Same Y fit expected");
+    assert(copiedChart.getBounds().valueUpper == viewedChart.getBounds().valueUpper && "Same Y fit expected");
+
+    size_t copiedFrom, copiedTo, viewedFrom, viewedTo;
+    copiedChart.getVisibleRange(points, copiedFrom, copiedTo);
+    viewedChart.getVisibleRange(view, viewedFrom, viewedTo);
+    assert(copiedFrom == viewedFrom && copiedTo == viewedTo && "Same visible range expected");
+
+    copiedChart.showPointsRange(points, copiedFrom, copiedTo, 0xFFFFFF);
+    viewedChart.showPointsRange(view, viewedFrom, viewedTo, 0xFFFFFF);
+    copiedChart.showBarsRange(points, copiedFrom, copiedTo, 0x00FF00);
+    viewedChart.showBarsRange(view, viewedFrom, viewedTo, 0x00FF00);
+    assert(copied.countPixels(0xFFFFFF) > 0 && "Lines should be drawn");
+    assert(copied.getPixels() == viewed.getPixels() && "The view should draw the same pixels");
+}
+
+// A candle field series of a chart box should read the candles of the chart box, without copying them
+TEST(test_PointView_chart_box_candle_field_series) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addCandleSeries(CandleSeries(test_PointView_candles(1000), SymbolInterval("TEST", 60), 0, 0));
+    shared_ptr<CandleFieldSeries> volumes = chartBox.addCandleFieldSeries(CANDLE_FIELD_VOLUME, 1, 0, 0, CHART_COLOR_PLOTTER, true);
+
+    assert(chartBox.getPaneCount() == 2 && "The volumes should be in their own pane");
+    assert(volumes->isBars() && volumes->size() == 1000 && "The volume bars should see all the candles");
+    assert(chartBox.barsSerieses.empty() && chartBox.pointsSerieses.empty() && "No points should be copied");
+
+    chartBox.fitPane(1);
+    assert(chartBox.chart.getValueLower() == 0.0f && chartBox.chart.getValueUpper() == 80.0f && "The pane should fit to the volumes");
+    assert(chartBox.chart.getValueFirst() == 1000 && chartBox.chart.getValueLast() == 1000 + 999 * 60 && "The pane should fit to the candle times");
+
+    // The series follows the candles of the chart box as they grow
+    chartBox.candlesSerieses[0][0].getCandlesRef().push_back(Candle(1000 + 1000 * 60, 1, 1, 1, 1, 500.0f));
+    assert(volumes->size() == 1001 && "The appended candle should be seen");
+    assert(volumes->getTailTime(chartBox.chart, 1000 + 1000 * 60) < 1000 + 1000 * 60 && "The tail should start at a vertex before the changed candle");
+}
+
+// A copy of the chart box (e.g. the renderer of Fl_AsyncChartBox) should read its own candles
+TEST(test_PointView_copied_candle_field_series_reads_the_copy) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addCandleSeries(CandleSeries(test_PointView_candles(1000), SymbolInterval("TEST", 60), 0, 0));
+    shared_ptr<CandleFieldSeries> volumes = chartBox.addCandleFieldSeries(CANDLE_FIELD_VOLUME, 1, 0, 0, CHART_COLOR_PLOTTER, true);
+
+    MockFl_ChartBox copy(10, 10, 800, 600);
+    copy.copySerieses(chartBox);
+    assert(copy.adaptedSerieses.size() == 2 && copy.adaptedSerieses[1].size() == 1 && "The copy should have the series in the same pane");
+    assert(copy.adaptedSerieses[1][0] != volumes && copy.adaptedSerieses[1][0]->isBars() && "The copy should get its own series");
+
+    chartBox.candlesSerieses[0][0].getCandlesRef().push_back(Candle(1000 + 1000 * 60, 1, 1, 1, 1, 500.0f));
+    assert(volumes->size() == 1001 && copy.adaptedSerieses[1][0]->size() == 1000 && "The copy should not see the candles of the original");
+    copy.copySerieses(chartBox);
+    assert(copy.adaptedSerieses[1][0]->size() == 1001 && "The next copy should take the new candles");
+
+    chartBox.clearAdaptedSerieses();
+    copy.copySerieses(chartBox);
+    assert(copy.adaptedSerieses.empty() && "Cleared serieses should not come back on a copy");
+}
+
+// A close line series should keep the candles' memory only, and fit like the copied closes
+TEST(test_PointView_close_series_fits_like_points) {
+    const vector<Candle> candles = test_PointView_candles(500);
+    const vector<TimePoint> closes = test_PointView_closes(candles);
+    shared_ptr<CandleFieldSeries> series = makeCandleFieldSeries(
+        [&candles]() -> const vector<Candle>& { return candles; }, CANDLE_FIELD_CLOSE
+    );
+    ImageCanvas canvas(400, 200);
+    Chart copiedChart(canvas), viewedChart(canvas);
+    copiedChart.fitToPoints(closes);
+    series->fit(viewedChart);
+    copiedChart.resetView();
+    viewedChart.resetView();
+    copiedChart.fitToVisiblePoints(closes);
+    float lower, upper;
+    assert(series->getVisibleValueRange(viewedChart, lower, upper) && "Visible values expected");
+    assert(lower == copiedChart.getValueLower() && upper == copiedChart.getValueUpper() && "Same value range expected");
+    assert(viewedChart.getValueFirst() == copiedChart.getValueFirst() && viewedChart.getValueLast() == copiedChart.getValueLast() && "Same time range expected");
+}
+
+#endif // TEST
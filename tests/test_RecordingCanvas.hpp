@@ -0,0 +1,131 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../RecordingCanvas.hpp"
+#include "../Chart.hpp"
+#include "MockCanvas.hpp"
+#include <vector>
+
+using namespace std;
+
+inline vector<TimePoint> test_RecordingCanvas_points(size_t count) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++)
+        points.push_back(TimePoint(1000 + (time_sec)n * 10, (float)(n % 31) + (float)(n % 7)));
+    return points;
+}
+
+inline vector<Candle> test_RecordingCanvas_candles(size_t count) {
+    vector<Candle> candles;
+    for (size_t n = 0; n < count; n++) {
+        float open = (float)(n % 13) + 10.0f;
+        float close = (float)(n % 7) + 10.0f;
+        candles.push_back(Candle(1000 + (time_sec)n * 60, open, max(open, close) + 1.0f, min(open, close) - 1.0f, close, 0.0f));
+    }
+    return candles;
+}
+
+// Calls should be counted by primitive and color, and forwarded to the target
+TEST(test_RecordingCanvas_counts_by_primitive_and_color) {
+    MockCanvas mock;
+    RecordingCanvas target(mock);
+    RecordingCanvas canvas(static_cast<Canvas&>(target));
+    canvas.line(0, 0, 10, 10, 0xff0000);
+    canvas.line(0, 0, 10, 0, 0x00ff00);
+    canvas.rectf(0, 0, 5, 5, 0xff0000);
+    canvas.clear();
+
+    assert(canvas.getCount(CANVAS_LINE) == 2 && "Lines should be counted");
+    assert(canvas.getCount(CANVAS_LINE, 0xff0000) == 1 && "Lines should be counted by color");
+    assert(canvas.getColorCount(0xff0000) == 2 && "Any primitive of a color should be counted");
+    assert(canvas.getPrimitives() == 3 && "Clear should not be a drawing call");
+    assert(canvas.getCount(CANVAS_CLEAR) == 1 && "Clear should be counted on its own");
+    assert(target.getPrimitives() == 3 && target.getCount(CANVAS_CLEAR) == 1 && "Calls should reach the target");
+    assert(canvas.width() == mock.width() && canvas.height() == mock.height() && "Size should be the target's");
+    assert(canvas.getCommands().empty() && "Nothing should be recorded by default");
+
+    canvas.reset();
+    assert(canvas.getPrimitives() == 0 && canvas.getCount(CANVAS_LINE, 0xff0000) == 0 && "Reset should clear the counts");
+}
+
+// Recording should keep the command stream in order with the arguments
+TEST(test_RecordingCanvas_records_command_stream) {
+    MockCanvas mock;
+    RecordingCanvas canvas(mock, true);
+    canvas.line(1, 2, 3, 4, 0x123456, 1);
+    canvas.circle(5, 6, 7, 0x654321);
+    canvas.text(8, 9, "abc", 0x111111);
+
+    const vector<CanvasCommand>& commands = canvas.getCommands();
+    assert(commands.size() == 3 && "Each call should be recorded");
+    assert(commands[0].primitive == CANVAS_LINE && commands[0].left2 == 3 && commands[0].top2 == 4 && "Line arguments should be kept");
+    assert(commands[0].color == 0x123456 && commands[0].style == 1 && "Line color and style should be kept");
+    assert(commands[1].primitive == CANVAS_CIRCLE && commands[1].radius == 7 && "Circle radius should be kept");
+    assert(commands[2].primitive == CANVAS_TEXT && commands[2].text == "abc" && "Text should be kept");
+}
+
+// Overlapping primitives should be reported as overdraw
+TEST(test_RecordingCanvas_estimates_overdraw) {
+    MockCanvas mock;
+    RecordingCanvas canvas(mock, false, true);
+    canvas.rectf(0, 0, 10, 10, 0);
+    assert(canvas.getPixelsTouched() == 100 && canvas.getPixelsCovered() == 100 && "Filled rect should touch its area");
+    assert(canvas.getOverdraw() == 1.0 && "Single rect should not overdraw");
+
+    canvas.rectf(5, 0, 10, 10, 0);
+    assert(canvas.getPixelsTouched() == 200 && canvas.getPixelsCovered() == 150 && "Overlap should be covered once");
+
+    canvas.line(0, 20, 9, 20, 0);
+    canvas.line(0, 20, 9, 20, 0);
+    assert(canvas.getPixelsTouched() == 220 && canvas.getPixelsCovered() == 160 && "Same line twice should overdraw");
+
+    canvas.rectf(-5, -5, 10, 10, 0);
+    assert(canvas.getPixelsTouched() == 245 && "Pixels out of the canvas should be clipped");
+}
+
+// LOD of showPoints: dense points should draw at most about one line per pixel
+TEST(test_RecordingCanvas_showPoints_lines_bounded_by_width) {
+    MockCanvas mock;
+    RecordingCanvas canvas(mock);
+    Chart chart(canvas);
+    vector<TimePoint> points = test_RecordingCanvas_points(100000);
+    chart.fitToPoints(points);
+    chart.resetView();
+
+    chart.showPoints(points);
+    assert(canvas.getCount(CANVAS_LINE) > 0 && "Points should be drawn");
+    assert(canvas.getPrimitivesPerPixel() <= 1.0 && "At most one line per pixel of width");
+}
+
+// LOD of showCandles: zoomed out candles should be merged, not drawn one by one
+TEST(test_RecordingCanvas_showCandles_primitives_bounded_by_width) {
+    MockCanvas mock;
+    RecordingCanvas canvas(mock);
+    Chart chart(canvas);
+    vector<Candle> candles = test_RecordingCanvas_candles(100000);
+    chart.fitToCandles(candles);
+    chart.resetView();
+
+    chart.showCandles(candles, 60);
+    assert(canvas.getPrimitives() > 0 && "Candles should be drawn");
+    assert(canvas.getCount(CANVAS_RECTF) == 0 && "Zoomed out candles should have no bodies");
+    assert(canvas.getPrimitivesPerPixel() <= 2.0 && "At most two primitives per pixel of width");
+}
+
+// LOD of showBars: dense bars should draw at most about one bar per pixel
+TEST(test_RecordingCanvas_showBars_primitives_bounded_by_width) {
+    MockCanvas mock;
+    RecordingCanvas canvas(mock);
+    Chart chart(canvas);
+    vector<TimePoint> points = test_RecordingCanvas_points(100000);
+    chart.fitToPoints(points);
+    chart.resetView();
+
+    chart.showBars(points);
+    assert(canvas.getPrimitives() > 0 && "Bars should be drawn");
+    assert(canvas.getPrimitivesPerPixel() <= 1.0 && "At most one bar per pixel of width");
+}
+
+#endif // TEST
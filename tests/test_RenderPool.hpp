@@ -0,0 +1,200 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../RenderPool.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+
+using namespace std;
+
+inline vector<TimePoint> test_RenderPool_points(size_t count) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++)
+        points.push_back(TimePoint(1000 + (time_sec)n * 60, (float)(n % 17) + 1.0f));
+    return points;
+}
+
+inline bool test_RenderPool_sameBounds(const ChartBounds& a, const ChartBounds& b) {
+    return 
+        a.valueFirst == b.valueFirst && a.valueLast == b.valueLast &&
+        a.valueLower == b.valueLower && a.valueUpper == b.valueUpper &&
+        a.viewInitialized == b.viewInitialized &&
+        a.viewFirst == b.viewFirst && a.viewLast == b.viewLast;
+}
+
+// Every submitted job should run exactly once
+TEST(test_RenderPool_runs_all_jobs) {
+    RenderPool pool(3);
+    assert(pool.getThreadCount() == 3 && "Pool should have the requested threads");
+    atomic<int> runs{0};
+    vector<shared_ptr<RenderJob>> jobs;
+    for (int n = 0; n < 100; n++)
+        jobs.push_back(pool.submit([&runs](const RenderJob&) { runs++; }, (RenderPriority)(n % RENDER_PRIORITY_COUNT)));
+    pool.waitAll(jobs);
+    assert(runs == 100 && "All jobs should run once");
+    for (const shared_ptr<RenderJob>& job: jobs)
+        assert(job->isStarted() && job->isDone() && "All jobs should be done");
+}
+
+// A worker should take the focused job before the visible and the background ones
+TEST(test_RenderPool_runs_higher_priority_first) {
+    RenderPool pool(1);
+    mutex gate;
+    gate.lock();
+    atomic<bool> blocked{false};
+    shared_ptr<RenderJob> blocker = pool.submit([&](const RenderJob&) {
+        blocked = true;
+        lock_guard<mutex> lock(gate);
+    });
+    while (!blocked) this_thread::yield();
+
+    mutex orderMutex;
+    vector<int> order;
+    vector<shared_ptr<RenderJob>> jobs;
+    const RenderPriority priorities[] = {
+        RENDER_PRIORITY_BACKGROUND, RENDER_PRIORITY_VISIBLE, RENDER_PRIORITY_FOCUSED
+    };
+    for (RenderPriority priority: priorities)
+        jobs.push_back(pool.submit([&, priority](const RenderJob&) {
+            lock_guard<mutex> lock(orderMutex);
+            order.push_back(priority);
+        }, priority));
+    gate.unlock();
+    pool.wait(blocker);
+    for (const shared_ptr<RenderJob>& job: jobs) job->waitDone();
+
+    assert(order.size() == 3 && "All jobs should run");
+    assert(order[0] == RENDER_PRIORITY_FOCUSED && "Focused job should run first");
+    assert(order[1] == RENDER_PRIORITY_VISIBLE && "Visible job should run second");
+    assert(order[2] == RENDER_PRIORITY_BACKGROUND && "Background job should run last");
+}
+
+// A job cancelled before it started should be skipped, a running one should see the cancellation
+TEST(test_RenderPool_cancel) {
+    RenderPool pool(1);
+    mutex gate;
+    gate.lock();
+    atomic<bool> started{false};
+    atomic<bool> sawCancel{false};
+    shared_ptr<RenderJob> running = pool.submit([&](const RenderJob& job) {
+        started = true;
+        lock_guard<mutex> lock(gate);
+        sawCancel = job.isCancelled();
+    });
+    while (!started) this_thread::yield();
+
+    atomic<bool> skippedRan{false};
+    shared_ptr<RenderJob> skipped = pool.submit([&](const RenderJob&) { skippedRan = true; });
+    skipped->cancel();
+    running->cancel();
+    gate.unlock();
+    pool.wait(running);
+    pool.wait(skipped);
+
+    assert(sawCancel && "Running job should see its cancellation");
+    assert(!skippedRan && skipped->isDone() && "Cancelled job should be skipped but done");
+}
+
+// wait() should run a job no worker started yet on the waiting thread
+TEST(test_RenderPool_wait_helps) {
+    RenderPool pool(1);
+    mutex gate;
+    gate.lock();
+    atomic<bool> blocked{false};
+    shared_ptr<RenderJob> blocker = pool.submit([&](const RenderJob&) {
+        blocked = true;
+        lock_guard<mutex> lock(gate);
+    });
+    while (!blocked) this_thread::yield();
+
+    thread::id ranOn;
+    shared_ptr<RenderJob> job = pool.submit([&ranOn](const RenderJob&) { ranOn = this_thread::get_id(); });
+    pool.wait(job);
+    assert(ranOn == this_thread::get_id() && "Waiting thread should run the job itself");
+    gate.unlock();
+    pool.wait(blocker);
+}
+
+// The exception of a job should be rethrown by wait()
+TEST(test_RenderPool_wait_rethrows) {
+    RenderPool pool(2);
+    shared_ptr<RenderJob> job = pool.submit([](const RenderJob&) { throw runtime_error("prepare failed"); });
+    bool thrown = false;
+    try {
+        pool.wait(job);
+    } catch (const runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && "Error of the job should reach the waiter");
+}
+
+// Preparing should give the bounds of the serial fit, per pane
+TEST(test_RenderPool_prepare_matches_serial_fit) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_RenderPool_points(1000)));
+    chartBox.addBarSeries(TimePointSeries(test_RenderPool_points(500)), 1);
+
+    vector<ChartBounds> serial;
+    for (size_t pane = 0; pane < 2; pane++) {
+        chartBox.fitPane(pane);
+        serial.push_back(chartBox.chart.getBounds());
+    }
+
+    assert(!chartBox.isPrepared() && "Nothing should be prepared yet");
+    assert(chartBox.prepare() && "Prepare without a job should complete");
+    assert(chartBox.isPrepared() && "Fit should be prepared");
+    assert(chartBox.preparedBounds.size() == 2 && "Each pane should be prepared");
+    for (size_t pane = 0; pane < 2; pane++)
+        assert(test_RenderPool_sameBounds(chartBox.preparedBounds[pane], serial[pane]) && "Prepared bounds should match the serial fit");
+
+    chartBox.addPointSeries(TimePointSeries(test_RenderPool_points(10)));
+    assert(!chartBox.isPrepared() && "New series should invalidate the prepared fit");
+
+    chartBox.prepare();
+    chartBox.chart.setViewFirst(chartBox.chart.getViewFirst() + 60);
+    assert(!chartBox.isPrepared() && "View change should invalidate the prepared fit");
+}
+
+// Preparing on the pool should give the same fit, and a new job should cancel the previous one
+TEST(test_RenderPool_prepareAsync) {
+    RenderPool pool(2);
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries(test_RenderPool_points(5000)));
+    chartBox.fitPane(0);
+    ChartBounds serial = chartBox.chart.getBounds();
+
+    shared_ptr<RenderJob> first = chartBox.prepareAsync(pool, RENDER_PRIORITY_FOCUSED);
+    shared_ptr<RenderJob> second = chartBox.prepareAsync(pool, RENDER_PRIORITY_FOCUSED);
+    assert(first->isDone() && first->isCancelled() && "Previous job should be cancelled and settled");
+    chartBox.waitPrepared();
+    assert(second->isDone() && "Job should be done after waiting");
+    assert(chartBox.isPrepared() && "Fit should be prepared");
+    assert(test_RenderPool_sameBounds(chartBox.preparedBounds[0], serial) && "Pool fit should match the serial fit");
+}
+
+// Preparing should decimate into the cache, so the draw with the prepared fit only looks the vertices up
+TEST(test_RenderPool_prepare_decimates) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    shared_ptr<DecimationCache> cache = make_shared<DecimationCache>();
+    chartBox.chart.setDecimationCache(cache);
+    chartBox.addPointSeries(TimePointSeries(test_RenderPool_points(5000)));
+    chartBox.addBarSeries(TimePointSeries(test_RenderPool_points(5000)), 1);
+
+    assert(chartBox.prepare() && "Prepare should complete");
+    assert(cache->size() == 2 && "Prepare should decimate each series into the cache");
+    const size_t misses = cache->getMisses();
+    for (size_t pane = 0; pane < 2; pane++) {
+        chartBox.chart.setBounds(chartBox.preparedBounds[pane]);
+        chartBox.drawPane(pane);
+    }
+    assert(cache->getMisses() == misses && "Draw with the prepared fit should hit the cache only");
+    assert(cache->getHits() >= 2 && "Draw should take the prepared vertices");
+}
+
+#endif // TEST
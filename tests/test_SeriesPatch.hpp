@@ -0,0 +1,206 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../SeriesPatch.hpp"
+#include "../LazyIndicatorSeries.hpp"
+#include "../Fl_ImageChartBox.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+#include <memory>
+#include <cmath>
+
+using namespace std;
+
+inline vector<TimePoint> test_SeriesPatch_points(size_t count, time_sec first = 1000) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++)
+        points.push_back(TimePoint(first + (time_sec)n * 60, (float)(n % 23) + (float)(n % 7) * 0.5f));
+    return points;
+}
+
+inline vector<Candle> test_SeriesPatch_candles(size_t count, time_sec first = 1000) {
+    vector<Candle> candles;
+    for (size_t n = 0; n < count; n++) {
+        const float close = 50.0f + (float)(n % 17) - (float)(n % 5);
+        candles.push_back(Candle(first + (time_sec)n * 60, close - 1, close + 2, close - 2, close, 10.0f + (float)(n % 9)));
+    }
+    return candles;
+}
+
+inline bool test_SeriesPatch_same(const vector<TimePoint>& a, const vector<TimePoint>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t n = 0; n < a.size(); n++)
+        if (a[n].getTime() != b[n].getTime() || fabs(a[n].getValue() - b[n].getValue()) > 1e-4f) return false;
+    return true;
+}
+
+TEST(test_SeriesPatch_apply) {
+    vector<TimePoint> points = test_SeriesPatch_points(10);
+    const vector<TimePoint> original = points;
+
+    SeriesPatch<TimePoint> tail{ 0, 2, { TimePoint(1480, 100.0f), TimePoint(1600, 101.0f), TimePoint(1660, 102.0f) } };
+    assert(tail.apply(points) == 8 && "The first changed sample should be the first replaced one");
+    assert(points.size() == 11 && points[7].getValue() == original[7].getValue() && points[8].getValue() == 100.0f && points.back().getTime() == 1660 && "Tail should be replaced and extended");
+
+    SeriesPatch<TimePoint> head{ 3, 0, {} };
+    assert(head.apply(points) == 8 && "Dropping the head only should change nothing at the tail");
+    assert(points.size() == 8 && points.front().getTime() == original[3].getTime() && "Head should be dropped");
+    assert(SeriesPatch<TimePoint>().empty() && !head.empty() && "Empty patch should be told");
+
+    const vector<SeriesPatch<TimePoint>> invalid = {
+        { 5, 4, {} },
+        { 0, 0, { TimePoint(5000, 1.0f), TimePoint(4000, 1.0f) } },
+        { 0, 0, { TimePoint(1000, 1.0f) } },
+    };
+    for (const SeriesPatch<TimePoint>& patch: invalid) {
+        bool thrown = false;
+        try {
+            patch.apply(points);
+        } catch (exception&) {
+            thrown = true;
+        }
+        assert(thrown && points.size() == 8 && "Invalid patches should be rejected and leave the series alone");
+    }
+}
+
+// An indicator told about a patch of its source should end where a full computation does,
+// a dropped head should keep the outputs already computed for the samples left
+TEST(test_Indicator_follows_patched_source) {
+    vector<TimePoint> points = test_SeriesPatch_points(300);
+    SmaIndicator sma(10);
+    sma.update(points);
+
+    SeriesPatch<TimePoint> tail{ 0, 5, test_SeriesPatch_points(8, points[295].getTime()) };
+    for (TimePoint& point: tail.append) point = TimePoint(point.getTime(), point.getValue() * 2);
+    sma.changedFrom(tail.apply(points));
+    sma.update(points);
+    SmaIndicator fresh(10);
+    fresh.update(points);
+    assert(test_SeriesPatch_same(sma.getOutput(0).getPointsCRef(), fresh.getOutput(0).getPointsCRef()) && "Replaced committed samples should be recomputed");
+
+    const vector<TimePoint> before = sma.getOutput(0).getPointsCRef();
+    const size_t version = sma.getOutput(0).getVersion();
+    SeriesPatch<TimePoint> head{ 100, 0, {} };
+    head.apply(points);
+    sma.dropHead(100, points.front().getTime());
+    sma.update(points);
+    const vector<TimePoint>& after = sma.getOutput(0).getPointsCRef();
+    assert(!after.empty() && after.front().getTime() == points.front().getTime() && "Outputs before the new head should be dropped");
+    assert(test_SeriesPatch_same(vector<TimePoint>(before.end() - after.size(), before.end()), after) && "Outputs of the samples left should be kept");
+    assert(sma.getOutput(0).getVersion() != version && "Dropped outputs should change their version");
+
+    points.push_back(TimePoint(points.back().getTime() + 60, 7.0f));
+    sma.update(points);
+    float sum = 0;
+    for (size_t n = points.size() - 10; n < points.size(); n++) sum += points[n].getValue();
+    assert(fabs(sma.getOutput(0).getPointsCRef().back().getValue() - sum / 10) < 1e-4 && "Appends after a dropped head should continue the state");
+}
+
+// Only the blocks from the changed sample on should be computed again
+TEST(test_LazyIndicatorSeries_invalidateFrom_keeps_older_blocks) {
+    vector<TimePoint> points = test_SeriesPatch_points(1000);
+    LazyIndicatorSeries<TimePoint> series(
+        [&points]() -> const vector<TimePoint>& { return points; },
+        []() { return make_shared<SmaIndicator>(20); },
+        19, 0, 100
+    );
+    vector<TimePoint> out;
+    series.getPoints(points.front().getTime(), points.back().getTime(), out);
+    assert(series.getComputedBlockCount() == 10 && "Every block should be computed once");
+
+    SeriesPatch<TimePoint> tail{ 0, 50, test_SeriesPatch_points(30, points[950].getTime()) };
+    series.invalidateFrom(tail.apply(points));
+    series.getPoints(points.front().getTime(), points.back().getTime(), out);
+    assert(series.getComputedBlockCount() == 11 && "Only the last block should be computed again");
+
+    SmaIndicator full(20);
+    full.update(points);
+    assert(test_SeriesPatch_same(out, full.getOutput(0).getPointsCRef()) && "Patched blocks should match the full computation");
+}
+
+// A patched chart box should draw what a chart box given the patched data draws
+TEST(test_Fl_ChartBox_patch_series_draws_like_fresh) {
+    vector<Candle> candles = test_SeriesPatch_candles(400);
+    const vector<TimePoint> points = test_SeriesPatch_points(400);
+    Fl_ImageChartBox patchedBox(400, 300);
+    patchedBox.addCandleSeries(CandleSeries(candles, SymbolInterval("TEST", 60), 0, 0));
+    patchedBox.addBarSeries(TimePointSeries(points, 0x0000FF), 1);
+    patchedBox.addCandleIndicator(make_shared<SmaIndicator>(10), 0);
+    patchedBox.render();
+
+    vector<Candle> tail = test_SeriesPatch_candles(2, candles[398].getTime()); // same times, same view
+    for (Candle& candle: tail) candle = Candle(candle.getTime(), 70, 75, 60, 72, 1);
+    patchedBox.patchCandleSeries(0, 0, { 0, 2, tail });
+    vector<TimePoint> bars = points;
+    bars.back() = TimePoint(bars.back().getTime(), 100.0f);
+    patchedBox.patchBarSeries(1, 0, { 0, 1, { bars.back() } });
+    patchedBox.render();
+
+    candles.erase(candles.end() - 2, candles.end());
+    candles.insert(candles.end(), tail.begin(), tail.end());
+    Fl_ImageChartBox freshBox(400, 300);
+    freshBox.addCandleSeries(CandleSeries(candles, SymbolInterval("TEST", 60), 0, 0));
+    freshBox.addBarSeries(TimePointSeries(bars, 0x0000FF), 1);
+    freshBox.addCandleIndicator(make_shared<SmaIndicator>(10), 0);
+    freshBox.render();
+    assert(patchedBox.getImage().getPixels() == freshBox.getImage().getPixels() && "Patched chart should draw like a fresh one");
+
+    bool thrown = false;
+    try {
+        patchedBox.patchPointSeries(0, 0, { 0, 1, {} });
+    } catch (exception&) {
+        thrown = true;
+    }
+    assert(thrown && "Patching a missing series should throw");
+}
+
+// A same size patch should invalidate the fit of the patched pane and of the panes following it only
+TEST(test_Fl_ChartBox_patch_series_refits_affected_panes) {
+    MockFl_ChartBox chartBox(0, 0, 400, 300);
+    chartBox.addPointSeries(TimePointSeries(test_SeriesPatch_points(100)), 0);
+    chartBox.addPointIndicator(make_shared<SmaIndicator>(5), 1, 0, 0);
+    chartBox.addBarSeries(TimePointSeries(test_SeriesPatch_points(100)), 2);
+    for (size_t pane = 0; pane < 3; pane++) chartBox.fitPaneCached(pane);
+    for (size_t pane = 0; pane < 3; pane++)
+        assert(!chartBox.fitPaneCached(pane) && "Unchanged panes should take their cached fit");
+
+    const TimePoint last = chartBox.pointsSerieses[0][0].getPointsCRef().back();
+    chartBox.patchPointSeries(0, 0, { 0, 1, { TimePoint(last.getTime(), 500.0f) } });
+    assert(chartBox.fitPaneCached(0) && "The patched pane should be fitted again");
+    assert(chartBox.fitPaneCached(1) && "The pane of its indicator should be fitted again");
+    assert(!chartBox.fitPaneCached(2) && "Other panes should keep their fit");
+    assert(chartBox.chart.getValueUpper() < 500.0f && "Other panes should not see the patched value");
+    chartBox.fitPane(0);
+    assert(chartBox.chart.getValueUpper() >= 500.0f && "The patched value should be fitted");
+}
+
+// Windowed serieses changed behind the chart box (appended, or invalidated after an in place
+// edit of their source) should refit their pane, even when their last time stays the same
+TEST(test_Fl_ChartBox_changed_windowed_series_refits_pane) {
+    MockFl_ChartBox chartBox(0, 0, 400, 300);
+    vector<TimePoint> points = test_SeriesPatch_points(200);
+    shared_ptr<LazyIndicatorSeries<TimePoint>> lazy = make_shared<LazyIndicatorSeries<TimePoint>>(
+        [&points]() -> const vector<TimePoint>& { return points; },
+        []() { return make_shared<SmaIndicator>(1); },
+        0, 0, 50
+    );
+    chartBox.addWindowedSeries(lazy, 0);
+    shared_ptr<CompressedPointSeries> compressed = make_shared<CompressedPointSeries>(test_SeriesPatch_points(100), CHART_COLOR_PLOTTER, 16);
+    chartBox.addWindowedSeries(compressed, 1);
+    for (size_t pane = 0; pane < 2; pane++) chartBox.fitPaneCached(pane);
+    for (size_t pane = 0; pane < 2; pane++)
+        assert(!chartBox.fitPaneCached(pane) && "Unchanged panes should take their cached fit");
+
+    points.back() = TimePoint(points.back().getTime(), 500.0f);
+    lazy->invalidateFrom(points.size() - 1);
+    assert(chartBox.fitPaneCached(0) && "An invalidated series should be fitted again");
+    assert(chartBox.chart.getValueUpper() >= 500.0f && "The edited value should be fitted");
+    assert(!chartBox.fitPaneCached(1) && "Other panes should keep their fit");
+
+    compressed->append(TimePoint(points.back().getTime() + 6000, 1.0f));
+    assert(chartBox.fitPaneCached(1) && "An appended series should be fitted again");
+}
+
+#endif // TEST
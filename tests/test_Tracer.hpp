@@ -0,0 +1,143 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../Tracer.hpp"
+#include "../ChartGroup.hpp"
+#include "MockCanvas.hpp"
+#include "MockFl_ChartBox.hpp"
+#include <vector>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <cstring>
+
+using namespace std;
+
+// Enables the shared tracer for a test, disabled and cleared again at the end
+class test_Tracer_Enabled {
+public:
+    test_Tracer_Enabled() {
+        Tracer::getInstance().clear();
+        Tracer::getInstance().setEnabled(true);
+    }
+    virtual ~test_Tracer_Enabled() {
+        Tracer::getInstance().setEnabled(false);
+        Tracer::getInstance().clear();
+    }
+};
+
+inline size_t test_Tracer_count(const vector<TraceEvent>& events, const char* name) {
+    size_t count = 0;
+    for (const TraceEvent& event: events)
+        if (!strcmp(event.name, name)) count++;
+    return count;
+}
+
+// Nothing should be recorded while the tracer is disabled
+TEST(test_Tracer_disabled_records_nothing) {
+    Tracer tracer;
+    { TraceSpan span("span", "test", tracer); }
+    tracer.addInstant("instant", "test");
+    assert(tracer.getEvents().empty() && "Disabled tracer should record nothing");
+}
+
+// Spans should be recorded with their nesting in time
+TEST(test_Tracer_records_nested_spans) {
+    Tracer tracer;
+    tracer.setEnabled(true);
+    {
+        TraceSpan outer("outer", "test", tracer);
+        { TraceSpan inner("inner", "test", tracer); }
+    }
+    vector<TraceEvent> events = tracer.getEvents();
+    assert(events.size() == 2 && "Both spans should be recorded");
+    assert(!strcmp(events[0].name, "inner") && !strcmp(events[1].name, "outer") && "Spans should be recorded as they end");
+    assert(events[0].phase == 'X' && "Spans should be complete events");
+    assert(events[1].startUs <= events[0].startUs && "Outer span should start first");
+    assert(
+        events[0].startUs + events[0].durationUs <= events[1].startUs + events[1].durationUs &&
+        "Inner span should end within the outer one"
+    );
+}
+
+// Each thread should get its own track
+TEST(test_Tracer_threads_get_own_ids) {
+    Tracer tracer;
+    tracer.setEnabled(true);
+    tracer.addInstant("main", "test");
+    thread worker([&tracer]() { tracer.addInstant("worker", "test"); });
+    worker.join();
+    vector<TraceEvent> events = tracer.getEvents();
+    assert(events.size() == 2 && events[0].thread != events[1].thread && "Threads should differ");
+}
+
+// Recording should stop at the limit and count the rest as dropped
+TEST(test_Tracer_drops_over_limit) {
+    Tracer tracer(3);
+    tracer.setEnabled(true);
+    for (int n = 0; n < 5; n++) tracer.addInstant("instant", "test");
+    assert(tracer.getEvents().size() == 3 && "Events should be limited");
+    assert(tracer.getDroppedCount() == 2 && "Rest should be counted as dropped");
+    tracer.clear();
+    assert(tracer.getEvents().empty() && tracer.getDroppedCount() == 0 && "Clear should reset");
+}
+
+// Output should be Chrome trace JSON with escaped names
+TEST(test_Tracer_writes_chrome_trace) {
+    Tracer tracer;
+    tracer.setEnabled(true);
+    tracer.addSpan("draw \"pane\"", "render", 10, 5.5);
+    tracer.addInstant("tick", "input");
+    stringstream ss;
+    tracer.writeChromeTrace(ss);
+    const string json = ss.str();
+    assert(json.find("{\"traceEvents\":[") == 0 && "Should be a trace events object");
+    assert(json.find("\"name\":\"draw \\\"pane\\\"\"") != string::npos && "Quotes should be escaped");
+    assert(json.find("\"ph\":\"X\",\"ts\":10.000,\"dur\":5.500") != string::npos && "Span should have its duration");
+    assert(json.find("\"ph\":\"i\"") != string::npos && "Instant should be written");
+    assert(json.find("\"cat\":\"input\"") != string::npos && "Category should be written");
+}
+
+// Group zoom should trace the fan-out and the sync callback
+TEST(test_Tracer_traces_chart_group_sync) {
+    test_Tracer_Enabled enabled;
+    MockCanvas canvas;
+    Chart chart1(canvas), chart2(canvas);
+    vector<TimePoint> points = { {100, 1.0f}, {200, 2.0f}, {300, 3.0f} };
+    chart1.fitToPoints(points);
+    chart1.resetView();
+    chart2.fitToPoints(points);
+    chart2.resetView();
+    ChartGroup group;
+    group.addChart(chart1);
+    group.addChart(chart2);
+    group.onSync = []() {};
+
+    group.zoomAt(0.5, 400);
+    group.scrollBy(10);
+    vector<TraceEvent> events = Tracer::getInstance().getEvents();
+    assert(test_Tracer_count(events, "ChartGroup::zoomAt") == 1 && "Zoom should be traced");
+    assert(test_Tracer_count(events, "ChartGroup::scrollBy") == 1 && "Scroll should be traced");
+    assert(test_Tracer_count(events, "ChartGroup::onSync") == 2 && "Sync callbacks should be traced");
+}
+
+// Input handlers and the phases of a fit should be traced without the stats
+TEST(test_Tracer_traces_input_and_phases) {
+    test_Tracer_Enabled enabled;
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    chartBox.addPointSeries(TimePointSeries({ {100, 1.0f}, {200, 2.0f}, {300, 3.0f} }));
+    chartBox.fitPane(0);
+    chartBox.onMouseWheel(400, -1);
+    chartBox.lastDragX = 100;
+    chartBox.onDrag(110, 10);
+
+    vector<TraceEvent> events = Tracer::getInstance().getEvents();
+    assert(test_Tracer_count(events, "Fl_ChartBox::onMouseWheel") == 1 && "Wheel should be traced");
+    assert(test_Tracer_count(events, "Fl_ChartBox::onDrag") == 1 && "Drag should be traced");
+    assert(test_Tracer_count(events, getChartPhaseName(CHART_PHASE_FIT)) == 1 && "Fit phase should be traced");
+    assert(test_Tracer_count(events, getChartPhaseName(CHART_PHASE_FIT_Y)) == 1 && "Fit Y phase should be traced");
+}
+
+#endif // TEST
@@ -0,0 +1,132 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../TradingTimeAxis.hpp"
+#include "../ChartGroup.hpp"
+#include "MockCanvas.hpp"
+#include "TestChart.hpp"
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+const time_sec test_TradingTimeAxis_start = 1000000000;
+const time_sec test_TradingTimeAxis_gapStart = test_TradingTimeAxis_start + 3 * 86400;
+
+// Two sessions of 10 hourly bars with a 3 day gap between them
+inline shared_ptr<TradingTimeAxis> test_TradingTimeAxis_create() {
+    shared_ptr<TradingTimeAxis> axis = make_shared<TradingTimeAxis>(3600);
+    for (int h = 0; h < 10; h++) axis->addTime(test_TradingTimeAxis_start + h * 3600);
+    for (int h = 0; h < 10; h++) axis->addTime(test_TradingTimeAxis_gapStart + h * 3600);
+    return axis;
+}
+
+// Bars should map to their index, gaps should collapse, both ends extrapolate with the interval
+TEST(test_TradingTimeAxis_time_ordinal_mapping) {
+    shared_ptr<TradingTimeAxis> axis = test_TradingTimeAxis_create();
+    const time_sec lastOfFirstSession = test_TradingTimeAxis_start + 9 * 3600;
+
+    assert(axis->timeToOrdinal(test_TradingTimeAxis_start) == 0.0 && "First bar is ordinal 0");
+    assert(axis->timeToOrdinal(test_TradingTimeAxis_start + 1800) == 0.5 && "Time between bars interpolates");
+    assert(axis->timeToOrdinal(test_TradingTimeAxis_gapStart) == 10.0 && "First bar after the gap is ordinal 10");
+    assert(axis->timeToOrdinal(lastOfFirstSession + 86400) == 10.0 && "Time inside the gap collapses to the next bar");
+    assert(axis->timeToOrdinal(test_TradingTimeAxis_start - 7200) == -2.0 && "Before the first bar extrapolates");
+    assert(axis->timeToOrdinal(test_TradingTimeAxis_gapStart + 11 * 3600) == 21.0 && "After the last bar extrapolates");
+
+    for (int n = 0; n < 20; n++)
+        assert(axis->timeToOrdinal(axis->ordinalToTime(n)) == n && "Bar ordinals should round trip");
+    assert(axis->ordinalToTime(9.5) == lastOfFirstSession + 1800 && "Half a bar after the session end");
+}
+
+// addTimes should append only the bars newer than the last one
+TEST(test_TradingTimeAxis_addTimes_appends_newer) {
+    TradingTimeAxis axis(60);
+    vector<TimePoint> points = { {60, 1}, {120, 1}, {180, 1} };
+    axis.addTimes(points);
+    points.push_back(TimePoint(240, 1));
+    axis.addTimes(points);
+    axis.addTime(240); // updated last bar
+
+    assert(axis.size() == 4 && "Each bar should be added once");
+    assert(axis.getTimes().back() == 240 && "Newest bar should be last");
+}
+
+// Older times should be merged in order, known ones ignored
+TEST(test_TradingTimeAxis_addTimes_merges_older) {
+    TradingTimeAxis axis(60);
+    axis.addTimes(vector<TimePoint>{ {120, 1}, {240, 1}, {360, 1} });
+    axis.addTime(180);
+    axis.addTime(240);
+    axis.addTimes(vector<TimePoint>{ {60, 1}, {120, 1}, {300, 1}, {420, 1} }); // another series of the group
+    assert((axis.getTimes() == vector<time_sec>{ 60, 120, 180, 240, 300, 360, 420 }) && "Older times should be merged, not dropped");
+
+    axis.addTimes(vector<TimePoint>{ {120, 1}, {300, 1}, {420, 1} });
+    assert(axis.size() == 7 && "Known times should not be added again");
+    assert(axis.timeToOrdinal(300) == 4 && "Merged times should be projected by their order");
+}
+
+// Neighbour bars should be equally spaced on the screen across the gap
+TEST(test_Chart_timeAxis_removes_gaps) {
+    MockCanvas canvas(800, 600);
+    TestChart chart(canvas);
+    shared_ptr<TradingTimeAxis> axis = test_TradingTimeAxis_create();
+    chart.setTimeAxis(axis);
+    chart.fitToPoints({
+        { test_TradingTimeAxis_start, 1.0f },
+        { test_TradingTimeAxis_gapStart + 9 * 3600, 2.0f }
+    });
+    chart.resetView();
+
+    const int step = chart.timeToX(axis->ordinalToTime(1)) - chart.timeToX(axis->ordinalToTime(0));
+    const int across = chart.timeToX(axis->ordinalToTime(10)) - chart.timeToX(axis->ordinalToTime(9));
+    assert(step > 0 && "Bars should advance to the right");
+    assert(abs(across - step) <= 1 && "The gap should take no space");
+    assert(abs(chart.getCandleBodyWidth(3600) - chart.innerWidth() / 19.0) < 1e-9 && "Every bar gets the same width");
+}
+
+// zoomAt and scrollBy should keep the view in time while moving in bars
+TEST(test_Chart_timeAxis_zoom_and_scroll_in_bars) {
+    MockCanvas canvas(800, 600);
+    TestChart chart(canvas);
+    shared_ptr<TradingTimeAxis> axis = test_TradingTimeAxis_create();
+    chart.setTimeAxis(axis);
+    chart.fitToPoints({
+        { test_TradingTimeAxis_start, 1.0f },
+        { test_TradingTimeAxis_gapStart + 9 * 3600, 2.0f }
+    });
+    chart.resetView();
+
+    // Zoom in at the left edge: 19 bars / 1.9 = 10 bars from the first one
+    chart.zoomAt(1.9, chart.spacingLeft);
+    assert(chart.viewFirst == test_TradingTimeAxis_start && "Should stick to the left edge");
+    assert(chart.viewLast == test_TradingTimeAxis_gapStart && "Ten bars to the right, across the gap");
+
+    // Scroll one bar to the right (content moves left)
+    chart.scrollBy(-chart.innerWidth() / 10.0);
+    assert(chart.viewFirst == test_TradingTimeAxis_start + 3600 && "View should start one bar later");
+    assert(chart.viewLast == test_TradingTimeAxis_gapStart + 3600 && "View should end one bar later");
+
+    assert(chart.pixelToTime(chart.spacingLeft) == test_TradingTimeAxis_start && "Left edge is the first bar of the data");
+}
+
+// ChartGroup should share its axis with the charts, also with the ones added later
+TEST(test_ChartGroup_setTimeAxis_shares_axis) {
+    MockCanvas canvas1(800, 600);
+    MockCanvas canvas2(800, 600);
+    TestChart chart1(canvas1);
+    TestChart chart2(canvas2);
+    shared_ptr<TradingTimeAxis> axis = test_TradingTimeAxis_create();
+
+    ChartGroup group;
+    group.addChart(chart1);
+    group.setTimeAxis(axis);
+    group.addChart(chart2);
+    assert(chart1.getTimeAxis() == axis && chart2.getTimeAxis() == axis && "Both charts should use the group axis");
+
+    group.setTimeAxis(nullptr);
+    assert(!chart1.getTimeAxis() && !chart2.getTimeAxis() && "Removing the axis should restore wall-clock time");
+}
+
+#endif // TEST
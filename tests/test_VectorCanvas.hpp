@@ -0,0 +1,123 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../VectorCanvas.hpp"
+#include "../Chart.hpp"
+#include <vector>
+#include <string>
+#include <sstream>
+
+using namespace std;
+
+inline vector<TimePoint> test_VectorCanvas_points(size_t count) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++)
+        points.push_back(TimePoint(1000 + (time_sec)n * 10, (float)(n % 31) + (float)(n % 7)));
+    return points;
+}
+
+inline vector<Candle> test_VectorCanvas_candles(size_t count) {
+    vector<Candle> candles;
+    for (size_t n = 0; n < count; n++) {
+        float open = (float)(n % 13) + 10.0f;
+        float close = (float)(n % 7) + 10.0f;
+        candles.push_back(Candle(1000 + (time_sec)n * 60, open, max(open, close) + 1.0f, min(open, close) - 1.0f, close, 0.0f));
+    }
+    return candles;
+}
+
+inline size_t test_VectorCanvas_count(const string& text, const string& what) {
+    size_t count = 0;
+    for (size_t at = text.find(what); at != string::npos; at = text.find(what, at + 1)) count++;
+    return count;
+}
+
+inline string test_VectorCanvas_svgOfPoints(size_t count) {
+    VectorCanvas canvas(800, 400);
+    Chart chart(canvas);
+    vector<TimePoint> points = test_VectorCanvas_points(count);
+    chart.fitToPoints(points);
+    chart.resetView();
+    chart.fitToVisiblePoints(points);
+    chart.showPoints(points);
+    ostringstream svg;
+    canvas.writeSvg(svg);
+    return svg.str();
+}
+
+// Collinear points and wiggles under the tolerance should go, the ends and the real turns should stay
+TEST(test_VectorCanvas_simplifyPolyline) {
+    vector<VectorPoint> line;
+    for (int x = 0; x <= 100; x++) line.push_back({ x, 50 });
+    simplifyPolyline(line, 0.5);
+    assert(line.size() == 2 && line.front().x == 0 && line.back().x == 100 && "Straight line should keep its ends only");
+
+    vector<VectorPoint> peak = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 3, 10 }, { 4, 0 }, { 5, 0 }, { 6, 0 } };
+    simplifyPolyline(peak, 0.5);
+    assert(peak.size() == 5 && peak[2].x == 3 && peak[2].y == 10 && "Peak and its feet should be kept");
+
+    vector<VectorPoint> column;
+    for (int n = 0; n < 1000; n++) column.push_back({ 7, n % 50 });
+    simplifyPolyline(column, 0.5);
+    assert(column.size() <= 4 && "A pixel column should keep at most 4 points");
+}
+
+// The size of the output should be bound by the resolution, not by the number of points
+TEST(test_VectorCanvas_output_bound_by_resolution) {
+    const string small = test_VectorCanvas_svgOfPoints(10000);
+    const string large = test_VectorCanvas_svgOfPoints(1000000);
+    assert(large.size() < 200000 && "Dense series should not make a huge SVG");
+    assert(large.size() < small.size() * 3 && "100 times the points should not grow the SVG with them");
+    assert(test_VectorCanvas_count(large, "<path") == 1 && "One series should be one path");
+}
+
+// Candles of one color should be merged into one compound path per primitive kind
+TEST(test_VectorCanvas_merges_same_color_candles) {
+    VectorCanvas canvas(800, 400);
+    Chart chart(canvas);
+    vector<Candle> candles = test_VectorCanvas_candles(60);
+    chart.fitToCandles(candles);
+    chart.resetView();
+    chart.fitToVisibleCandles(candles);
+    chart.showCandles(candles, 60);
+    ostringstream svg;
+    canvas.writeSvg(svg);
+    assert(canvas.getSegmentCount() > 0 && "Candles should be drawn");
+    assert(test_VectorCanvas_count(svg.str(), "<path") <= 4 && "Wicks and bodies should be one path per color");
+    assert(canvas.getPathCount() <= 4 && "Groups should be per color and kind");
+}
+
+// The PDF should be a well formed single page with a valid cross-reference offset
+TEST(test_VectorCanvas_pdf) {
+    VectorCanvas canvas(200, 100, 0x000000);
+    canvas.line(0, 0, 199, 99, 0xFF0000);
+    canvas.rectf(10, 10, 20, 20, 0x00FF00);
+    canvas.circlef(50, 50, 5, 0x0000FF);
+    canvas.text(5, 5, "Price (USD)", 0xFFFFFF);
+    ostringstream out;
+    canvas.writePdf(out);
+    const string pdf = out.str();
+    assert(pdf.compare(0, 8, "%PDF-1.4") == 0 && "PDF header expected");
+    assert(pdf.find("%%EOF") != string::npos && "PDF trailer expected");
+    const size_t startxref = pdf.rfind("startxref\n");
+    const size_t xref = stoul(pdf.substr(startxref + 10));
+    assert(pdf.compare(xref, 4, "xref") == 0 && "startxref should point to the cross-reference table");
+    assert(pdf.find("(Price \\(USD\\)) Tj") != string::npos && "Text should be escaped");
+    assert(pdf.find("10 70 20 20 re") != string::npos && "Rect should be flipped to the PDF origin");
+}
+
+// Only .svg and .pdf should be accepted
+TEST(test_VectorCanvas_save_checks_extension) {
+    VectorCanvas canvas(10, 10);
+    bool thrown = false;
+    try {
+        canvas.save("/tmp/test_VectorCanvas.png");
+    } catch (exception&) {
+        thrown = true;
+    }
+    assert(thrown && "Unknown extension should throw");
+}
+
+#endif // TEST
@@ -0,0 +1,89 @@
+#pragma once
+
+#ifdef TEST
+
+#include "../../misc/TEST.hpp"
+#include "../Chart.hpp"
+#include "MockCanvas.hpp"
+#include "MockFl_ChartBox.hpp"
+#include "AllocationCounter.hpp"
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+inline vector<TimePoint> test_ZeroAllocationDraw_points(size_t count) {
+    vector<TimePoint> points;
+    for (size_t n = 0; n < count; n++)
+        points.push_back(TimePoint(1000 + (time_sec)n * 60, (float)(n % 23) + 5.0f));
+    return points;
+}
+
+inline vector<Candle> test_ZeroAllocationDraw_candles(size_t count) {
+    vector<Candle> candles;
+    for (size_t n = 0; n < count; n++) {
+        float open = (float)(n % 13) + 10.0f;
+        float close = (float)(n % 7) + 10.0f;
+        candles.push_back(Candle(1000 + (time_sec)n * 60, open, max(open, close) + 1.0f, min(open, close) - 1.0f, close, 0.0f));
+    }
+    return candles;
+}
+
+// Fitting and drawing the visible part of a chart should not allocate
+TEST(test_ZeroAllocationDraw_chart_fit_and_show) {
+    MockCanvas canvas;
+    Chart chart(canvas);
+    vector<Candle> candles = test_ZeroAllocationDraw_candles(10000);
+    vector<TimePoint> points = test_ZeroAllocationDraw_points(10000);
+    chart.fitToCandles(candles);
+    chart.resetView();
+    chart.setViewFirst(candles[2000].getTime());
+    chart.setViewLast(candles[3000].getTime());
+
+    AllocationCounter allocations;
+    size_t from, to;
+    chart.fitToVisibleCandles(candles);
+    chart.fitToVisiblePoints(points);
+    chart.getVisibleRange(candles, from, to);
+    chart.showCandlesRange(candles, from, to, 60);
+    chart.getVisibleRange(points, from, to);
+    chart.showPointsRange(points, from, to);
+    chart.showBarsRange(points, from, to);
+    assert(to - from == 1001 && "Visible range should cover the view");
+    assert(allocations.getCount() == 0 && "Fit and show should not allocate");
+}
+
+// Steady state refit of a chart box with unchanged series sizes should not allocate
+TEST(test_ZeroAllocationDraw_fitPane_steady_state) {
+    MockFl_ChartBox chartBox(10, 10, 800, 600);
+    vector<Candle> candles = test_ZeroAllocationDraw_candles(10000);
+    chartBox.addCandleSeries(CandleSeries(candles, SymbolInterval("BTCUSDT", 60), candles.front().getTime(), candles.back().getTime()));
+    chartBox.addBarSeries(TimePointSeries(test_ZeroAllocationDraw_points(10000)), 1);
+    chartBox.addPointSeries(TimePointSeries(test_ZeroAllocationDraw_points(10000)));
+    chartBox.addCandleIndicator(make_shared<SmaIndicator>(20));
+    chartBox.fitPane(0);
+    chartBox.fitPane(1);
+    chartBox.chart.setViewFirst(candles[2000].getTime());
+    chartBox.chart.setViewLast(candles[3000].getTime());
+    chartBox.fitPane(0); // scratch buffers grow to the view
+    chartBox.fitPane(1);
+
+    AllocationCounter allocations;
+    chartBox.fitPane(0);
+    chartBox.fitPane(1);
+    chartBox.fitPane(2); // missing pane
+    assert(allocations.getCount() == 0 && "Steady state fit should not allocate");
+
+    // Stats keep their buffers between frames too
+    chartBox.setStatsEnabled(true);
+    chartBox.beginFrameStats(false);
+    chartBox.fitPane(0);
+    chartBox.endFrameStats();
+    allocations.reset();
+    chartBox.beginFrameStats(false);
+    chartBox.fitPane(0);
+    chartBox.endFrameStats();
+    assert(allocations.getCount() == 0 && "Steady state fit with stats should not allocate");
+}
+
+#endif // TEST
@@ -8,6 +8,41 @@
 #include "test_ChartGroup.hpp"
 #include "test_TimePointSeries.hpp"
 #include "test_Fl_ChartBox.hpp"
+#include "test_CandleAggregator.hpp"
+#include "test_AsyncSeriesLoad.hpp"
+#include "test_CsvImporter.hpp"
+#include "test_CompressedPointSeries.hpp"
+#include "test_PagedPointSeries.hpp"
+#include "test_TradingTimeAxis.hpp"
+#include "test_Indicators.hpp"
+#include "test_LazyIndicatorSeries.hpp"
+#include "test_ChartStats.hpp"
+#include "test_RecordingCanvas.hpp"
+#include "test_ZeroAllocationDraw.hpp"
+#include "test_Tracer.hpp"
+#include "test_ChartVirtualizer.hpp"
+#include "test_RenderPool.hpp"
+#include "test_Fl_AsyncChartBox.hpp"
+#include "test_ChartBatchRenderer.hpp"
+#include "test_VectorCanvas.hpp"
+#include "test_PointView.hpp"
+#include "test_DecimationCache.hpp"
+#include "test_InteractionRecorder.hpp"
+#include "test_SeriesPatch.hpp"
+
+#include <new>
+#include <cstdlib>
+
+// Count every allocation (see AllocationCounter)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // malloc/free pairs, the replacement is global
+void* operator new(size_t size) {
+    testAllocations++;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) throw bad_alloc();
+    return ptr;
+}
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
 #endif // TEST
 
 int main(int argc, char** argv) {